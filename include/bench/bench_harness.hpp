@@ -0,0 +1,89 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                          bench_harness.hpp                                */
+/*                                                                           */
+/*  Minimal microbenchmark harness for tm_bench (JSON output)                */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct Case
+{
+    std::string name;
+    uint64_t    ops_per_iter   = 1;     // e.g. packets per iteration
+    uint64_t    bytes_per_iter = 0;     // payload bytes per iteration
+
+    // One timed iteration
+    std::function<void()> run;
+
+    // Optional per-iteration setup excluded from timing
+    std::function<void()> setup;
+
+    // Redirect stderr to /dev/null while running (chatty code under test)
+    bool quiet_stderr = false;
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t iterations = 0;
+    uint64_t ops = 0;
+    double   total_ns = 0;
+    double   ns_per_op = 0;
+    double   ops_per_sec = 0;
+    double   bytes_per_sec = 0;
+    double   iter_p50_ns = 0;
+    double   iter_p99_ns = 0;
+    double   iter_min_ns = 0;
+
+    std::vector<std::pair<std::string, double>> extra;
+};
+
+struct Options
+{
+    double      min_time_s = 0.5;
+    uint64_t    max_iters  = 1000000;
+    std::string filter;                 // substring match on case name
+    std::string json_path;              // empty => stdout
+};
+
+class Runner
+{
+public:
+    explicit Runner(Options opt) : opt_(std::move(opt)) {}
+
+    void add(Case c) { cases_.push_back(std::move(c)); }
+
+    /* Custom measured case (e.g. multi-threaded): caller fills the Result */
+    void addCustom(const std::string& name, std::function<Result()> fn);
+
+    int runAll();
+
+private:
+    Result runCase(const Case& c);
+    void   writeJson(const std::vector<Result>& results);
+
+    Options opt_;
+    std::vector<Case> cases_;
+    std::vector<std::pair<std::string, std::function<Result()>>> custom_;
+};
+
+/* Defeat dead-code elimination of benchmark results */
+template <typename T>
+inline void doNotOptimize(const T& v)
+{
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+uint64_t nowNs();
+
+} // namespace bench
@@ -0,0 +1,129 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Buffer Pool                               */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Frame buffers are max_frame_size each (17 MB for 4K RAW); allocating and faulting  */
+/*  one in per frame is expensive, and consumers on other threads need the buffer to   */
+/*  outlive the reassembler entry.                                                     */
+/*                                                                                     */
+/*  FrameHandle is an intrusive ref-counted pointer to a FrameBuffer.  The reassembler */
+/*  holds one reference, FrameResult carries another; copying the handle keeps the     */
+/*  frame alive (zero-copy hand-off), and the last release returns the buffer to its   */
+/*  pool.  The pool's free list outlives the pool object while buffers are out, so a   */
+/*  consumer may release after the receive pipeline is gone.                           */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+struct FrameBuffer;
+
+// Free list shared by a pool and its outstanding buffers
+struct FramePoolCore
+{
+    std::mutex                mtx;
+    std::vector<FrameBuffer*> free;
+    size_t                    allocated = 0;
+    size_t                    buffer_size = 0;
+    size_t                    max_buffers = 0;  // 0 => unbounded
+    bool                      closed = false;   // pool destroyed: free on release
+};
+
+struct FrameBuffer
+{
+    std::atomic<uint32_t>          refs{0};
+    size_t                         capacity = 0;
+    std::unique_ptr<uint8_t[]>     data;
+    std::shared_ptr<FramePoolCore> home;        // nullptr => standalone
+};
+
+class FrameHandle
+{
+public:
+    FrameHandle() = default;
+    explicit FrameHandle(FrameBuffer* b) : buf_(b) { retain(); }
+
+    FrameHandle(const FrameHandle& o) : buf_(o.buf_) { retain(); }
+    FrameHandle(FrameHandle&& o) noexcept : buf_(o.buf_) { o.buf_ = nullptr; }
+
+    FrameHandle& operator=(const FrameHandle& o)
+    {
+        if (buf_ != o.buf_)
+        {
+            FrameHandle tmp(o);
+            std::swap(buf_, tmp.buf_);
+        }
+        return *this;
+    }
+
+    FrameHandle& operator=(FrameHandle&& o) noexcept
+    {
+        if (this != &o)
+        {
+            reset();
+            buf_ = o.buf_;
+            o.buf_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~FrameHandle() { reset(); }
+
+    // Unpooled buffer, freed on the last release
+    static FrameHandle allocate(size_t capacity);
+
+    void reset();
+
+    uint8_t* data() const       { return buf_ ? buf_->data.get() : nullptr; }
+    size_t   capacity() const   { return buf_ ? buf_->capacity : 0; }
+    uint32_t useCount() const   { return buf_ ? buf_->refs.load(std::memory_order_relaxed) : 0; }
+
+    explicit operator bool() const { return buf_ != nullptr; }
+
+private:
+    void retain()
+    {
+        if (buf_)
+            buf_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FrameBuffer* buf_ = nullptr;
+};
+
+class FrameBufferPool
+{
+public:
+    /*
+     * buffer_size bytes per buffer, at most max_buffers alive (in use or
+     * free; 0 => unbounded), prealloc allocated (and faulted in) up front.
+     */
+    FrameBufferPool(size_t buffer_size, size_t max_buffers, size_t prealloc = 0);
+    ~FrameBufferPool();
+
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    // Empty handle when max_buffers are all in use
+    FrameHandle acquire();
+
+    /*
+     * New buffer size / limit.  Free buffers that no longer fit are freed
+     * now; buffers in use keep their size and are freed (not pooled) on
+     * their last release, so in-flight frames are never touched.
+     */
+    void resize(size_t buffer_size, size_t max_buffers);
+
+    size_t bufferSize() const;
+    size_t allocated() const;
+    size_t available() const;
+
+private:
+    std::shared_ptr<FramePoolCore> core_;
+};
@@ -0,0 +1,49 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Chunk Codecs                              */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Block codecs for recorded frames, one call per chunk:                              */
+/*                                                                                     */
+/*    LZ4   built in (LZ4 block format, greedy single-probe hash), fast both ways,     */
+/*          files decode with any LZ4 block decoder                                    */
+/*    ZSTD  libzstd, better ratio, only with HV_WITH_ZSTD (HV_HAVE_ZSTD)               */
+/*                                                                                     */
+/*  compress() returns 0 when the output would not be smaller than the input: the      */
+/*  caller stores that chunk as is (noisy RAW data often does not compress).           */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class FrameCodec : uint8_t {
+    NONE = 0,
+    LZ4  = 1,
+    ZSTD = 2
+};
+
+bool        parseFrameCodec(const char* s, FrameCodec& out);
+const char* frameCodecName(FrameCodec c);
+bool        frameCodecAvailable(FrameCodec c);
+
+// Largest compressed size of n input bytes
+size_t frameCodecBound(FrameCodec c, size_t n);
+
+/*
+ * src[0..n) => dst (cap bytes).  Returns the compressed size, or 0 if it
+ * does not fit / does not pay off.  level: ZSTD only (0 => default).
+ * Thread-safe: no shared state.
+ */
+size_t frameCodecCompress(FrameCodec c, int level,
+                          const uint8_t* src, size_t n,
+                          uint8_t* dst, size_t cap);
+
+// Exactly out_n bytes expected; false on malformed input
+bool frameCodecDecompress(FrameCodec c,
+                          const uint8_t* src, size_t n,
+                          uint8_t* dst, size_t out_n);
+
+// LZ4 block format
+size_t lz4CompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t cap);
+bool   lz4DecompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t cap, size_t* out_n);
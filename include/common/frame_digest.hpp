@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                          frame_digest.hpp                                 */
+/*                                                                           */
+/*  Fast non-cryptographic frame digest (xxh3-style stripe hash)             */
+/*                                                                           */
+/*  The digest covers FrameHeader + payload and is defined over fixed        */
+/*  protocol::DIGEST_CHUNK_SIZE chunks, each hashed with its chunk index     */
+/*  as seed and summed.  Chunks are independent, so the receiver can hash    */
+/*  them in any order while packets are still landing.                       */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "common/frame_result.hpp"
+
+// 64-bit stripe hash of one buffer (vectorisable 8-lane accumulator)
+uint64_t frame_digest_hash64(const uint8_t* data, size_t len, uint64_t seed);
+
+// Digest of a whole contiguous frame region (sender side / reference)
+uint64_t frame_digest_compute(const uint8_t* data, size_t len);
+
+
+//----------------------------------------------
+// Incremental receiver-side digest
+//----------------------------------------------
+class FrameDigestTracker
+{
+public:
+    // Frame start: capacity is the maximum number of frame bytes expected
+    void reset(size_t capacity);
+
+    // Packet bytes [offset, offset+len) have just been written into frame
+    void onBytes(const uint8_t* frame, size_t offset, size_t len);
+
+    // Hash remaining chunks and compare against the trailer
+    FrameDigestState finalize(const uint8_t* frame,
+                              size_t frame_size,
+                              bool frame_complete);
+
+    // Bytes written now may be hashed out of the frame later: the header is
+    // not parsed yet, or the frame carries a digest
+    bool readsBack() const { return !header_seen_ || has_digest_; }
+
+    FrameDigestState state() const { return state_; }
+    uint64_t digest() const { return digest_; }
+
+private:
+    void parseHeader(const uint8_t* frame);
+    void hashChunk(const uint8_t* frame, size_t chunk);
+    void sweepPending(const uint8_t* frame);
+
+    std::vector<uint32_t> chunk_fill_;      // Bytes received per chunk
+    std::vector<bool>     chunk_hashed_;
+
+    size_t   covered_len_  = 0;             // Header + payload (0 = unknown)
+    bool     header_seen_  = false;
+    bool     has_digest_   = false;
+    uint64_t sum_          = 0;
+
+    FrameDigestState state_  = FrameDigestState::ABSENT;
+    uint64_t         digest_ = 0;
+};
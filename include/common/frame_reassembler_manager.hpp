@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <cstdint>
 #include <chrono>
@@ -16,13 +17,16 @@
 
 #include "common/frame_result.hpp"
 #include "common/frame_reassembler_v2.hpp"
+#include "common/timeout_estimator.hpp"
 #include "protocol/udp_packet.hpp"
 
 class FrameReassemblerManager
 {
 public:
+    // max_buffers: frame buffers alive at once (in flight + held by consumers)
     FrameReassemblerManager(size_t max_frame_size,
-                            size_t payload_stride);
+                            size_t payload_stride,
+                            size_t max_buffers = DEFAULT_FRAME_BUFFERS);
 
     bool empty() const;
 
@@ -30,6 +34,13 @@ public:
     void pushPacket(const RxPacket& pkt,
                     size_t queue_drop_count);
 
+    // Same, from a header + payload pointer (zero-copy ingress paths)
+    void pushPacket(const UdpPacketHeader& hdr,
+                    const uint8_t* payload,
+                    bool gap_before,
+                    size_t queue_drop_count,
+                    uint32_t kernel_drops = 0);
+
     // (Implementation in the next phase)
     void pollFlush();
 
@@ -41,13 +52,50 @@ public:
 
     std::function<void(const FrameResult&)> onFrameDone;
 
+    // Streaming delivery: rows of the contiguous prefix, band_rows at a
+    // time, while the frame is still arriving (0 => whole frames only)
+    void setBandRows(uint32_t rows) { band_rows_ = rows; }
+    std::function<void(const FrameBand&)> onFrameBand;
+
+    // Per stream (StreamDemux): tag for FrameResult and timeout overrides
+    void setStreamId(uint32_t id) { stream_id_ = id; }
+    // 0 => default deadline (adaptive, or 30 ms / 8 s), not fixed
+    void setTimeouts(std::chrono::milliseconds idle,
+                     std::chrono::milliseconds lifetime);
+
+    /*
+     * Live change (owning thread, between packets): frames started from
+     * now on use the new size / stride, the pool is resized.  Frames in
+     * flight keep their reassembler and buffer until emitted.
+     */
+    void reconfigure(size_t max_frame_size,
+                     size_t payload_stride,
+                     size_t max_buffers);
+
+    size_t maxFrameSize() const { return max_frame_size_; }
+
+    // Adaptive idle / lifetime from observed arrivals; an explicit
+    // setTimeouts() value keeps that deadline fixed
+    void setTimeoutConfig(const TimeoutConfig& cfg) { estimator_.configure(cfg); }
+
+    // Deadlines in effect (fixed until the estimator has warmed up)
+    std::chrono::nanoseconds idleDeadline() const;
+    std::chrono::nanoseconds lifetimeDeadline() const;
+    const TimeoutEstimator& estimator() const { return estimator_; }
+
+    // Owned by the frame worker thread (exported through hv::stats)
     struct
     {
-        std::atomic<uint64_t> total{0};
-        std::atomic<uint64_t> complete{0};
-        std::atomic<uint64_t> partial{0};
+        uint64_t total = 0;
+        uint64_t complete = 0;
+        uint64_t partial = 0;
     } stats_;
 
+    size_t inFlight() const { return frames_.size(); }
+    size_t buffersAllocated() const { return pool_.allocated(); }
+
+    static constexpr size_t DEFAULT_FRAME_BUFFERS = 32;
+
 
 private:
     struct FrameEntry
@@ -57,21 +105,71 @@ private:
         std::chrono::steady_clock::time_point last_update;
 
         FrameEntry(size_t max_frame_size,
-               size_t payload_stride)
-        : reassembler(max_frame_size, payload_stride),
+               size_t payload_stride,
+               FrameBufferPool* pool)
+        : reassembler(max_frame_size, payload_stride, pool),
           first_packet_time(std::chrono::steady_clock::now()),
           last_update(std::chrono::steady_clock::now())
         {}
 
         // Queue drop count at frame start
         size_t queue_drop_at_start = 0;
+
+        // Socket drops seen right before packets of this frame
+        uint32_t kernel_drops = 0;
+
+        // Streaming delivery, from the FrameHeader in packet 0
+        size_t   row_bytes = 0;         // 0 => header not seen yet
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint8_t  bitdepth = 0;
+        uint16_t rows_published = 0;
+        bool     bands_off = false;     // no usable FrameHeader
+    };
+
+    // Frames emitted recently: stragglers (duplicates, retransmits, the tail of
+    // a frame cut by a deadline) must not open a new frame with the same id
+    struct Emitted
+    {
+        uint32_t frame_id = 0;
+        std::chrono::steady_clock::time_point at{};     // emit or latest straggler
+        std::chrono::steady_clock::time_point first{};  // first packet
+        std::chrono::steady_clock::time_point last{};   // last packet taken or seen
+        bool cut = false;                               // emitted incomplete
     };
 
     size_t max_frame_size_;
     size_t payload_stride_;
 
+    // Reused across frames; FrameResult::buffer keeps one alive for consumers
+    FrameBufferPool pool_;
+
     std::map<uint32_t, FrameEntry> frames_;
 
+    uint32_t stream_id_ = 0;
+    std::chrono::milliseconds idle_timeout_;
+    std::chrono::milliseconds lifetime_;
+    bool idle_fixed_ = false;           // set by setTimeouts()
+    bool lifetime_fixed_ = false;
+
+    TimeoutEstimator estimator_;
+    bool adaptive_logged_ = false;
+
+    uint32_t band_rows_ = 0;
+
+    static constexpr size_t RECENT_EMITTED = 16;
+    std::array<Emitted, RECENT_EMITTED> recent_{};
+    size_t recent_next_ = 0;
+
+    // nullptr unless frame_id was emitted within the idle window
+    Emitted* recentlyEmitted(uint32_t frame_id,
+                             std::chrono::steady_clock::time_point now);
+
+    void publishBands(FrameEntry& entry);
+
+    // Complete frame: feed its span to the timeout estimator
+    void onFrameSpan(const FrameEntry& entry);
+
     void emitFrame(FrameEntry& entry,
                    FrameState final_state,
                    size_t queue_drop_now);
@@ -79,4 +177,7 @@ private:
     static constexpr std::chrono::milliseconds FRAME_TIMEOUT        {3000};
     static constexpr std::chrono::milliseconds MAX_FRAME_LIFETIME   {8000};
     static constexpr std::chrono::milliseconds FRAME_IDLE_TIMEOUT   {30};
+
+    // EV_PACKET_MISSING events recorded per partial frame
+    static constexpr uint32_t MAX_TRACE_MISSING = 256;
 };
@@ -6,18 +6,25 @@
 #include <span>
 #include "protocol/udp_packet.hpp"
 #include "common/frame_result.hpp"
+#include "common/frame_digest.hpp"
+#include "common/frame_buffer_pool.hpp"
 
 struct UdpPacketHeader;
 
 class FrameReassemblerV2
 {
 public:
+    // pool nullptr => one buffer of our own, allocated here
     FrameReassemblerV2(size_t max_frame_size,
-                       size_t payload_stride);
+                       size_t payload_stride,
+                       FrameBufferPool* pool = nullptr);
 
     // Frame start (Call when frame_id changes)
-    void startNewFrame(uint32_t frame_id,
-                       uint16_t packet_count);
+    // stride 0 => the configured payload_stride (v1 packets)
+    // false => no frame buffer available (pool exhausted)
+    bool startNewFrame(uint32_t frame_id,
+                       uint32_t packet_count,
+                       uint32_t stride = 0);
 
     // Packet reception
     void pushPacket(const UdpPacketHeader& hdr,
@@ -32,9 +39,13 @@ public:
     void reset();
 
     // Statistics
-    uint16_t expectedPackets() const { return expected_packet_count_; }
-    uint16_t receivedPackets() const { return received_packets_count_; }
+    uint32_t expectedPackets() const { return expected_packet_count_; }
+    uint32_t receivedPackets() const { return received_packets_count_; }
     uint32_t frameId() const { return current_frame_id_; }
+    uint32_t stride() const { return frame_stride_; }
+
+    // Bytes from offset 0 with no missing packet in between
+    size_t contiguousBytes() const;
 
     // Additional status
     bool hasAnyPacket() const;
@@ -42,14 +53,23 @@ public:
     bool hasGap() const;              // The presence of dropped packets
     bool hasCorruption() const;       // CRC error inclusion status
     
-    bool hasPacket(uint16_t packet_id) const;
+    bool hasPacket(uint32_t packet_id) const;
 
     // Results-based approach
     const uint8_t* getFrameData() const;
     size_t getFrameSize() const;
+    const FrameHandle& buffer() const { return frame_buffer_; }
+
+    // Clears the ranges of missing packets (reused buffers hold older frames)
+    void zeroMissing();
 
     FrameResult makeResult(FrameState final_state) const;
 
+    // End-to-end digest (hash remaining chunks, compare with trailer)
+    FrameDigestState finalizeDigest();
+    FrameDigestState digestState() const { return digest_.state(); }
+    uint64_t digest() const { return digest_.digest(); }
+
 private:
     // Fixed frame buffer
     size_t frame_size_ = 0;         // Actual recorded frame size
@@ -58,13 +78,19 @@ private:
 
     // Frame meta
     uint32_t current_frame_id_ = 0;
-    uint16_t expected_packet_count_ = 0;
-    uint16_t received_packets_count_ = 0;
+    uint32_t expected_packet_count_ = 0;
+    uint32_t received_packets_count_ = 0;
+    uint32_t frame_stride_ = 0;     // payload_stride_ or the v2 header's stride
+    uint32_t contiguous_packets_ = 0;   // packets [0, n) all received
 
     // Packet reception status
-    std::vector<uint8_t> frame_buffer_;
+    FrameBufferPool* pool_;
+    FrameHandle frame_buffer_;
     std::vector<bool> packet_received_;
     std::vector<bool> packet_corrupted_;
 
     bool corrupted_detected_ = false;
+
+    // Incremental digest over chunks as packets land
+    FrameDigestTracker digest_;
 };
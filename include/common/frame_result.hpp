@@ -14,6 +14,8 @@
 #include <atomic>
 //#include "frame_state.hpp"
 
+#include "common/frame_buffer_pool.hpp"
+
 //----------------------------------------------
 // Frame State Enum
 //----------------------------------------------
@@ -26,12 +28,25 @@ enum class FrameState
 };
 
 
+//----------------------------------------------
+// Frame Digest Verification State
+//----------------------------------------------
+enum class FrameDigestState : uint8_t
+{
+    ABSENT,      // sender did not attach a digest
+    UNVERIFIED,  // digest present but frame incomplete
+    VERIFIED,    // digest matches reassembled data
+    MISMATCH     // digest differs => data corrupted in transit
+};
+
+
 //----------------------------------------------
 // Frame Result Structure
 //----------------------------------------------
 struct FrameResult
 {
     uint32_t frame_id;
+    uint32_t stream_id;    // StreamDemux key index (0 => single stream)
 
     FrameState state;
 
@@ -39,12 +54,44 @@ struct FrameResult
     bool corrupted;     // gap or CRC error  
 
     bool queue_pressure;   // queue overflow  
+    uint32_t kernel_drops; // socket drops (SO_RXQ_OVFL) charged to this frame
 
-    uint16_t expected_packets;
-    uint16_t received_packets;
+    uint32_t expected_packets;
+    uint32_t received_packets;
 
     size_t   frame_size;
     const uint8_t* frame_data;
+
+    // Owns frame_data: copy the handle to keep the frame past onFrameDone
+    FrameHandle buffer;
+
+    FrameDigestState digest_state;
+    uint64_t         digest;       // receiver-side digest (0 if not computed)
+};
+
+
+//----------------------------------------------
+// Frame Row Band (streaming delivery)
+//----------------------------------------------
+// Rows [row_begin, row_end) of a frame still being received: every packet
+// covering them has arrived.  data points at row_begin inside the frame
+// buffer and is only valid during the callback.
+struct FrameBand
+{
+    uint32_t frame_id;
+    uint32_t stream_id;
+
+    uint16_t width;
+    uint16_t height;
+    uint8_t  bitdepth;
+
+    uint16_t row_begin;
+    uint16_t row_end;
+    size_t   row_bytes;
+
+    const uint8_t* data;
+
+    bool last;          // row_end == height
 };
 
 
@@ -53,17 +100,20 @@ struct FrameResult
 //----------------------------------------------
 struct FrameStreamStats
 {
-    std::atomic<uint64_t> frames_total{0};
-    std::atomic<uint64_t> frames_complete{0};
-    std::atomic<uint64_t> frames_partial{0};
+    // Updated only by the frame worker thread
+    uint32_t stream_id = 0;
+    uint64_t frames_total = 0;
+    uint64_t frames_complete = 0;
+    uint64_t frames_partial = 0;
 
-    std::atomic<uint64_t> partial_due_to_queue{0};
-    std::atomic<uint64_t> partial_due_to_gap{0};
+    uint64_t partial_due_to_queue = 0;
+    uint64_t partial_due_to_gap = 0;
 
-    std::atomic<uint64_t> packets_expected{0};
-    std::atomic<uint64_t> packets_received{0};
+    uint64_t packets_expected = 0;
+    uint64_t packets_received = 0;
 
-    
+    void update(const FrameResult& r);
+    void log() const;
 };
 
 //----------------------------------------------
\ No newline at end of file
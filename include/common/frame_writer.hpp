@@ -7,8 +7,10 @@
 #include <cstddef>
 #include <cstdint>
 
+// Files: <prefix>_{full|partial}_{frame,header,raw}.bin
 void write_frame_to_file(const uint8_t* data,
                          size_t size,
-                         bool corrupted);
+                         bool corrupted,
+                         const char* prefix = "received");
 
                          
@@ -13,6 +13,9 @@
 #include <condition_variable>
 #include <memory>
 #include <atomic>
+#include <chrono>
+
+#include "common/wait_strategy.hpp"
 
 struct RxPacket;
 
@@ -40,6 +43,14 @@ public:
      // observability
     size_t dropped() const { return dropped_.load(); }
     size_t size() const;
+    size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+    // any thread => new capacity for the next push; packets already queued
+    // beyond it are kept (pushes drop until the queue drains below it)
+    void setCapacity(size_t capacity) { capacity_.store(capacity, std::memory_order_relaxed); }
+
+    // RX thread => fill level without the lock (admission watermarks)
+    size_t depth() const { return count_.load(std::memory_order_relaxed); }
 
     // frame thread => timed pop with shutdown check
     bool pop_until(std::unique_ptr<RxPacket>& out,
@@ -49,12 +60,26 @@ public:
 
     std::unique_ptr<RxPacket> pop_or_shutdown(std::atomic<bool>& shutdown);
 
+    // frame thread => pop using a wait strategy (spin / futex park / cv).
+    // *waited is set when the queue was empty on entry (idle wakeup).
+    bool pop_wait(std::unique_ptr<RxPacket>& out,
+                  const hv::wait::Config& wait,
+                  std::chrono::nanoseconds timeout,
+                  const std::atomic<bool>& shutdown,
+                  bool* waited = nullptr);
+
+    // wakes a blocked / parked consumer (shutdown)
+    void wake();
+
 private:
-    const size_t capacity_;
+    std::atomic<size_t> capacity_;
 
     mutable std::mutex mtx_;
     std::condition_variable cv_;
     std::queue<std::unique_ptr<RxPacket>> q_;
 
     std::atomic<size_t> dropped_{0};
+
+    std::atomic<size_t> count_{0};      // q_.size(), readable without the lock
+    hv::wait::Parker    parker_;
 };
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                           payload_copy.hpp                                */
+/*                                                                           */
+/*  Packet payload => frame buffer copy for the frame worker                 */
+/*                                                                           */
+/*   LIBC   : memcpy.  The frame (up to 17 MB) streams through the caches    */
+/*            and evicts the worker's hot state (bitmaps, map nodes, queue   */
+/*            slots) on every frame.                                         */
+/*   STREAM : non-temporal stores, the frame goes to memory without being    */
+/*            allocated in the caches (x86 movntdq / vmovntdq, aarch64 stnp) */
+/*   AUTO   : STREAM for copies from stream_min bytes when the CPU has a     */
+/*            kernel and a frame does not fit in half the last level cache;  */
+/*            LIBC otherwise (a cached frame is cheaper to copy and read)    */
+/*                                                                           */
+/*  Non-temporal stores are weakly ordered: whoever hands a frame (or band)  */
+/*  to another thread calls fence() first.  The writing thread itself may    */
+/*  read the data back at any time, but from DRAM: FrameReassemblerV2 uses   */
+/*  memcpy while a frame digest is hashed out of the frame buffer.           */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace hv::copy {
+
+enum class Mode : uint8_t {
+    LIBC = 0,
+    STREAM,
+    AUTO
+};
+
+struct Config
+{
+    Mode   mode       = Mode::AUTO;
+    size_t stream_min = 1024;       // AUTO: smallest copy that uses STREAM
+};
+
+/*
+ * Process-wide, call before the frame worker starts.  frame_bytes: largest
+ * frame (AUTO compares it with the last level cache).  Returns whether
+ * payload() uses non-temporal stores.
+ */
+bool configure(const Config& cfg, size_t frame_bytes);
+
+/* Kernel picked for this CPU: "avx2-nt", "sse2-nt", "neon-stnp" or "memcpy" */
+const char* kernelName();
+
+/* Last level cache size in bytes (sysfs), 0 if unknown */
+size_t llcBytes();
+
+/* Non-temporal copy (memcpy when the CPU has no kernel), not fenced */
+void streamCopy(void* dst, const void* src, size_t n);
+
+/* Orders earlier non-temporal stores before a hand-off to another thread */
+inline void fence()
+{
+#if defined(__x86_64__)
+    __builtin_ia32_sfence();
+#elif defined(__aarch64__)
+    asm volatile("dmb ishst" ::: "memory");
+#endif
+}
+
+extern size_t g_stream_min;         // configure(): SIZE_MAX => always memcpy
+
+inline void payload(void* dst, const void* src, size_t n)
+{
+    if (n >= g_stream_min)
+        streamCopy(dst, src, n);
+    else
+        std::memcpy(dst, src, n);
+}
+
+/* Read prefetch of [p, p+n), e.g. the next queued packet */
+inline void prefetch(const void* p, size_t n)
+{
+    const char* c = static_cast<const char*>(p);
+    for (size_t off = 0; off < n; off += 64)
+        __builtin_prefetch(c + off, 0, 3);
+}
+
+bool        parseMode(const std::string& s, Mode& mode);     // "memcpy" | "nt" | "auto"
+const char* modeName(Mode m);
+
+} // namespace hv::copy
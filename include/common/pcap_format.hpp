@@ -0,0 +1,46 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                            pcap_format.hpp                                */
+/*                                                                           */
+/*  Classic libpcap file layout (capture writer / replay reader)             */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace pcap {
+
+constexpr uint32_t MAGIC_USEC   = 0xA1B2C3D4;
+constexpr uint32_t MAGIC_NSEC   = 0xA1B23C4D;     // nanosecond timestamps
+
+constexpr uint32_t LINKTYPE_ETHERNET = 1;
+constexpr uint32_t LINKTYPE_RAW      = 101;       // IPv4/IPv6, no link header
+
+constexpr uint32_t SNAPLEN      = 65535;
+
+constexpr uint32_t IPV4_HDR_LEN = 20;
+constexpr uint32_t UDP_HDR_LEN  = 8;
+constexpr uint32_t ETH_HDR_LEN  = 14;
+
+#pragma pack(push, 1)
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version_major;     // 2
+    uint16_t version_minor;     // 4
+    int32_t  thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+};
+
+struct RecordHeader {
+    uint32_t ts_sec;
+    uint32_t ts_frac;           // usec or nsec depending on magic
+    uint32_t incl_len;
+    uint32_t orig_len;
+};
+#pragma pack(pop)
+
+} // namespace pcap
@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                         thread_placement.hpp                              */
+/*                                                                           */
+/*  CPU affinity / scheduling policy per thread role, mlockall, IRQ          */
+/*  affinity hints.  Every setting is read back after it is applied and      */
+/*  the outcome is logged ("[PLACE]") and kept for later inspection.         */
+/*                                                                           */
+/*  Usage: configure() once before threads start, then each thread calls     */
+/*  apply(role) first thing in its body.                                     */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <sched.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hv::placement {
+
+enum class Role : uint8_t {
+    RX = 0,         // UDP receive thread
+    WORKER,         // frame reassembly
+    WRITER,         // capture / output writers, frame pipeline stages
+    LOGGER,         // async log drain
+
+    ROLE_MAX
+};
+
+constexpr size_t ROLE_COUNT = static_cast<size_t>(Role::ROLE_MAX);
+
+struct RoleConfig
+{
+    std::vector<int> cpus;          // empty => leave affinity alone
+    int  policy   = SCHED_OTHER;    // SCHED_OTHER / SCHED_FIFO / SCHED_RR / SCHED_BATCH / SCHED_IDLE
+    int  priority = 0;              // 1..99 for FIFO/RR
+    int  nice     = 0;              // SCHED_OTHER/BATCH only
+    bool set_sched = false;         // policy/priority requested
+    bool set_nice  = false;
+};
+
+struct IrqHint
+{
+    std::string      pattern;       // substring of the /proc/interrupts line (e.g. "eth0")
+    std::vector<int> cpus;
+};
+
+struct Config
+{
+    RoleConfig role[ROLE_COUNT];
+    bool lock_memory = false;       // mlockall(MCL_CURRENT | MCL_FUTURE)
+    std::vector<IrqHint> irq;
+
+    Config();                       // defaults: RX SCHED_FIFO 80, LOGGER nice +10
+};
+
+/* Outcome of apply() as read back from the kernel */
+struct Result
+{
+    Role   role;
+    pid_t  tid;
+    bool   affinity_ok;
+    bool   sched_ok;
+    bool   nice_ok;
+    int    err;                     // first errno seen (0 = none)
+    std::string cpus;               // actual affinity, list form
+    int    policy;
+    int    priority;
+    int    nice;
+};
+
+void   configure(const Config& cfg);
+Config config();
+
+/* Calling thread: affinity, policy/priority, nice; verified and logged */
+Result apply(Role role);
+
+/* Process wide: call once from main after configure() */
+bool lockMemory();                  // no-op unless lock_memory
+void applyIrqHints();               // writes /proc/irq/N/smp_affinity_list
+
+std::vector<Result> results();
+
+/* Parsing helpers for command line / config values */
+bool parseCpuList(const std::string& s, std::vector<int>& out);     // "2-3,6"
+bool parsePolicy(const std::string& s, int& policy, int& priority); // "fifo:80", "other"
+bool parseRole(const std::string& s, Role& role);                   // "rx", "worker", ...
+
+std::string formatCpuList(const std::vector<int>& cpus);
+const char* roleName(Role r);
+const char* policyName(int policy);
+
+} // namespace hv::placement
@@ -0,0 +1,99 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Adaptive Frame Timeouts                         */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Per-stream online estimate of packet inter-arrival gaps (within a frame), frame   */
+/*  period and frame span (first => last packet), each as an EWMA of mean and          */
+/*  variance, plus a slowly decaying peak so that a scheduling stall seen recently     */
+/*  keeps the deadline above it.                                                       */
+/*                                                                                     */
+/*    idle     = max(gap mean + gap_k * sd, 1.5 * gap peak)             [idle range]   */
+/*    lifetime = max(span mean + span_k * sd, 1.5 * span peak) + idle   [life range]   */
+/*                                                                                     */
+/*  After a rate drop no frame completes, so the rest of a frame cut by a deadline     */
+/*  teaches it instead: its silence and span so far raise the peaks.  A tail that was  */
+/*  really lost sends nothing and widens nothing.                                      */
+/*                                                                                     */
+/*  Until warmup_frames frames have completed, the fixed defaults are used.  A 30 fps  */
+/*  link then drops dead frames after tens of ms instead of 8 s, and a slow link       */
+/*  gets a longer idle deadline than the fixed 30 ms.                                  */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+struct TimeoutConfig
+{
+    bool     adaptive = true;               // false => fixed idle / lifetime only
+
+    std::chrono::milliseconds idle_min{2};
+    std::chrono::milliseconds idle_max{1000};
+    std::chrono::milliseconds life_min{50};
+    std::chrono::milliseconds life_max{8000};
+
+    double   gap_k  = 8.0;                  // sd multipliers
+    double   span_k = 4.0;
+    uint32_t warmup_frames = 8;
+};
+
+// EWMA mean / variance of a duration in ns
+struct EwmaStat
+{
+    double   mean = 0.0;
+    double   var  = 0.0;
+    uint64_t n    = 0;
+
+    void   add(double x, double alpha);
+    double sd() const;
+};
+
+class TimeoutEstimator
+{
+public:
+    explicit TimeoutEstimator(const TimeoutConfig& cfg = TimeoutConfig{}) : cfg_(cfg) {}
+
+    void configure(const TimeoutConfig& cfg) { cfg_ = cfg; }
+    const TimeoutConfig& config() const { return cfg_; }
+
+    // Frame worker thread
+    void onPacketGap(uint64_t gap_ns);
+    void onFrameStart(uint64_t now_ns);
+    void onFrameComplete(uint64_t span_ns);
+    void onCutTail(uint64_t span_ns, uint64_t gap_ns);     // packet of a cut frame
+
+    bool ready() const { return cfg_.adaptive && frames_ >= cfg_.warmup_frames; }
+
+    // Valid once ready()
+    std::chrono::nanoseconds idle() const     { return idle_; }
+    std::chrono::nanoseconds lifetime() const { return lifetime_; }
+
+    const EwmaStat& gap() const    { return gap_; }
+    const EwmaStat& period() const { return period_; }
+    const EwmaStat& span() const   { return span_; }
+
+private:
+    void recompute();
+
+    TimeoutConfig cfg_;
+
+    EwmaStat gap_;
+    EwmaStat period_;
+    EwmaStat span_;
+
+    double   gap_peak_  = 0.0;              // decays per completed frame
+    double   span_peak_ = 0.0;
+    uint64_t last_start_ns_ = 0;
+    uint32_t frames_ = 0;
+    uint32_t gaps_ = 0;                     // since the last recompute
+
+    std::chrono::nanoseconds idle_{0};
+    std::chrono::nanoseconds lifetime_{0};
+
+    static constexpr double GAP_ALPHA    = 1.0 / 256;   // per packet
+    static constexpr double FRAME_ALPHA  = 1.0 / 16;    // per frame
+    static constexpr double PEAK_DECAY   = 0.98;        // per completed frame
+    static constexpr double PEAK_MARGIN  = 1.5;
+    static constexpr uint32_t RECOMPUTE_GAPS = 64;      // gap drift without completes
+};
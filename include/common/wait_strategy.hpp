@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                           wait_strategy.hpp                               */
+/*                                                                           */
+/*  How the RX and frame worker threads wait for work:                       */
+/*                                                                           */
+/*   BLOCK     : sleep in the kernel (poll / futex).  Lowest idle CPU.       */
+/*   SPIN_PARK : spin for spin_us after the last item, then futex park.      */
+/*               Bursts are served by the spin, idle periods sleep.          */
+/*   BUSY_POLL : never sleep; SO_BUSY_POLL on the socket.  One full core     */
+/*               per thread, lowest wakeup latency.                          */
+/*                                                                           */
+/*  Lab boxes: BUSY_POLL.  Battery powered field units: BLOCK.               */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace hv::wait {
+
+enum class Mode : uint8_t {
+    BLOCK = 0,
+    SPIN_PARK,
+    BUSY_POLL
+};
+
+struct Config
+{
+    Mode     mode         = Mode::BLOCK;
+    uint32_t spin_us      = 50;     // SPIN_PARK: spin budget after the last item
+    uint32_t busy_poll_us = 50;     // BUSY_POLL: SO_BUSY_POLL value
+};
+
+/*
+ * Single-consumer futex event.  The consumer calls prepare(), re-checks
+ * its condition and then park()s (or cancel()s).  notify() costs one
+ * load when nobody is parked, so producers can call it per item.
+ */
+class Parker
+{
+public:
+    void prepare() { state_.store(PARKED, std::memory_order_seq_cst); }
+    void cancel()  { state_.store(AWAKE, std::memory_order_relaxed); }
+
+    // false on timeout; spurious wakeups are possible
+    bool park(uint64_t timeout_ns);
+
+    void notify()
+    {
+        if (state_.load(std::memory_order_seq_cst) == PARKED)
+            wake();
+    }
+
+private:
+    static constexpr uint32_t AWAKE  = 0;
+    static constexpr uint32_t PARKED = 1;
+
+    void wake();
+
+    std::atomic<uint32_t> state_{AWAKE};
+};
+
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/* CPU time consumed by the calling thread (CLOCK_THREAD_CPUTIME_ID) */
+uint64_t threadCpuNs();
+
+/* SO_BUSY_POLL / SO_PREFER_BUSY_POLL for BUSY_POLL mode, no-op otherwise */
+bool prepareSocket(int sock, const Config& cfg);
+
+bool        parseMode(const std::string& s, Mode& mode);     // "block" | "spin" | "busy"
+const char* modeName(Mode m);
+
+} // namespace hv::wait
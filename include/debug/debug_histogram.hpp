@@ -0,0 +1,136 @@
+/*================================================================================*/
+/*  Latency Histogram Header File                                                 */
+/*                                                                                */
+/*  HDR-style log-linear histograms (16 sub-buckets per power of two, <= 6.25%    */
+/*  relative error) recorded per thread without locks, merged on snapshot.        */
+/*================================================================================*/
+
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace hv::stats {
+
+/* Receive pipeline stages */
+enum Histogram : uint32_t {
+    LAT_SENDER_TO_KERNEL = 0,   // v2 header send_ns => SO_TIMESTAMPNS (clocks must agree)
+    LAT_NIC_TO_KERNEL,          // NIC hardware stamp => kernel stamp (PHC synced to realtime)
+    LAT_KERNEL_TO_USER,         // SO_TIMESTAMPNS => recvmsg returned
+    LAT_QUEUE_DWELL,            // PacketQueue push => pop
+    LAT_WORKER_WAKEUP,          // push => pop, worker was idle (wait strategy cost)
+    LAT_FIRST_BAND,             // first packet => first row band published
+    LAT_FRAME_ASSEMBLY,         // first packet => emitFrame
+    LAT_FRAME_CONSUMER,         // onFrameDone duration (tm_receiver: FramePipeline::submit)
+
+    HIST_MAX
+};
+
+constexpr uint32_t HIST_SUB_BITS   = 4;
+constexpr uint32_t HIST_SUB_COUNT  = 1u << HIST_SUB_BITS;
+constexpr uint32_t HIST_MAX_BITS   = 40;                        // ~18 min in ns
+constexpr uint32_t HIST_BUCKETS    = (HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB_COUNT;
+
+inline uint32_t histBucket(uint64_t v)
+{
+    if (v < HIST_SUB_COUNT)
+        return static_cast<uint32_t>(v);
+
+    uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(v));
+    if (msb >= HIST_MAX_BITS)
+        return HIST_BUCKETS - 1;
+
+    uint32_t shift = msb - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB_COUNT
+         + static_cast<uint32_t>((v >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+/* Upper bound (inclusive) of the values mapped to bucket b */
+inline uint64_t histBucketUpper(uint32_t b)
+{
+    if (b < HIST_SUB_COUNT)
+        return b;
+
+    uint32_t shift = b / HIST_SUB_COUNT - 1;
+    uint64_t sub   = (b % HIST_SUB_COUNT) | HIST_SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+/* Per-thread, single-writer storage */
+struct HistogramCell {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[HIST_BUCKETS];
+};
+
+// Recycled like ThreadCounters (debug_stats.hpp): folded into a retired
+// total on thread exit, shared (atomic updates) beyond MAX_THREADS
+struct ThreadHistograms {
+    HistogramCell h[HIST_MAX];
+    bool          shared;
+};
+
+ThreadHistograms& localHistograms();   // allocated on first use per thread
+
+inline void record(Histogram h, uint64_t ns)
+{
+    ThreadHistograms& t = localHistograms();
+    HistogramCell& c = t.h[h];
+
+    if (__builtin_expect(t.shared, 0))
+    {
+        c.buckets[histBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        c.count.fetch_add(1, std::memory_order_relaxed);
+        c.sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t m = c.max.load(std::memory_order_relaxed);
+        while (ns > m && !c.max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+        return;
+    }
+
+    auto bump = [](std::atomic<uint64_t>& a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    };
+
+    bump(c.buckets[histBucket(ns)], 1);
+    bump(c.count, 1);
+    bump(c.sum, ns);
+    if (ns > c.max.load(std::memory_order_relaxed))
+        c.max.store(ns, std::memory_order_relaxed);
+}
+
+inline uint64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/* Same clock as kernel packet timestamps */
+inline uint64_t realtimeNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/* Merged view */
+struct HistogramSnapshot {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[HIST_BUCKETS];
+
+    uint64_t percentile(double p) const;     // p in [0,100], ns
+    double   mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+HistogramSnapshot histogramSnapshot(Histogram h);
+const char* histogramName(Histogram h);
+
+/* One "[LAT ]" log line per stage: p50/p99/p999/max in microseconds */
+void logHistograms();
+
+} // namespace hv::stats
@@ -13,9 +13,6 @@
 
 #ifdef DEBUG_LOG_ENABLE
 
-constexpr uint16_t TRACE_FLAG_GAP = 1 << 0;
-
-
 namespace debug_log {
 
 /* extremely cheap counters */
@@ -25,16 +22,6 @@ struct Counters {
     uint64_t frames;
 };
 
-struct PacketTraceEntry {
-	uint64_t seq;
-	uint32_t frame_id;
-	uint16_t packet_id;
-	uint16_t packet_count;
-	uint16_t payload_size;
-    uint16_t flags;         // gap detected flag
-};
-
-
 /* global counters */
 extern Counters g;
 
@@ -51,9 +38,7 @@ inline void frame_done()
 }
 
 
-void trace_packet(const PacketTraceEntry& e);
-void dump_ring(const char* path);
-void mark_frame_drop(uint32_t frame_id);
+/* Packet/frame event tracing: see debug/flight_recorder.hpp (always on) */
 
 
 } // namespace debug_log
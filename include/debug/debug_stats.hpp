@@ -5,21 +5,91 @@
 
 #pragma once
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 namespace hv::stats {
 
-/* A frequently accessed counter */
-struct Counters {
-    std::atomic<uint64_t> rx_packets{0};
-    std::atomic<uint64_t> rx_bytes{0};
+/* Monotonic counters */
+enum Counter : uint32_t {
+    RX_PACKETS = 0,
+    RX_BYTES,
+    QUEUE_DROPS,
+    RING_DROPS,                 // AF_PACKET ring full (kernel side)
+    KERNEL_DROPS,               // socket receive buffer full (SO_RXQ_OVFL)
+    STREAM_REJECTS,             // packets of streams beyond the demux limit
 
-    std::atomic<uint64_t> frames_started{0};
-    std::atomic<uint64_t> frames_completed{0};
-    std::atomic<uint64_t> frames_dropped{0};
+    FRAMES_STARTED,
+    FRAMES_COMPLETED,
+    FRAMES_PARTIAL,
+    DIGEST_MISMATCH,
+    LATE_PACKETS,               // packets of frames already emitted (dup / retransmit / cut tail)
+    FRAME_BANDS,                // row bands published (streaming delivery)
+    STAGE_DROPS,                // frames dropped by full FramePipeline stage queues
+    BUFFER_EXHAUSTED,           // packets dropped: no free pooled frame buffer
+    SHED_FRAMES,                // frames abandoned by RX admission under queue pressure
+    SHED_PACKETS,               // ... and their packets dropped before the queue
+
+    CAPTURE_PACKETS,
+    CAPTURE_DROPS,
+
+    COUNTER_MAX
+};
+
+/* Level values, summed over threads */
+enum Gauge : uint32_t {
+    QUEUE_DEPTH = 0,
+    FRAMES_IN_FLIGHT,
+    RX_CPU_US,                  // thread CPU time of the RX / frame worker threads
+    WORKER_CPU_US,
+
+    GAUGE_MAX
+};
+
+constexpr size_t MAX_THREADS = 64;
+
+/*
+ * One block per thread, padded to its own cache lines.  Only the owner
+ * thread writes (plain load+store, no lock prefix); readers use relaxed
+ * loads, so a snapshot never blocks or slows the hot path.
+ *
+ * A thread's block is returned when it exits: its counters are folded
+ * into a retired total, its gauges dropped.  With more than MAX_THREADS
+ * threads alive at once the rest share one block (shared: atomic adds).
+ */
+struct alignas(64) ThreadCounters {
+    std::atomic<uint64_t> counters[COUNTER_MAX];
+    std::atomic<int64_t>  gauges[GAUGE_MAX];
+    bool                  shared;
 };
 
-/* Global single instance */
-extern Counters g;
+ThreadCounters& local();        // registers the calling thread on first use
+
+inline void add(Counter c, uint64_t n = 1)
+{
+    ThreadCounters& b = local();
+    auto& a = b.counters[c];
+    if (__builtin_expect(b.shared, 0))
+        a.fetch_add(n, std::memory_order_relaxed);
+    else
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void set(Gauge g, int64_t v)
+{
+    local().gauges[g].store(v, std::memory_order_relaxed);
+}
+
+/* Aggregated view across all threads */
+struct Snapshot {
+    uint64_t ts_ns;
+    uint64_t counters[COUNTER_MAX];
+    int64_t  gauges[GAUGE_MAX];
+};
+
+Snapshot snapshot();
+
+const char* counterName(Counter c);
+const char* gaugeName(Gauge g);
 
 } // namespace hv::stats
@@ -0,0 +1,155 @@
+/*================================================================================*/
+/*  Flight Recorder Header File                                                   */
+/*                                                                                */
+/*  Always-on binary event trace in an mmap'd file (MAP_SHARED), one ring per     */
+/*  thread.  Each ring has a single writer (plain stores + release head), so      */
+/*  recording costs a few stores and never blocks.  The page cache keeps the      */
+/*  file contents when the process crashes; tm_flight_decode turns it into        */
+/*  Chrome/Perfetto trace JSON.                                                   */
+/*                                                                                */
+/*  File layout:  FileHeader (4 KiB) | RingHeader + Event[ring_events] per slot   */
+/*================================================================================*/
+
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace hv::trace {
+
+constexpr uint64_t FILE_MAGIC   = 0x3130305246564840ull;   // "@HVFR001"
+constexpr uint32_t FILE_VERSION = 2;                        // 2: 32-bit packet id / count
+
+constexpr size_t   DEFAULT_RING_EVENTS = 1u << 18;          // 10 MiB, ~2.6 s @ 100k pps
+constexpr size_t   DEFAULT_MAX_THREADS = 8;
+
+/* Event types */
+enum EventType : uint16_t {
+    EV_NONE = 0,
+    EV_RX_PACKET,           // frame_id, packet_id/count, arg0 = datagram bytes
+    EV_QUEUE_DROP,          // frame_id, packet_id/count (PacketQueue full)
+    EV_FRAME_START,         // frame_id, packet_count
+    EV_FRAME_EMIT,          // frame_id, flags = FrameState, arg0 = received, arg1 = assembly ns
+    EV_PACKET_MISSING,      // frame_id, packet_id/count of a partial frame
+    EV_DIGEST_MISMATCH,     // frame_id, arg1 = receiver digest
+    EV_FRAME_FLUSH,         // frame_id, arg0 = received (shutdown flush)
+    EV_MARK,                // free-form, arg0/arg1 caller defined
+    EV_FRAME_SHED,          // frame_id, packet_count, arg0 = packets admitted before (RX admission)
+    EV_KERNEL_DROP,         // frame_id charged, arg0 = datagrams dropped by the socket (SO_RXQ_OVFL)
+
+    EV_TYPE_MAX
+};
+
+#pragma pack(push, 1)
+struct Event {                      // 40 bytes
+    uint64_t ts_ns;                 // CLOCK_MONOTONIC
+    uint16_t type;
+    uint16_t flags;
+    uint32_t frame_id;
+    uint32_t packet_id;             // 32-bit like the v2 header (frames > 65535 packets)
+    uint32_t packet_count;
+    uint64_t arg1;
+    uint32_t arg0;
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Event) == 40, "flight recorder event must stay 40 bytes");
+
+struct alignas(64) RingHeader {
+    std::atomic<uint64_t> head;     // events written so far (slot = head % ring_events)
+    uint32_t tid;
+    uint32_t in_use;
+    char     name[16];
+    uint64_t freed_seq;             // release order of an exited thread's ring
+};
+
+struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t event_size;
+    uint64_t ring_events;
+    uint32_t max_threads;
+    uint32_t pid;
+    uint64_t mono_base_ns;          // CLOCK_MONOTONIC at open ...
+    uint64_t real_base_ns;          // ... and CLOCK_REALTIME at the same instant
+    std::atomic<uint32_t> threads_used;
+};
+
+constexpr size_t FILE_HEADER_SIZE = 4096;
+
+// Rounded to a cache line: the next RingHeader stays aligned for any ring size
+inline size_t ringBytes(size_t ring_events)
+{
+    return (sizeof(RingHeader) + ring_events * sizeof(Event) + 63) & ~size_t{63};
+}
+
+/* lifecycle (process wide); close() only after recording threads stopped.
+ * ring_events is rounded up to a power of two. */
+bool open(const char* path,
+          size_t ring_events = DEFAULT_RING_EVENTS,
+          size_t max_threads = DEFAULT_MAX_THREADS);
+void close();
+bool isOpen();
+
+namespace detail {
+extern std::atomic<uint32_t> g_epoch;       // 0 => closed
+
+struct Local {
+    RingHeader* ring  = nullptr;
+    Event*      ev    = nullptr;
+    uint64_t    mask  = 0;
+    uint32_t    epoch = 0;
+
+    ~Local();                               // thread exit: frees the ring for reuse
+};
+
+Local& local();
+
+// Claims a ring: an unused one first, else the one freed longest ago by an
+// exited thread (its events are dropped).  ring = nullptr if every ring is in use.
+void   attach(Local& l, uint32_t epoch);
+} // namespace detail
+
+/* Hot path: one event, single writer per ring */
+inline void record(EventType type,
+                   uint32_t frame_id,
+                   uint32_t packet_id    = 0,
+                   uint32_t packet_count = 0,
+                   uint16_t flags        = 0,
+                   uint32_t arg0         = 0,
+                   uint64_t arg1         = 0)
+{
+    uint32_t epoch = detail::g_epoch.load(std::memory_order_acquire);
+    if (epoch == 0)
+        return;
+
+    detail::Local& l = detail::local();
+    if (l.epoch != epoch)
+        detail::attach(l, epoch);
+    if (!l.ring)
+        return;             // no free ring for this thread
+
+    uint64_t head = l.ring->head.load(std::memory_order_relaxed);
+    Event& e = l.ev[head & l.mask];
+
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    e.ts_ns        = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+    e.type         = type;
+    e.packet_id    = packet_id;
+    e.packet_count = packet_count;
+    e.flags        = flags;
+    e.frame_id     = frame_id;
+    e.arg0         = arg0;
+    e.arg1         = arg1;
+
+    l.ring->head.store(head + 1, std::memory_order_release);
+}
+
+const char* eventName(EventType t);
+
+} // namespace hv::trace
@@ -5,32 +5,128 @@
 
 
 #pragma once
+#include <atomic>
+
 #include "hv_debug_cfg.hpp"
+#include "hv_log_record.hpp"
+#include "hv_log_ratelimit.hpp"
 
 namespace hv::debug {
 
 /* lifecycle */
 void init();
+void shutdown();        // drain + stop async backend (safe to call twice)
 
 /* configuration */
 void setLevel(Level level);
 void enable(uint32_t module_mask);
 void disable(uint32_t module_mask);
 
-/* core log */
+/* output backend */
+void    setBackend(Backend backend);
+Backend backend();
+uint64_t droppedMessages();     // async ring overflows since start
+
+/* core log (synchronous, printf-style) */
 void log(Level level, uint32_t module, const char* fmt, ...);
 
+namespace detail {
+extern std::atomic<uint32_t> g_module_mask;
+extern std::atomic<Level>    g_level;
+
+/* Runtime filter, inlined at the call site before arguments are evaluated */
+inline bool accept(Level level, uint32_t module)
+{
+    return static_cast<uint8_t>(level)
+               <= static_cast<uint8_t>(g_level.load(std::memory_order_relaxed))
+        && (g_module_mask.load(std::memory_order_relaxed) & module) != 0;
+}
+
+bool asyncActive();
+bool enter();                   // false => async backend closed, log synchronously
+void leave();                   // after enter(), when nothing is committed
+LogRecord* reserve();           // nullptr => ring full (counted as drop)
+void commit(LogRecord* rec);    // also leave()
+} // namespace detail
+
+/* Unfiltered emit: arguments are captured raw, formatting happens on the
+ * drain thread.  Falls back to log() when the sync backend is active. */
+template <typename... Args>
+inline void emit(Level level, uint32_t module, const char* fmt, Args... args)
+{
+    if (!detail::enter())
+    {
+        log(level, module, fmt, args...);
+        return;
+    }
+
+    LogRecord* rec = detail::reserve();
+    if (!rec)
+    {
+        detail::leave();
+        return;
+    }
+
+    rec->fmt    = fmt;
+    rec->level  = level;
+    rec->module = module;
+    detail::encodeRecord(*rec, args...);
+
+    detail::commit(rec);
+}
+
+/* Filtered deferred-format log (function form of the HV_LOGx macros) */
+template <typename... Args>
+inline void logf(Level level, uint32_t module, const char* fmt, Args... args)
+{
+    if (detail::accept(level, module))
+        emit(level, module, fmt, args...);
+}
+
 } // namespace hv::debug
 
-/* Convenience macros (kept for call-site simplicity) */
-#define HV_LOGE(mod, fmt, ...) \
-    hv::debug::log(hv::debug::Level::Error, mod, fmt, ##__VA_ARGS__)
+/*
+ * Call-site macros
+ *  - compiled out entirely when (level, module) is outside the compile-time filter
+ *  - runtime level/mask check happens before any argument is evaluated
+ */
+#define HV_LOG_AT(lvl, mod, fmt, ...)                                          \
+    do {                                                                       \
+        if constexpr (hv::debug::compiledIn(lvl, mod)) {                       \
+            if (hv::debug::detail::accept(lvl, mod))                           \
+                hv::debug::emit(lvl, mod, fmt, ##__VA_ARGS__);                 \
+        }                                                                      \
+    } while (0)
 
-#define HV_LOGW(mod, fmt, ...) \
-    hv::debug::log(hv::debug::Level::Warn, mod, fmt, ##__VA_ARGS__)
+/* Rate-limited variant: at most rate/s per call site with a burst allowance */
+#define HV_LOG_AT_RL(lvl, mod, rate, burst, fmt, ...)                          \
+    do {                                                                       \
+        if constexpr (hv::debug::compiledIn(lvl, mod)) {                       \
+            if (hv::debug::detail::accept(lvl, mod)) {                         \
+                static hv::debug::RateLimiter hv_rl_(rate, burst,              \
+                                                     __FILE__, __LINE__);      \
+                uint64_t hv_suppressed_ = 0;                                   \
+                if (hv_rl_.allow(hv_suppressed_)) {                            \
+                    if (hv_suppressed_)                                        \
+                        hv::debug::emit(lvl, mod,                              \
+                            "[RATE] %s:%d suppressed %llu messages",           \
+                            __FILE__, __LINE__,                                \
+                            static_cast<unsigned long long>(hv_suppressed_));  \
+                    hv::debug::emit(lvl, mod, fmt, ##__VA_ARGS__);             \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
 
-#define HV_LOGI(mod, fmt, ...) \
-    hv::debug::log(hv::debug::Level::Info, mod, fmt, ##__VA_ARGS__)
+/* Convenience macros (kept for call-site simplicity) */
+#define HV_LOGE(mod, fmt, ...) HV_LOG_AT(hv::debug::Level::Error, mod, fmt, ##__VA_ARGS__)
+#define HV_LOGW(mod, fmt, ...) HV_LOG_AT(hv::debug::Level::Warn,  mod, fmt, ##__VA_ARGS__)
+#define HV_LOGI(mod, fmt, ...) HV_LOG_AT(hv::debug::Level::Info,  mod, fmt, ##__VA_ARGS__)
+#define HV_LOGD(mod, fmt, ...) HV_LOG_AT(hv::debug::Level::Debug, mod, fmt, ##__VA_ARGS__)
 
-#define HV_LOGD(mod, fmt, ...) \
-    hv::debug::log(hv::debug::Level::Debug, mod, fmt, ##__VA_ARGS__)
+#define HV_LOGE_RL(mod, rate, burst, fmt, ...) \
+    HV_LOG_AT_RL(hv::debug::Level::Error, mod, rate, burst, fmt, ##__VA_ARGS__)
+#define HV_LOGW_RL(mod, rate, burst, fmt, ...) \
+    HV_LOG_AT_RL(hv::debug::Level::Warn,  mod, rate, burst, fmt, ##__VA_ARGS__)
+#define HV_LOGI_RL(mod, rate, burst, fmt, ...) \
+    HV_LOG_AT_RL(hv::debug::Level::Info,  mod, rate, burst, fmt, ##__VA_ARGS__)
@@ -12,6 +12,19 @@
 #pragma once
 #include <cstdint>
 
+/*
+ * Compile-time filter (set from CMake; Release defaults to Info)
+ *  HV_LOG_COMPILE_LEVEL   : most verbose level compiled in (0=Error .. 3=Debug)
+ *  HV_LOG_COMPILE_MODULES : module mask compiled in
+ */
+#ifndef HV_LOG_COMPILE_LEVEL
+#define HV_LOG_COMPILE_LEVEL 3
+#endif
+
+#ifndef HV_LOG_COMPILE_MODULES
+#define HV_LOG_COMPILE_MODULES 0xFFFFFFFFu
+#endif
+
 namespace hv::debug {
 
 /* Log level (ordered) */
@@ -28,7 +41,21 @@ enum Module : uint32_t {
     TX    = 1u << 1,
     FRAME = 1u << 2,
     QUEUE = 1u << 3,
+    SYS   = 1u << 4,		// thread placement, resources
     All   = 0xFFFFFFFFu
 };
 
+/* Compile-time filter: false => call site generates no code at all */
+constexpr bool compiledIn(Level level, uint32_t module)
+{
+    return static_cast<uint8_t>(level) <= HV_LOG_COMPILE_LEVEL
+        && (module & static_cast<uint32_t>(HV_LOG_COMPILE_MODULES)) != 0;
+}
+
+/* Log output backend */
+enum class Backend : uint8_t {
+    Sync = 0,			// vprintf on the calling thread
+    Async				// per-thread ring + deferred formatting on a drain thread
+};
+
 } // namespace hv::debug
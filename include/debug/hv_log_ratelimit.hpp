@@ -0,0 +1,76 @@
+/*========================================================================================*/
+/* hv_log_ratelimit.hpp
+ *
+ *  Per-call-site log rate limiter
+ *
+ * 	- Token bucket expressed as GCRA (one atomic "theoretical arrival time")
+ *  - Suppressed messages are counted and summarised, never silently lost
+ *  - Every limiter registers itself so summaries can be flushed periodically
+ *========================================================================================*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+namespace hv::debug {
+
+class RateLimiter
+{
+public:
+    RateLimiter(uint32_t rate_per_sec, uint32_t burst,
+                const char* file, int line);
+
+    /* true => log it; suppressed receives the count dropped since last pass */
+    bool allow(uint64_t& suppressed)
+    {
+        uint64_t now = nowNs();
+        uint64_t tat = tat_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            uint64_t base = (tat > now) ? tat : now;
+            if (base - now > limit_ns_)
+            {
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, base + interval_ns_,
+                                           std::memory_order_relaxed))
+                break;
+        }
+
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* Pending count for the periodic summary (clears it) */
+    uint64_t takeSuppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+    const char* file() const { return file_; }
+    int line() const { return line_; }
+    RateLimiter* next() const { return next_; }
+
+    static RateLimiter* head();
+
+private:
+    static uint64_t nowNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+    }
+
+    std::atomic<uint64_t> tat_{0};
+    std::atomic<uint64_t> suppressed_{0};
+    uint64_t interval_ns_;      // 1 / rate
+    uint64_t limit_ns_;         // burst tolerance
+    const char* file_;
+    int line_;
+    RateLimiter* next_ = nullptr;
+};
+
+/* Log "[RATE] file:line suppressed N" for every limiter with a pending count */
+void reportSuppressed();
+
+} // namespace hv::debug
@@ -0,0 +1,142 @@
+/*========================================================================================*/
+/* hv_log_record.hpp
+ *
+ *  Async log record layout and argument encoding
+ *
+ * 	- Fixed 128-byte record: format pointer + raw argument bytes
+ *  - Strings are copied (NUL terminated, truncated to fit)
+ *  - Formatting is deferred to the drain thread via a per-signature decoder
+ *========================================================================================*/
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "hv_debug_cfg.hpp"
+
+namespace hv::debug {
+
+constexpr size_t LOG_RECORD_SIZE = 128;
+
+struct LogRecord;
+using FormatFn = int (*)(const LogRecord& rec, char* out, size_t cap);
+
+struct LogRecord {
+    const char* fmt;
+    FormatFn    format;
+    uint64_t    ts_ns;
+    uint32_t    module;
+    Level       level;
+    uint8_t     reserved[3];
+    alignas(8) uint8_t args[LOG_RECORD_SIZE - 32];
+};
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord must stay 128 bytes");
+
+namespace detail {
+
+constexpr size_t ARG_SLOT = 8;
+
+template <typename T>
+constexpr bool is_cstr = std::is_same_v<std::decay_t<T>, const char*>
+                      || std::is_same_v<std::decay_t<T>, char*>;
+
+template <typename T>
+using stored_t = std::conditional_t<is_cstr<T>, const char*, std::decay_t<T>>;
+
+constexpr size_t roundSlot(size_t n) { return (n + ARG_SLOT - 1) & ~(ARG_SLOT - 1); }
+
+/* encode one argument */
+template <typename T>
+inline void put(uint8_t*& cur, size_t str_budget, const T& v)
+{
+    if constexpr (is_cstr<T>)
+    {
+        const char* s = v ? v : "(null)";
+        size_t n = 0;
+        while (n + 1 < str_budget && s[n])
+        {
+            cur[n] = static_cast<uint8_t>(s[n]);
+            ++n;
+        }
+        cur[n] = 0;
+        cur += roundSlot(n + 1);
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= ARG_SLOT,
+                      "HV_LOG argument must be a scalar or C string");
+        std::memcpy(cur, &v, sizeof(T));
+        cur += ARG_SLOT;
+    }
+}
+
+/* decode one argument */
+template <typename T>
+inline stored_t<T> get(const uint8_t*& cur)
+{
+    if constexpr (is_cstr<T>)
+    {
+        const char* s = reinterpret_cast<const char*>(cur);
+        cur += roundSlot(std::strlen(s) + 1);
+        return s;
+    }
+    else
+    {
+        std::decay_t<T> v;
+        std::memcpy(&v, cur, sizeof(v));
+        cur += ARG_SLOT;
+        return v;
+    }
+}
+
+template <typename... Args>
+int formatRecord(const LogRecord& rec, char* out, size_t cap)
+{
+    if constexpr (sizeof...(Args) == 0)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-security"
+        return std::snprintf(out, cap, rec.fmt);    // still expands "%%"
+#pragma GCC diagnostic pop
+    }
+    else
+    {
+        const uint8_t* cur = rec.args;
+        std::tuple<stored_t<Args>...> t{ get<Args>(cur)... };   // braced => left-to-right
+        return std::apply([&](auto... a) { return std::snprintf(out, cap, rec.fmt, a...); }, t);
+    }
+}
+
+inline int formatPreformatted(const LogRecord& rec, char* out, size_t cap)
+{
+    return std::snprintf(out, cap, "%s", reinterpret_cast<const char*>(rec.args));
+}
+
+/* Too many arguments for the record => format on the caller (rare path) */
+template <typename... Args>
+inline void encodeRecord(LogRecord& rec, const Args&... args)
+{
+    constexpr size_t n_str   = (size_t{is_cstr<Args>} + ... + 0);
+    constexpr size_t n_fixed = sizeof...(Args) - n_str;
+    constexpr size_t cap     = sizeof(rec.args);
+
+    if constexpr (ARG_SLOT * (n_fixed + n_str) > cap)
+    {
+        std::snprintf(reinterpret_cast<char*>(rec.args), cap, rec.fmt, args...);
+        rec.format = &formatPreformatted;
+    }
+    else
+    {
+        size_t str_budget = n_str ? ((cap - ARG_SLOT * n_fixed) / n_str) & ~(ARG_SLOT - 1) : 0;
+        uint8_t* cur = rec.args;
+        (put(cur, str_budget, args), ...);
+        rec.format = &formatRecord<Args...>;
+    }
+}
+
+} // namespace detail
+} // namespace hv::debug
@@ -0,0 +1,65 @@
+/*================================================================================*/
+/*  Metrics Exporter Header File                                                  */
+/*                                                                                */
+/*  Serves hv::stats snapshots on a local UNIX domain socket.                     */
+/*   - default                : Prometheus text exposition                        */
+/*   - request "json"         : single JSON object                                */
+/*   - HTTP "GET /metrics[.json]" also works (curl --unix-socket)                 */
+/*================================================================================*/
+
+
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "debug/debug_stats.hpp"
+
+namespace hv::stats {
+
+enum class Format { Prometheus, Json };
+
+class MetricsExporter
+{
+public:
+    MetricsExporter() = default;
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start(const std::string& socket_path);
+    void stop();
+
+    /* Extra metric families (appended after the built-in ones).
+     * JSON sections must emit `,"key":value` fragments. */
+    using Section = std::function<void(Format fmt, std::string& out)>;
+    void addSection(Section s);
+
+    /* Render current metrics (also used for the periodic log line) */
+    std::string render(Format fmt);
+
+private:
+    void run();
+    void sample();
+    void serve(int client);
+    void renderHistograms(Format fmt, std::string& out);
+
+    int listen_fd_ = -1;
+    std::string path_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::mutex mtx_;
+    std::vector<Section> sections_;
+
+    // Rates derived from the previous sample (1 s period)
+    Snapshot prev_{};
+    double pps_ = 0.0;
+    double bps_ = 0.0;
+};
+
+} // namespace hv::stats
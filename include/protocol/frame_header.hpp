@@ -9,9 +9,15 @@ struct FrameHeader {
     uint16_t width;          // image width
     uint16_t height;         // image height
     uint8_t  bitdepth;       // RAW bit depth (10/12/16)
-    uint8_t  reserved;       // alignment / future use
+    uint8_t  flags;          // protocol::FRAME_FLAG_* (was reserved)
     uint32_t frame_size;     // payload size (after header)
 };	//Frame unit
-#pragma pack(pop)
 
+// Appended after the payload when FRAME_FLAG_DIGEST is set
+struct FrameTrailer {
+    uint32_t magic;          // protocol::TRAILER_MAGIC
+    uint32_t chunk_size;     // protocol::DIGEST_CHUNK_SIZE used by sender
+    uint64_t digest;         // frame_digest_compute(header + payload)
+};
+#pragma pack(pop)
 
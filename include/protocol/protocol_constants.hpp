@@ -6,10 +6,31 @@ namespace protocol {
 // Maximum UDP payload size (considering MTU)
 constexpr uint32_t MAX_UDP_PAYLOAD = 1400;
 
+// Largest datagram the receiver accepts: 9000-byte jumbo MTU - IPv4 - UDP
+constexpr uint32_t MAX_DATAGRAM = 9000 - 20 - 8;
+
 // Frame magic (CCSDS 121.0-B-2 stub example)
 constexpr uint32_t FRAME_MAGIC = 0xCC1210B2;
 
 // Protocol version
 constexpr uint16_t PROTOCOL_VERSION = 1;
 
+// FrameHeader.flags
+constexpr uint8_t FRAME_FLAG_DIGEST = 1u << 0;   // FrameTrailer follows payload
+
+// Frame trailer magic
+constexpr uint32_t TRAILER_MAGIC = 0xD16E57A1;
+
+// Packet header v2 (UdpPacketHeaderV2), v1 has no magic
+constexpr uint32_t PACKET_MAGIC_V2   = 0x32505648;   // "HVP2"
+constexpr uint8_t  PACKET_VERSION_V2 = 2;
+
+// UdpPacketHeaderV2.flags
+constexpr uint8_t PKT_FLAG_LAST       = 1u << 0;     // last packet of the frame
+constexpr uint8_t PKT_FLAG_RETRANSMIT = 1u << 1;     // resent copy of an earlier packet
+constexpr uint8_t PKT_FLAG_PARITY     = 1u << 2;     // FEC parity, not frame data
+
+// Digest chunk granularity (independent of the UDP payload stride)
+constexpr uint32_t DIGEST_CHUNK_SIZE = 64 * 1024;
+
 } // namespace protocol
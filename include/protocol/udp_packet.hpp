@@ -1,19 +1,193 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include "protocol_constants.hpp"
 
 #pragma pack(push, 1)
-struct UdpPacketHeader {
+// v1 wire header: no magic, 16-bit packet index, stride fixed by the receiver
+struct UdpPacketHeaderV1 {
     uint32_t frame_id;       // Frame identifier (increment)
     uint16_t packet_id;      // Current packet number
     uint16_t packet_count;   // Total number of packets
     uint32_t payload_size;   // the payload size of this packet
 };
 
+// v2 wire header
+struct UdpPacketHeaderV2 {
+    uint32_t magic;          // protocol::PACKET_MAGIC_V2
+    uint8_t  version;        // protocol::PACKET_VERSION_V2
+    uint8_t  flags;          // protocol::PKT_FLAG_*
+    uint16_t header_size;    // payload offset, >= sizeof(UdpPacketHeaderV2)
+    uint16_t stream_id;      // sender stream (camera / channel)
+    uint16_t payload_stride; // frame offset = packet_id * payload_stride
+    uint32_t frame_id;
+    uint32_t packet_id;
+    uint32_t packet_count;
+    uint32_t payload_size;
+    uint64_t send_ns;        // sender CLOCK_REALTIME, 0 if unknown
+};
+#pragma pack(pop)
+
+static_assert(sizeof(UdpPacketHeaderV1) == 12, "v1 header is 12 bytes on the wire");
+static_assert(sizeof(UdpPacketHeaderV2) == 36, "v2 header is 36 bytes on the wire");
+
+namespace protocol {
+
+// Largest payload per packet (jumbo datagram with a v2 header)
+constexpr uint32_t MAX_PAYLOAD_STRIDE = MAX_DATAGRAM - sizeof(UdpPacketHeaderV2);
+
+} // namespace protocol
+
+// Decoded header (either version), what the receive path works with
+struct UdpPacketHeader {
+    uint32_t frame_id = 0;
+    uint32_t packet_id = 0;
+    uint32_t packet_count = 0;
+    uint32_t payload_size = 0;
+    uint16_t stream_id = 0;
+    uint16_t payload_stride = 0;   // 0 => receiver's configured stride (v1)
+    uint8_t  version = 1;
+    uint8_t  flags = 0;
+    uint64_t send_ns = 0;
+};
+
+/*
+ * Payload storage follows the datagram, not the largest stride: up to
+ * MAX_UDP_PAYLOAD bytes inline (one allocation, as before jumbo strides),
+ * larger payloads in a heap buffer of exactly that size.  Payload bytes
+ * are not zero-filled.
+ */
 struct RxPacket {
     UdpPacketHeader hdr;
-    uint8_t payload[1500];   // PAYLOAD_STRIDE
     bool gap_before = false;
+    uint64_t rx_ns = 0;      // CLOCK_MONOTONIC when handed to the queue
+    uint32_t src_ip = 0;     // network byte order (stream demux by source)
+    uint16_t src_port = 0;
+    uint32_t kernel_drops = 0;  // socket drops charged to this packet's frame
+
+    RxPacket() {}
+
+    RxPacket(const RxPacket& o) { *this = o; }
+
+    RxPacket& operator=(const RxPacket& o)
+    {
+        if (this == &o)
+            return *this;
+        hdr          = o.hdr;
+        gap_before   = o.gap_before;
+        rx_ns        = o.rx_ns;
+        src_ip       = o.src_ip;
+        src_port     = o.src_port;
+        kernel_drops = o.kernel_drops;
+        std::memcpy(reservePayload(o.hdr.payload_size), o.payload(), o.hdr.payload_size);
+        return *this;
+    }
+
+    // Room for n payload bytes (contents undefined)
+    uint8_t* reservePayload(size_t n)
+    {
+        if (n <= sizeof(inline_))
+        {
+            heap_.reset();
+            heap_size_ = 0;
+            return inline_;
+        }
+        if (n > heap_size_)
+        {
+            heap_.reset(new uint8_t[n]);
+            heap_size_ = n;
+        }
+        return heap_.get();
+    }
+
+    const uint8_t* payload() const { return heap_ ? heap_.get() : inline_; }
+    uint8_t*       payload()       { return heap_ ? heap_.get() : inline_; }
+
+private:
+    std::unique_ptr<uint8_t[]> heap_;
+    size_t  heap_size_ = 0;
+    uint8_t inline_[protocol::MAX_UDP_PAYLOAD];
 };
 
 
-#pragma pack(pop)
+/*
+ * Parses the header at the start of a datagram: v2 when it starts with
+ * PACKET_MAGIC_V2, v1 otherwise.  Returns the payload offset, or 0 if the
+ * datagram is too short or the sizes do not add up.
+ */
+inline size_t decode_packet_header(const uint8_t* data, size_t len, UdpPacketHeader& out)
+{
+    uint32_t magic;
+    if (len < sizeof(magic))
+        return 0;
+    std::memcpy(&magic, data, sizeof(magic));
+
+    size_t hdr_len;
+    if (magic == protocol::PACKET_MAGIC_V2)
+    {
+        UdpPacketHeaderV2 h;
+        if (len < sizeof(h))
+            return 0;
+        std::memcpy(&h, data, sizeof(h));
+
+        if (h.version != protocol::PACKET_VERSION_V2
+            || h.header_size < sizeof(h) || h.header_size > len
+            || h.payload_stride == 0 || h.payload_stride > protocol::MAX_PAYLOAD_STRIDE
+            || h.payload_size > h.payload_stride)
+            return 0;
+
+        out.frame_id       = h.frame_id;
+        out.packet_id      = h.packet_id;
+        out.packet_count   = h.packet_count;
+        out.payload_size   = h.payload_size;
+        out.stream_id      = h.stream_id;
+        out.payload_stride = h.payload_stride;
+        out.version        = h.version;
+        out.flags          = h.flags;
+        out.send_ns        = h.send_ns;
+        hdr_len = h.header_size;
+    }
+    else
+    {
+        UdpPacketHeaderV1 h;
+        if (len < sizeof(h))
+            return 0;
+        std::memcpy(&h, data, sizeof(h));
+
+        out = UdpPacketHeader{};
+        out.frame_id     = h.frame_id;
+        out.packet_id    = h.packet_id;
+        out.packet_count = h.packet_count;
+        out.payload_size = h.payload_size;
+        hdr_len = sizeof(h);
+    }
+
+    if (len <= hdr_len
+        || out.payload_size > len - hdr_len
+        || out.payload_size > protocol::MAX_PAYLOAD_STRIDE)
+        return 0;
+
+    return hdr_len;
+}
+
+/* Writes a v2 header for h at out (sizeof(UdpPacketHeaderV2) bytes) */
+inline size_t encode_packet_header_v2(const UdpPacketHeader& h, uint8_t* out)
+{
+    UdpPacketHeaderV2 w{};
+    w.magic          = protocol::PACKET_MAGIC_V2;
+    w.version        = protocol::PACKET_VERSION_V2;
+    w.flags          = h.flags;
+    w.header_size    = sizeof(w);
+    w.stream_id      = h.stream_id;
+    w.payload_stride = h.payload_stride;
+    w.frame_id       = h.frame_id;
+    w.packet_id      = h.packet_id;
+    w.packet_count   = h.packet_count;
+    w.payload_size   = h.payload_size;
+    w.send_ns        = h.send_ns;
+
+    std::memcpy(out, &w, sizeof(w));
+    return sizeof(w);
+}
@@ -0,0 +1,92 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame-Aware Admission                           */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  A full PacketQueue drops the newest packet whatever frame it belongs to: under     */
+/*  sustained overload the loss is spread over every frame in flight and all of them   */
+/*  come out partial.  The RX thread instead sheds whole frames once the queue passes  */
+/*  a high watermark (until it falls back to the low one):                             */
+/*                                                                                     */
+/*    NEWEST     frames starting under pressure are dropped entirely; frames already   */
+/*               in progress keep their packets                                        */
+/*    EVERY_NTH  every Nth frame starting under pressure is dropped (decimation)       */
+/*    TAIL       no shedding, previous drop-newest-packet behaviour                    */
+/*                                                                                     */
+/*  If the queue still overflows, the in-progress frame with the least progress (and   */
+/*  below protect_pct complete) is abandoned, so nearly complete frames are the last   */
+/*  to be damaged.                                                                     */
+/*                                                                                     */
+/*  RX thread only (SOCKET ingress, the one path with a queue).                        */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "protocol/udp_packet.hpp"
+
+enum class ShedPolicy : uint8_t {
+    TAIL = 0,
+    NEWEST,
+    EVERY_NTH
+};
+
+bool        parseShedPolicy(const char* s, ShedPolicy& out);
+const char* shedPolicyName(ShedPolicy p);
+
+struct AdmissionConfig
+{
+    ShedPolicy policy      = ShedPolicy::NEWEST;
+    uint32_t   high_pct    = 75;        // queue fill that starts shedding
+    uint32_t   low_pct     = 50;        // ... and ends it
+    uint32_t   every_n     = 2;         // EVERY_NTH: shed 1 of N new frames
+    uint32_t   protect_pct = 90;        // never abandon frames this complete
+};
+
+class FrameAdmission
+{
+public:
+    explicit FrameAdmission(const AdmissionConfig& cfg = AdmissionConfig{}) : cfg_(cfg) {}
+
+    /*
+     * Before the queue push.  depth / capacity: current queue fill.
+     * false => drop the packet (its frame is being shed).
+     */
+    bool admit(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port,
+               size_t depth, size_t capacity);
+
+    // Queue push failed for this packet: abandon the weakest frame
+    void onQueueFull(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port);
+
+    bool underPressure() const { return pressure_; }
+
+private:
+    struct Slot
+    {
+        uint32_t frame_id = 0;
+        uint32_t stream_id = 0;
+        uint32_t src_ip = 0;
+        uint16_t src_port = 0;
+        bool     used = false;
+        bool     shed = false;
+        uint32_t packet_count = 0;
+        uint32_t admitted = 0;
+        uint64_t last_seen = 0;         // packet sequence, LRU eviction
+    };
+
+    Slot* find(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port);
+    Slot& insert(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port);
+    void  shed(Slot& s, const char* why);
+
+    AdmissionConfig cfg_;
+
+    static constexpr size_t MAX_TRACKED = 32;
+    std::array<Slot, MAX_TRACKED> slots_{};
+    Slot*    last_ = nullptr;           // consecutive packets: almost always the same frame
+
+    uint64_t seq_ = 0;
+    uint64_t new_frames_ = 0;           // frames started under pressure (EVERY_NTH)
+    bool     pressure_ = false;
+};
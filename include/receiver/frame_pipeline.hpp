@@ -0,0 +1,143 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Consumer Pipeline                         */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Decouples frame consumers (writer, decoder, publisher, analytics) from the         */
+/*  reassembly thread.  submit() is called from onFrameDone: every registered stage    */
+/*  gets a copy of the FrameResult, whose FrameHandle keeps the pooled frame buffer    */
+/*  alive until the last stage is done with it (no copy of the frame data).            */
+/*                                                                                     */
+/*  Each stage has a bounded queue and an overflow policy:                             */
+/*    BLOCK        submit() waits for room (backpressure onto reassembly)              */
+/*    DROP_OLDEST  the oldest queued frame is discarded                                */
+/*    DROP_NEWEST  the new frame is discarded                                          */
+/*                                                                                     */
+/*  A stage runs on its own thread(s) or, with threads = 0, on the shared pool: pool   */
+/*  threads take work from whichever pool stage has some, one frame per stage at a     */
+/*  time (per-stage order is kept).  Per-stage dwell / service latency and drops are   */
+/*  kept for stats() and the metrics socket.                                           */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/frame_result.hpp"
+#include "debug/debug_histogram.hpp"
+
+enum class StagePolicy : uint8_t {
+    BLOCK = 0,
+    DROP_OLDEST,
+    DROP_NEWEST
+};
+
+bool parseStagePolicy(const std::string& s, StagePolicy& out);
+const char* stagePolicyName(StagePolicy p);
+
+struct StageConfig
+{
+    std::string name;
+    size_t      queue_depth = 8;                // frames
+    StagePolicy policy = StagePolicy::BLOCK;
+    uint32_t    threads = 1;                    // 0 => shared pool
+
+    // Copy r.buffer to keep frame_data past the call
+    std::function<void(const FrameResult&)> fn;
+};
+
+struct StageStats
+{
+    std::string name;
+    StagePolicy policy;
+    uint64_t    submitted;
+    uint64_t    processed;
+    uint64_t    dropped;
+    uint64_t    blocked_ns;                     // submit() time spent waiting (BLOCK)
+    size_t      queued;
+
+    hv::stats::HistogramSnapshot dwell;         // submit => stage picks it up
+    hv::stats::HistogramSnapshot service;       // fn() duration
+};
+
+class FramePipeline
+{
+public:
+    FramePipeline() = default;
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Before start()
+    void addStage(const StageConfig& cfg);
+    void setPoolThreads(uint32_t n) { pool_threads_ = n; }
+
+    bool start();
+
+    // Drains every queue, then joins all threads
+    void stop();
+
+    // Reassembly thread (onFrameDone)
+    void submit(const FrameResult& r);
+
+    size_t stageCount() const { return stages_.size(); }
+    std::vector<StageStats> stats() const;
+
+    // One "[PIPE]" line per stage
+    void logStats() const;
+
+private:
+    struct Job
+    {
+        FrameResult result;             // result.buffer holds the frame
+        uint64_t submit_ns;
+    };
+
+    struct Stage
+    {
+        StageConfig cfg;
+
+        mutable std::mutex      mtx;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::deque<Job>         queue;
+        bool                    busy = false;   // pool stages: one job at a time
+
+        uint64_t submitted = 0;
+        uint64_t processed = 0;
+        uint64_t dropped = 0;
+        uint64_t blocked_ns = 0;
+
+        hv::stats::HistogramSnapshot dwell{};
+        hv::stats::HistogramSnapshot service{};
+
+        std::vector<std::thread> threads;
+    };
+
+    void stageLoop(Stage& s);
+    void poolLoop();
+    void run(Stage& s, Job& job);
+    void notifyPool();
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+    uint32_t pool_threads_ = 1;
+
+    bool running_ = false;
+    std::atomic<bool> stop_{false};
+
+    // Shared pool
+    std::mutex               pool_mtx_;
+    std::condition_variable  pool_cv_;
+    uint64_t                 pool_seq_ = 0;     // bumped on every pool submit
+    std::vector<std::thread> pool_;
+};
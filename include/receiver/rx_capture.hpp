@@ -0,0 +1,78 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX UDP Receive Capture                             */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Records every received datagram with its kernel receive timestamp into a pcap     */
+/*  file (nanosecond, LINKTYPE_RAW with synthesized IPv4/UDP headers).                 */
+/*                                                                                     */
+/*  The RX thread only copies into a lock-free SPSC ring; a writer thread does the     */
+/*  file I/O.  When the ring is full the datagram is dropped from the capture          */
+/*  (counted as capture_drops), never from the receive path.                           */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "protocol/protocol_constants.hpp"
+
+class RxCapture
+{
+public:
+    RxCapture() = default;
+    ~RxCapture();
+
+    RxCapture(const RxCapture&) = delete;
+    RxCapture& operator=(const RxCapture&) = delete;
+
+    // dst_port is written into the synthesized UDP header
+    bool open(const std::string& path, uint16_t dst_port);
+    void close();
+
+    bool isOpen() const { return fp_ != nullptr; }
+
+    /*
+     * RX thread only.  ts_ns = CLOCK_REALTIME receive time,
+     * src_ip/src_port in network byte order (from recvmsg msg_name).
+     */
+    void record(const uint8_t* data, size_t len, uint64_t ts_ns,
+                uint32_t src_ip, uint16_t src_port);
+
+    uint64_t captured() const { return captured_.load(std::memory_order_relaxed); }
+    uint64_t dropped()  const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t SLOT_COUNT = 2048;        // power of two
+    static constexpr size_t SLOT_DATA  = protocol::MAX_DATAGRAM;   // >= RX buffer (jumbo)
+
+    struct Slot {
+        uint64_t ts_ns;
+        uint32_t len;
+        uint32_t src_ip;
+        uint16_t src_port;
+        uint8_t  data[SLOT_DATA];
+    };
+
+    void writerLoop();
+    void writeSlot(const Slot& s);
+
+    FILE*    fp_ = nullptr;
+    uint16_t dst_port_ = 0;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<uint64_t> head_{0};       // producer (RX)
+    alignas(64) std::atomic<uint64_t> tail_{0};       // consumer (writer)
+
+    std::atomic<uint64_t> captured_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::atomic<bool> stop_{false};
+    std::thread       writer_;
+};
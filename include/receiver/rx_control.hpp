@@ -0,0 +1,83 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Receiver Runtime Control                        */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Tuning without a restart: a config file of `key = value` lines (read at start,    */
+/*  again on `reload`) and a local UNIX socket taking one command per line            */
+/*                                                                                     */
+/*    get [key]          current value(s), one `key = value` line each                 */
+/*    set key value      validated, then applied through RxPipeline::reconfigure()     */
+/*    reload             re-reads the config file                                      */
+/*    help               key list                                                      */
+/*                                                                                     */
+/*  Keys: queue_capacity, rcvbuf, max_frame_size, payload_stride, frame_buffers,       */
+/*        idle_timeout_ms, lifetime_ms, timeouts (adaptive|fixed), log_level.         */
+/*  Sizes take a K / M suffix (x1024).  Frame settings reach the processing thread at */
+/*  its next timer tick and apply to frames started after it (rx_pipeline.hpp).        */
+/*                                                                                     */
+/*  e.g.  echo "set queue_capacity 65536" | socat - UNIX-CONNECT:/tmp/hv_ctl.sock      */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "debug/hv_debug_cfg.hpp"
+#include "receiver/rx_pipeline.hpp"
+
+/*
+ * One setting into cfg / log_level.  false with *err set on an unknown key
+ * or a value out of range (cfg untouched).
+ */
+bool setRxTunable(RxPipelineConfig& cfg, hv::debug::Level& log_level,
+                  const std::string& key, const std::string& value,
+                  std::string* err);
+
+/* `key = value` lines for key, or for every key when key is empty ("" if unknown) */
+std::string getRxTunables(const RxPipelineConfig& cfg, hv::debug::Level log_level,
+                          const std::string& key = "");
+
+/*
+ * Config file: `key = value` (or `key value`) per line, '#' comments.
+ * Stops at the first bad line (reported on stderr with its line number).
+ */
+bool loadRxTunables(const std::string& path, RxPipelineConfig& cfg,
+                    hv::debug::Level& log_level);
+
+class RxControl
+{
+public:
+    RxControl() = default;
+    ~RxControl();
+
+    RxControl(const RxControl&) = delete;
+    RxControl& operator=(const RxControl&) = delete;
+
+    // config_path: file for `reload` ("" => none).  pipeline must outlive stop().
+    bool start(const std::string& socket_path, RxPipeline& pipeline,
+               const std::string& config_path = "");
+    void stop();
+
+    // One command line => reply (also usable without the socket)
+    std::string execute(const std::string& line);
+
+private:
+    void run();
+    void serve(int client);
+
+    // set / reload: tunables => pipeline and log level
+    std::string apply(const RxPipelineConfig& cfg, hv::debug::Level level);
+
+    RxPipeline* pipeline_ = nullptr;
+    std::string config_path_;
+
+    int listen_fd_ = -1;
+    std::string path_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::mutex mtx_;                    // one command at a time
+};
@@ -0,0 +1,178 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX UDP Receive Pipeline                            */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  UDP RX thread (recvmsg) => PacketQueue => frame worker (FrameReassemblerManager)   */
+/*  or, with the run-to-completion / AF_PACKET / io_uring ingress, one thread:          */
+/*  kernel buffer => manager, timers on the same thread.                               */
+/*  Shared by tm_receiver and the in-process test tools (tm_soak).                     */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/frame_result.hpp"
+#include "common/packet_queue.hpp"
+#include "common/payload_copy.hpp"
+#include "common/wait_strategy.hpp"
+#include "protocol/udp_packet.hpp"
+#include "receiver/rx_packet_ring.hpp"
+#include "receiver/rx_socket_meta.hpp"
+#include "receiver/rx_uring.hpp"
+#include "receiver/frame_admission.hpp"
+#include "receiver/stream_demux.hpp"
+
+class RxCapture;
+
+enum class RxIngress : uint8_t {
+    SOCKET = 0,             // UDP socket, recvmsg
+    SOCKET_RTC,             // UDP socket, recvmmsg + epoll, run-to-completion (no queue)
+    PACKET_RING,            // AF_PACKET TPACKET_V3 ring (CAP_NET_RAW)
+    URING                   // io_uring multishot recvmsg (HV_WITH_IO_URING)
+};
+
+struct RxPipelineConfig
+{
+    size_t queue_capacity = 4096 * 4;           // PacketQueue capacity
+    size_t max_frame_size = 4096 * 2160 * 2;    // Ex: 4K RAW
+    size_t payload_stride = 1400;               // v1 packets (v2 headers carry their own)
+    size_t frame_buffers  = 32;                 // pooled per stream: in flight + held by consumers
+
+    hv::wait::Config wait;                      // RX / worker idle behaviour
+
+    RxIngress        ingress = RxIngress::SOCKET;
+    std::string      ring_ifname = "lo";        // PACKET_RING: interface to capture on
+    PacketRingConfig ring;
+    UringRxConfig    uring;
+
+    // Multi-stream: one reassembly state per stream, all served by the same threads
+    StreamKeyMode    demux = StreamKeyMode::SINGLE;
+    size_t           max_streams = 16;
+    std::map<uint64_t, StreamConfig> streams;   // key: stream id or StreamDemux::sourceKey()
+
+    // Streaming delivery: onFrameBand every band_rows rows of the contiguous prefix
+    uint32_t         band_rows = 0;             // 0 => whole frames only
+
+    // Idle / lifetime deadlines learned per stream from packet arrivals
+    TimeoutConfig    timeouts;                  // adaptive = false => fixed 30 ms / 8 s
+    uint32_t         idle_timeout_ms = 0;       // fixed for every stream, 0 => as above
+    uint32_t         lifetime_ms = 0;
+
+    int              rcvbuf = 16 * 1024 * 1024; // SO_RCVBUF (open_rx_socket(), reconfigure())
+
+    // SOCKET ingress: shed whole frames ahead of a filling PacketQueue
+    AdmissionConfig  admission;                 // policy TAIL => drop newest packet only
+
+    // Payload => frame buffer copy (process-wide, applied by start())
+    hv::copy::Config copy;                      // AUTO => non-temporal if frames exceed LLC / 2
+
+    RxCapture* capture    = nullptr;            // optional, must be open before start()
+};
+
+/*
+ * Opens the receive socket: rcvbuf bytes SO_RCVBUF, SO_TIMESTAMPING (or
+ * SO_TIMESTAMPNS), SO_RXQ_OVFL, SO_REUSEADDR,
+ * bound to bind_ip:port (bind_ip nullptr => INADDR_ANY, port 0 => ephemeral).
+ * The bound port is stored in *bound_port if given.  Returns -1 on error.
+ */
+int open_rx_socket(uint16_t port,
+                   const char* bind_ip = nullptr,
+                   uint16_t* bound_port = nullptr,
+                   int rcvbuf = RxPipelineConfig{}.rcvbuf);
+
+class RxPipeline
+{
+public:
+    explicit RxPipeline(const RxPipelineConfig& cfg = RxPipelineConfig{});
+    ~RxPipeline();
+
+    RxPipeline(const RxPipeline&) = delete;
+    RxPipeline& operator=(const RxPipeline&) = delete;
+
+    // Called on the frame worker thread for every emitted frame
+    // (unless the stream has its own StreamConfig::sink)
+    std::function<void(const FrameResult&)> onFrameDone;
+
+    // Same thread, rows of a frame still arriving (band_rows > 0 or
+    // StreamConfig::band_rows); always ahead of that frame's onFrameDone
+    std::function<void(const FrameBand&)> onFrameBand;
+
+    // Starts the RX and worker threads on an already bound socket (not owned).
+    // PACKET_RING: the socket only reserves the port; its input is discarded.
+    bool start(int sock);
+
+    // Stops RX, lets the worker drain the queue and flush in-flight frames
+    void stop();
+
+    bool running() const { return running_; }
+
+    const PacketQueue& queue() const { return queue_; }
+
+    /*
+     * Live tuning (any thread).  Only queue_capacity, rcvbuf, max_frame_size,
+     * payload_stride, frame_buffers, idle_timeout_ms, lifetime_ms and timeouts
+     * are taken from next.  Queue capacity and SO_RCVBUF apply at once; the
+     * frame settings are handed to the processing thread and applied at its
+     * next timer tick (<= 5 ms), between packets, to frames started after it.
+     */
+    void reconfigure(const RxPipelineConfig& next);
+    RxPipelineConfig config() const;
+
+    // Thread CPU time (refreshed every ~100 ms / timer tick, exact after stop())
+    uint64_t rxCpuNs()     const { return rx_cpu_ns_.load(std::memory_order_relaxed); }
+    uint64_t workerCpuNs() const { return worker_cpu_ns_.load(std::memory_order_relaxed); }
+
+    // Per-stream counters, any thread (empty before start())
+    std::vector<StreamStatsSnapshot> streamStats() const;
+
+private:
+    void rxLoop(int sock);
+    void workerLoop();
+    void ringLoop();
+    void uringLoop(int sock, std::promise<bool>* ready);
+    void rtcLoop(int sock);
+
+    void ingest(StreamDemux& demux, RxCapture* capture,
+                const uint8_t* data, uint32_t len, const RxSocketMeta& meta,
+                uint32_t src_ip, uint16_t src_port);
+
+    static void recordRxTimestamps(const RxSocketMeta& meta);
+
+    // Processing thread, timer tick: pending reconfigure() frame settings
+    void applyPending(StreamDemux& demux);
+
+    RxPipelineConfig cfg_;
+    PacketQueue      queue_;
+    PacketRing       ring_;
+    UringRx          uring_;
+
+    std::unique_ptr<StreamDemux> demux_;        // used by the processing thread only
+    KernelDropTracker            kdrops_;       // used by the ingress thread only
+
+    std::atomic<bool> shutdown_{false};
+    int               wake_fd_ = -1;            // SOCKET_RTC: eventfd, kicks epoll_wait on stop()
+    int               sock_ = -1;               // not owned, SO_RCVBUF changes
+
+    // reconfigure(): tunables of cfg_ and the settings not yet applied
+    mutable std::mutex cfg_mtx_;
+    RxPipelineConfig   pending_;
+    std::atomic<bool>  reconf_pending_{false};
+
+    std::atomic<uint64_t> rx_cpu_ns_{0};
+    std::atomic<uint64_t> worker_cpu_ns_{0};
+    bool running_ = false;
+
+    std::thread rx_thread_;
+    std::thread worker_thread_;
+};
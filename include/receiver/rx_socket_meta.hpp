@@ -0,0 +1,68 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Receive Socket Instrumentation                  */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Ancillary data of every received datagram:                                         */
+/*                                                                                     */
+/*    SO_TIMESTAMPING   software receive time (ts[0]) and, when the NIC stamps and     */
+/*                      hardware timestamping is enabled on it, raw NIC time (ts[2])   */
+/*    SO_TIMESTAMPNS    software receive time, fallback without SO_TIMESTAMPING        */
+/*    SO_RXQ_OVFL       socket drops (receive buffer full) counted when this datagram  */
+/*                      was queued                                                     */
+/*                                                                                     */
+/*  The drop counter is cumulative per socket, so the difference to the previous       */
+/*  datagram is the loss just before this one.  KernelDropTracker attributes it to     */
+/*  that datagram's frame (or, when the datagram opens a new frame, to the previous    */
+/*  one), next to the user-space queue_drops: a rising kernel_drops means SO_RCVBUF    */
+/*  or RX thread scheduling, queue_drops means the worker.                             */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <sys/socket.h>
+#include <ctime>
+#include <cstddef>
+#include <cstdint>
+
+#include "protocol/udp_packet.hpp"
+
+struct RxSocketMeta
+{
+    uint64_t sw_ns = 0;             // kernel receive time, CLOCK_REALTIME (0 if absent)
+    uint64_t hw_ns = 0;             // NIC time, PHC clock (0 if absent)
+    uint32_t ovfl = 0;              // SO_RXQ_OVFL counter
+    bool     has_ovfl = false;      // only sent once the socket has dropped
+};
+
+// Control buffer for SCM_TIMESTAMPNS + SCM_TIMESTAMPING + SO_RXQ_OVFL
+constexpr size_t RX_CMSG_SPACE = CMSG_SPACE(sizeof(timespec))
+                               + CMSG_SPACE(3 * sizeof(timespec))
+                               + CMSG_SPACE(sizeof(uint32_t));
+
+/*
+ * SO_RXQ_OVFL, SO_TIMESTAMPING (software + raw hardware) and, if that is
+ * refused, SO_TIMESTAMPNS.  Failures are reported and otherwise ignored.
+ */
+void enable_rx_instrumentation(int sock);
+
+void parse_rx_cmsg(const msghdr& m, RxSocketMeta& out);
+
+class KernelDropTracker
+{
+public:
+    /*
+     * Per datagram, RX thread.  Returns the drops charged to hdr's frame
+     * (0 when there were none or they went to the previous frame).
+     */
+    uint32_t onDatagram(const RxSocketMeta& meta, const UdpPacketHeader& hdr);
+
+    uint64_t total() const { return total_; }
+
+private:
+    uint32_t last_ovfl_ = 0;
+    uint64_t total_ = 0;
+
+    uint32_t prev_frame_ = 0;
+    uint32_t prev_stream_ = 0;
+    bool     has_prev_ = false;
+};
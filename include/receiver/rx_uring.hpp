@@ -0,0 +1,124 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX io_uring Receive                                */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Alternative ingress on the bound UDP socket: one multishot IORING_OP_RECVMSG with  */
+/*  a registered provided-buffer ring.  The kernel picks a buffer per datagram and     */
+/*  posts a completion; one io_uring_enter() reaps a whole batch.  No poll() +         */
+/*  recvfrom() pair and no syscall per datagram.                                       */
+/*                                                                                     */
+/*  wait() returns a batch of datagrams whose payload still lives in ring buffers;     */
+/*  recycle() hands all of them back once the reassembler has copied the payload.     */
+/*                                                                                     */
+/*  Raw syscalls (no liburing).  Built only with HV_HAVE_IO_URING (CMake option        */
+/*  HV_WITH_IO_URING); otherwise open() fails and the socket ingress must be used.     */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "receiver/rx_socket_meta.hpp"
+
+struct UringRxConfig
+{
+    uint32_t sq_entries = 64;
+    uint32_t cq_entries = 4096;     // multishot bursts land here; overflow => rearm
+    uint32_t buffers    = 2048;     // provided buffers, power of two
+    uint32_t buf_size   = 9216;     // recvmsg_out + name + control + jumbo datagram
+};
+
+class UringRx
+{
+public:
+    struct Datagram
+    {
+        const uint8_t* data;        // UDP payload (our packet header + payload)
+        uint32_t       len;
+        RxSocketMeta   meta;        // receive timestamps, socket drop counter
+        uint32_t       src_ip;      // network byte order
+        uint16_t       src_port;    // network byte order
+        bool           truncated;   // larger than the buffer
+    };
+
+    struct Stats
+    {
+        uint64_t completions = 0;
+        uint64_t enters = 0;        // io_uring_enter() calls
+        uint64_t rearms = 0;        // multishot re-submissions
+        uint64_t no_buffers = 0;    // -ENOBUFS: buffer ring ran dry
+        uint64_t truncated = 0;
+    };
+
+    UringRx() = default;
+    ~UringRx();
+
+    UringRx(const UringRx&) = delete;
+    UringRx& operator=(const UringRx&) = delete;
+
+    static bool available();        // compiled in
+
+    // sock must be bound; timestamps / SO_RXQ_OVFL are picked up if enabled
+    bool open(int sock, const UringRxConfig& cfg = UringRxConfig{});
+    void close();
+
+    bool isOpen() const { return ring_fd_ >= 0; }
+
+    /*
+     * Reaps up to max datagrams, waiting up to timeout_ms (0 = no wait)
+     * for the first one.  Payload pointers stay valid until recycle().
+     */
+    size_t wait(Datagram* out, size_t max, int timeout_ms);
+
+    // Returns every buffer handed out by the last wait() to the kernel
+    void recycle();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool arm();
+    int  enter(uint32_t to_submit, uint32_t min_complete, int timeout_ms);
+
+    int ring_fd_ = -1;
+    int sock_ = -1;
+
+    // SQ / CQ ring mappings
+    void*     sq_ptr_ = nullptr;
+    size_t    sq_len_ = 0;
+    void*     cq_ptr_ = nullptr;
+    size_t    cq_len_ = 0;
+    void*     sqes_ = nullptr;
+    size_t    sqes_len_ = 0;
+
+    uint32_t* sq_head_ = nullptr;
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t  sq_mask_ = 0;
+    uint32_t* sq_array_ = nullptr;
+
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t  cq_mask_ = 0;
+    void*     cqes_ = nullptr;
+
+    // Provided buffer ring
+    void*     br_ = nullptr;        // io_uring_buf_ring
+    size_t    br_len_ = 0;
+    uint8_t*  bufs_ = nullptr;
+    uint32_t  buf_count_ = 0;
+    uint32_t  buf_size_ = 0;
+    uint16_t  br_tail_ = 0;
+
+    uint16_t* pending_ = nullptr;   // buffer ids handed out, not yet recycled
+    uint32_t  pending_n_ = 0;
+
+    // Must outlive the multishot request
+    msghdr    msg_{};
+
+    bool      armed_ = false;
+    Stats     stats_;
+};
@@ -0,0 +1,183 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Stream Demultiplexer                            */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Several cameras into one receiver: packets are keyed by the v2 header stream id    */
+/*  or by source address:port, and each stream gets its own FrameReassemblerManager   */
+/*  (frame id space, frame buffer size, timeouts), counters and optional sink.         */
+/*                                                                                     */
+/*  Owned by the RX pipeline and driven by its single processing thread (frame worker */
+/*  or run-to-completion / ring / io_uring thread).  Counters are atomics and          */
+/*  snapshot() may be called from any thread.                                          */
+/*=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/frame_result.hpp"
+#include "common/timeout_estimator.hpp"
+#include "protocol/udp_packet.hpp"
+
+class FrameReassemblerManager;
+
+enum class StreamKeyMode : uint8_t {
+    SINGLE = 0,             // one stream, previous behaviour
+    STREAM_ID,              // v2 header stream_id (v1 packets => stream 0)
+    SOURCE                  // source IPv4 address + UDP port
+};
+
+struct StreamConfig
+{
+    size_t   max_frame_size = 0;        // 0 => pipeline default
+    size_t   payload_stride = 0;        // v1 packets, 0 => pipeline default
+    uint32_t idle_timeout_ms = 0;       // 0 => manager default
+    uint32_t lifetime_ms = 0;           // 0 => manager default
+    uint32_t band_rows = 0;             // streaming delivery, 0 => demux default
+    size_t   frame_buffers = 0;         // pooled frame buffers, 0 => demux default
+    std::string name;                   // log / output label, "" => "s<id>"
+
+    // Per-stream consumer, called instead of StreamDemux::onFrameDone
+    std::function<void(const FrameResult&)> sink;
+};
+
+struct StreamStatsSnapshot
+{
+    uint32_t    id;
+    std::string name;
+    uint64_t    packets;
+    uint64_t    bytes;
+    uint64_t    frames_complete;
+    uint64_t    frames_partial;
+    uint64_t    in_flight;
+    uint64_t    idle_timeout_us;        // deadlines in effect (adaptive or fixed)
+    uint64_t    lifetime_us;
+};
+
+class StreamDemux
+{
+public:
+    StreamDemux(StreamKeyMode mode,
+                size_t max_streams,
+                size_t max_frame_size,
+                size_t payload_stride,
+                size_t frame_buffers);
+    ~StreamDemux();
+
+    StreamDemux(const StreamDemux&) = delete;
+    StreamDemux& operator=(const StreamDemux&) = delete;
+
+    /*
+     * Per-stream settings, before the first packet.  key: the stream id
+     * (STREAM_ID) or sourceKey(ip, port) (SOURCE).  Unlisted streams use
+     * the defaults.
+     */
+    void configure(uint64_t key, const StreamConfig& cfg);
+
+    static uint64_t sourceKey(uint32_t ip, uint16_t port)   // network byte order
+    {
+        return (static_cast<uint64_t>(ip) << 16) | port;
+    }
+
+    // Default consumer for every emitted frame (FrameResult::stream_id set)
+    std::function<void(const FrameResult&)> onFrameDone;
+
+    // Row bands of frames in progress (FrameBand::stream_id set); before
+    // the first packet, rows 0 => whole frames only
+    void setBandRows(uint32_t rows) { band_rows_ = rows; }
+    std::function<void(const FrameBand&)> onFrameBand;
+
+    // Adaptive frame timeouts for every stream, before the first packet;
+    // StreamConfig idle_timeout_ms / lifetime_ms still pin their deadline
+    void setTimeoutConfig(const TimeoutConfig& cfg) { timeouts_ = cfg; }
+
+    // Fixed idle / lifetime for streams whose StreamConfig has none (0 => adaptive / default)
+    void setTimeouts(uint32_t idle_ms, uint32_t lifetime_ms)
+    {
+        idle_ms_     = idle_ms;
+        lifetime_ms_ = lifetime_ms;
+    }
+
+    /*
+     * Live change of the defaults above and of the constructor's, from the
+     * processing thread between packets.  Existing streams take them for
+     * their next frame (StreamConfig values still win); frames in flight
+     * keep their buffer.
+     */
+    void reconfigure(size_t max_frame_size,
+                     size_t payload_stride,
+                     size_t frame_buffers,
+                     uint32_t idle_ms,
+                     uint32_t lifetime_ms,
+                     const TimeoutConfig& timeouts);
+
+    void pushPacket(const UdpPacketHeader& hdr,
+                    const uint8_t* payload,
+                    uint32_t src_ip,
+                    uint16_t src_port,
+                    bool gap_before,
+                    size_t queue_drop_count,
+                    uint32_t kernel_drops = 0);
+
+    void pollTimers(size_t queue_drop_now);
+    void flushAll();
+
+    size_t streamCount() const;
+    std::vector<StreamStatsSnapshot> snapshot() const;
+
+    StreamKeyMode mode() const { return mode_; }
+
+private:
+    struct Stream
+    {
+        uint32_t id;
+        StreamConfig cfg;
+        std::unique_ptr<FrameReassemblerManager> manager;
+
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> complete{0};
+        std::atomic<uint64_t> partial{0};
+        std::atomic<uint64_t> in_flight{0};
+        std::atomic<uint64_t> idle_us{0};
+        std::atomic<uint64_t> lifetime_us{0};
+    };
+
+    Stream* lookup(uint64_t key);
+    Stream* create(uint64_t key, uint32_t id);
+    void    applySettings(Stream& s);       // StreamConfig over the defaults
+    void    updateInFlight(Stream& s);
+    void    updateDeadlines(Stream& s);
+
+    StreamKeyMode mode_;
+    size_t        max_streams_;
+    size_t        max_frame_size_;
+    size_t        payload_stride_;
+    size_t        frame_buffers_;
+    uint32_t      band_rows_ = 0;
+    TimeoutConfig timeouts_;
+    uint32_t      idle_ms_ = 0;
+    uint32_t      lifetime_ms_ = 0;
+
+    std::map<uint64_t, StreamConfig> configured_;
+
+    // Inserted by the processing thread, walked by snapshot()
+    mutable std::mutex                           mtx_;
+    std::map<uint64_t, std::unique_ptr<Stream>> streams_;
+
+    // Last stream hit: consecutive packets are almost always the same stream
+    uint64_t last_key_ = 0;
+    Stream*  last_ = nullptr;
+
+    size_t   in_flight_total_ = 0;
+    uint32_t next_index_ = 0;           // SOURCE: stream ids in arrival order
+};
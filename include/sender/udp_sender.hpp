@@ -5,9 +5,16 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include "protocol/protocol_constants.hpp"
+
 class UdpSender {
 public:
-    UdpSender(const std::string& ip, uint16_t port);
+    // stride: payload bytes per packet (v2 up to protocol::MAX_PAYLOAD_STRIDE,
+    // v1 fixed at protocol::MAX_UDP_PAYLOAD)
+    UdpSender(const std::string& ip, uint16_t port,
+              uint32_t stride = protocol::MAX_UDP_PAYLOAD,
+              uint16_t stream_id = 0,
+              uint8_t version = protocol::PACKET_VERSION_V2);
     ~UdpSender();
 
     bool waitWritable();
@@ -16,5 +23,8 @@ public:
 private:
     int sock_;
     uint32_t frame_id_;
+    uint32_t stride_;
+    uint16_t stream_id_;
+    uint8_t  version_;
     struct sockaddr_in addr_;
 };
@@ -0,0 +1,102 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                            impairment.hpp                                 */
+/*                                                                           */
+/*  In-process network impairment (netem stand-in, no root needed)           */
+/*                                                                           */
+/*  submit() => loss / burst loss => duplicate => reorder => delay => emit   */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+struct ImpairmentConfig
+{
+    double   loss         = 0.0;    // independent loss probability
+
+    // Gilbert-Elliott burst loss: GOOD -> BAD with burst_enter, BAD -> GOOD
+    // with burst_exit, packets in BAD are lost with burst_loss
+    double   burst_enter  = 0.0;
+    double   burst_exit   = 0.25;
+    double   burst_loss   = 1.0;
+
+    double   duplicate    = 0.0;    // probability of an extra copy
+    double   reorder      = 0.0;    // probability a packet is held back ...
+    uint32_t reorder_gap  = 8;      // ... until this many later packets passed
+
+    uint32_t delay_us     = 0;      // fixed one-way delay
+    uint32_t jitter_us    = 0;      // + uniform [0, jitter) (also reorders)
+
+    uint64_t seed         = 1;
+};
+
+struct ImpairmentStats
+{
+    uint64_t submitted   = 0;
+    uint64_t emitted     = 0;
+    uint64_t lost        = 0;
+    uint64_t lost_burst  = 0;
+    uint64_t duplicated  = 0;
+    uint64_t reordered   = 0;
+    uint64_t delayed     = 0;
+};
+
+class Impairment
+{
+public:
+    explicit Impairment(const ImpairmentConfig& cfg);
+
+    // Receives every datagram that leaves the impairment stage
+    std::function<void(const uint8_t* data, size_t len)> emit;
+
+    // Feed one datagram at time now_ns (CLOCK_MONOTONIC)
+    void submit(const uint8_t* data, size_t len, uint64_t now_ns);
+
+    // Release delayed datagrams that are due
+    void poll(uint64_t now_ns);
+
+    // Release everything still held (end of run)
+    void drain();
+
+    size_t pending() const { return held_.size() + delay_line_.size(); }
+
+    const ImpairmentStats& stats() const { return stats_; }
+
+private:
+    struct Held
+    {
+        uint64_t             release;      // submit count (reorder) or ns (delay)
+        uint64_t             seq;          // FIFO tie-break
+        std::vector<uint8_t> data;
+
+        bool operator>(const Held& o) const
+        {
+            return release != o.release ? release > o.release : seq > o.seq;
+        }
+    };
+
+    bool chance(double p) { return p > 0.0 && uni_(rng_) < p; }
+
+    void afterLoss(const uint8_t* data, size_t len, uint64_t now_ns);
+    void toDelay(const uint8_t* data, size_t len, uint64_t now_ns);
+
+    ImpairmentConfig cfg_;
+    ImpairmentStats  stats_;
+
+    std::mt19937_64 rng_;
+    std::uniform_real_distribution<double> uni_{0.0, 1.0};
+
+    bool     burst_bad_ = false;
+    uint64_t seq_ = 0;
+
+    std::deque<Held> held_;                      // reorder, ordered by release
+    std::priority_queue<Held, std::vector<Held>, std::greater<Held>> delay_line_;
+};
@@ -80,6 +80,9 @@ if [ -f received_raw.bin ] && [ -f "$RAW_PATH" ]; then
   fi
 fi
 
+echo "End-to-end digest (receiver):"
+grep "\[DIGEST\]" "$RECEIVER_LOG" || echo "no digest line found"
+
 echo "Last lines of receiver log:"
 tail -n 40 "$RECEIVER_LOG" || true
 
@@ -0,0 +1,204 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                          bench_harness.cpp                                */
+/*                                                                           */
+/*  Minimal microbenchmark harness for tm_bench (JSON output)                */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "bench/bench_harness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace bench {
+
+uint64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+void Runner::addCustom(const std::string& name, std::function<Result()> fn)
+{
+    custom_.emplace_back(name, std::move(fn));
+}
+
+namespace {
+
+struct StderrSilencer
+{
+    int saved = -1;
+
+    explicit StderrSilencer(bool on)
+    {
+        if (!on)
+            return;
+        std::fflush(stderr);
+        saved = ::dup(STDERR_FILENO);
+        int devnull = ::open("/dev/null", O_WRONLY);
+        if (devnull >= 0)
+        {
+            ::dup2(devnull, STDERR_FILENO);
+            ::close(devnull);
+        }
+    }
+
+    ~StderrSilencer()
+    {
+        if (saved < 0)
+            return;
+        std::fflush(stderr);
+        ::dup2(saved, STDERR_FILENO);
+        ::close(saved);
+    }
+};
+
+} // namespace
+
+Result Runner::runCase(const Case& c)
+{
+    StderrSilencer quiet(c.quiet_stderr);
+
+    std::vector<double> samples;
+    samples.reserve(1024);
+
+    // Warm-up (caches, page faults, branch predictors)
+    if (c.setup) c.setup();
+    c.run();
+
+    uint64_t budget_ns = static_cast<uint64_t>(opt_.min_time_s * 1e9);
+    uint64_t spent = 0;
+
+    while (spent < budget_ns && samples.size() < opt_.max_iters)
+    {
+        if (c.setup) c.setup();
+
+        uint64_t t0 = nowNs();
+        c.run();
+        uint64_t dt = nowNs() - t0;
+
+        samples.push_back(static_cast<double>(dt));
+        spent += dt;
+    }
+
+    Result r;
+    r.name       = c.name;
+    r.iterations = samples.size();
+    r.ops        = r.iterations * c.ops_per_iter;
+
+    for (double s : samples)
+        r.total_ns += s;
+
+    std::sort(samples.begin(), samples.end());
+    r.iter_min_ns = samples.front();
+    r.iter_p50_ns = samples[samples.size() / 2];
+    r.iter_p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+
+    r.ns_per_op     = r.total_ns / static_cast<double>(r.ops);
+    r.ops_per_sec   = 1e9 / r.ns_per_op;
+    r.bytes_per_sec = c.bytes_per_iter
+                    ? c.bytes_per_iter * r.iterations / (r.total_ns / 1e9)
+                    : 0.0;
+    return r;
+}
+
+static void jsonString(FILE* fp, const std::string& s)
+{
+    std::fputc('"', fp);
+    for (char ch : s)
+    {
+        if (ch == '"' || ch == '\\')
+            std::fputc('\\', fp);
+        std::fputc(ch, fp);
+    }
+    std::fputc('"', fp);
+}
+
+void Runner::writeJson(const std::vector<Result>& results)
+{
+    FILE* fp = opt_.json_path.empty() ? stdout : std::fopen(opt_.json_path.c_str(), "w");
+    if (!fp)
+    {
+        perror("fopen(json)");
+        return;
+    }
+
+    utsname u{};
+    uname(&u);
+
+    std::fprintf(fp, "{\n  \"context\": {\"host\": ");
+    jsonString(fp, u.nodename);
+    std::fprintf(fp, ", \"machine\": ");
+    jsonString(fp, u.machine);
+    std::fprintf(fp, ", \"kernel\": ");
+    jsonString(fp, u.release);
+    std::fprintf(fp, ", \"cpus\": %ld, \"min_time_s\": %.3f},\n",
+                 sysconf(_SC_NPROCESSORS_ONLN), opt_.min_time_s);
+
+    std::fprintf(fp, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        std::fprintf(fp, "    {\"name\": ");
+        jsonString(fp, r.name);
+        std::fprintf(fp,
+            ", \"iterations\": %llu, \"ops\": %llu, \"ns_per_op\": %.3f"
+            ", \"ops_per_sec\": %.1f, \"bytes_per_sec\": %.1f"
+            ", \"iter_min_ns\": %.0f, \"iter_p50_ns\": %.0f, \"iter_p99_ns\": %.0f",
+            static_cast<unsigned long long>(r.iterations),
+            static_cast<unsigned long long>(r.ops),
+            r.ns_per_op, r.ops_per_sec, r.bytes_per_sec,
+            r.iter_min_ns, r.iter_p50_ns, r.iter_p99_ns);
+
+        for (auto& kv : r.extra)
+        {
+            std::fprintf(fp, ", ");
+            jsonString(fp, kv.first);
+            std::fprintf(fp, ": %.3f", kv.second);
+        }
+        std::fprintf(fp, "}%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    std::fprintf(fp, "  ]\n}\n");
+
+    if (fp != stdout)
+        std::fclose(fp);
+}
+
+int Runner::runAll()
+{
+    std::vector<Result> results;
+
+    auto selected = [&](const std::string& name) {
+        return opt_.filter.empty() || name.find(opt_.filter) != std::string::npos;
+    };
+
+    for (const Case& c : cases_)
+    {
+        if (!selected(c.name))
+            continue;
+        std::fprintf(stderr, "[BENCH] %s ...\n", c.name.c_str());
+        results.push_back(runCase(c));
+    }
+
+    for (auto& kv : custom_)
+    {
+        if (!selected(kv.first))
+            continue;
+        std::fprintf(stderr, "[BENCH] %s ...\n", kv.first.c_str());
+        Result r = kv.second();
+        r.name = kv.first;
+        results.push_back(std::move(r));
+    }
+
+    writeJson(results);
+    return 0;
+}
+
+} // namespace bench
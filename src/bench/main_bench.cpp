@@ -0,0 +1,512 @@
+/*=====================================================================================*/
+/*                     tm_bench : receive hot path microbenchmarks                     */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Usage: tm_bench [--filter substr] [--min-time sec] [--json path] [--out-dir dir]   */
+/*                                                                                     */
+/*  Results are printed as JSON (stdout unless --json is given) so runs before and     */
+/*  after a change can be diffed by scripts.                                           */
+/*=====================================================================================*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bench/bench_harness.hpp"
+
+#include "common/frame_digest.hpp"
+#include "common/frame_reassembler.hpp"
+#include "common/frame_reassembler_manager.hpp"
+#include "common/frame_reassembler_v2.hpp"
+#include "common/frame_writer.hpp"
+#include "common/packet_queue.hpp"
+#include "common/payload_copy.hpp"
+
+#include "debug/hv_debug.hpp"
+
+#include "protocol/frame_header.hpp"
+#include "protocol/udp_packet.hpp"
+
+#include "sender/ccsds_stub_encoder.hpp"
+
+namespace {
+
+// tm_receiver defaults
+constexpr size_t MAX_QUEUE_SIZE  = 4096 * 4;
+constexpr size_t MAX_FRAME_SIZE  = 4096 * 2160 * 2;
+constexpr size_t PAYLOAD_STRIDE  = protocol::MAX_UDP_PAYLOAD;
+
+// 1920x1080 12-bit in 16-bit containers, like the bundled gradient RAW
+constexpr uint16_t FRAME_W = 1920;
+constexpr uint16_t FRAME_H = 1080;
+
+/* Encoded frame split into RxPackets exactly like UdpSender does */
+struct PacketSet
+{
+    std::vector<uint8_t>  frame;
+    std::vector<RxPacket> packets;
+
+    void build(uint32_t frame_id)
+    {
+        std::vector<uint8_t> raw(static_cast<size_t>(FRAME_W) * FRAME_H * 2);
+        for (size_t i = 0; i < raw.size(); ++i)
+            raw[i] = static_cast<uint8_t>(i * 7 + (i >> 11));
+
+        CcsdsStubEncoder enc;
+        frame = enc.encode(raw, FRAME_W, FRAME_H, 12);
+
+        size_t count = (frame.size() + PAYLOAD_STRIDE - 1) / PAYLOAD_STRIDE;
+        packets.resize(count);
+
+        for (size_t pid = 0; pid < count; ++pid)
+        {
+            size_t off = pid * PAYLOAD_STRIDE;
+            size_t n   = std::min(PAYLOAD_STRIDE, frame.size() - off);
+
+            RxPacket& p = packets[pid];
+            p.hdr.frame_id     = frame_id;
+            p.hdr.packet_id    = static_cast<uint16_t>(pid);
+            p.hdr.packet_count = static_cast<uint16_t>(count);
+            p.hdr.payload_size = static_cast<uint32_t>(n);
+            std::memcpy(p.reservePayload(n), frame.data() + off, n);
+        }
+    }
+
+    uint16_t count() const { return static_cast<uint16_t>(packets.size()); }
+};
+
+std::vector<size_t> makeOrder(size_t n, const std::string& kind)
+{
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    if (kind == "reversed")
+    {
+        std::reverse(order.begin(), order.end());
+    }
+    else if (kind == "random")
+    {
+        std::mt19937 rng(12345);
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+    else if (kind == "duplicates")
+    {
+        // every packet delivered twice, second copy right after the first
+        std::vector<size_t> dup;
+        dup.reserve(n * 2);
+        for (size_t i : order)
+        {
+            dup.push_back(i);
+            dup.push_back(i);
+        }
+        order.swap(dup);
+    }
+    return order;
+}
+
+/*---------------------------------------------------------------*/
+/* FrameReassemblerV2::pushPacket                                */
+/*---------------------------------------------------------------*/
+void addReassemblerV2(bench::Runner& runner, const PacketSet& ps)
+{
+    auto fr = std::make_shared<FrameReassemblerV2>(MAX_FRAME_SIZE, PAYLOAD_STRIDE);
+
+    for (const char* kind : { "inorder", "reversed", "random", "duplicates" })
+    {
+        auto order = std::make_shared<std::vector<size_t>>(makeOrder(ps.packets.size(), kind));
+
+        bench::Case c;
+        c.name           = std::string("reassembler_v2/push_") + kind;
+        c.ops_per_iter   = order->size();
+        c.bytes_per_iter = ps.frame.size();
+        c.run = [fr, order, &ps]() {
+            fr->startNewFrame(1, ps.count());
+            for (size_t i : *order)
+            {
+                const RxPacket& p = ps.packets[i];
+                fr->pushPacket(p.hdr, p.payload(), false);
+            }
+            bench::doNotOptimize(fr->receivedPackets());
+        };
+        runner.add(std::move(c));
+    }
+
+    // Digest verification cost at emit time (tail chunk + compare)
+    bench::Case c;
+    c.name           = "reassembler_v2/finalize_digest";
+    c.ops_per_iter   = 1;
+    c.setup = [fr, &ps]() {
+        fr->startNewFrame(1, ps.count());
+        for (const RxPacket& p : ps.packets)
+            fr->pushPacket(p.hdr, p.payload(), false);
+    };
+    c.run = [fr]() { bench::doNotOptimize(fr->finalizeDigest()); };
+    runner.add(std::move(c));
+}
+
+/*---------------------------------------------------------------*/
+/* FrameReassemblerManager                                       */
+/*---------------------------------------------------------------*/
+void addManager(bench::Runner& runner, const PacketSet& ps)
+{
+    for (size_t n_frames : { 1u, 4u, 8u })
+    {
+        auto mgr      = std::make_shared<FrameReassemblerManager>(MAX_FRAME_SIZE, PAYLOAD_STRIDE);
+        auto next_id  = std::make_shared<uint32_t>(1);
+        auto emitted  = std::make_shared<uint64_t>(0);
+        auto pkts     = std::make_shared<std::vector<RxPacket>>();
+
+        mgr->onFrameDone = [emitted](const FrameResult&) { (*emitted)++; };
+
+        // N frames interleaved packet by packet (concurrent senders)
+        bench::Case c;
+        c.name           = "manager/concurrent_frames_" + std::to_string(n_frames);
+        c.ops_per_iter   = ps.packets.size() * n_frames;
+        c.bytes_per_iter = ps.frame.size() * n_frames;
+        c.setup = [=, &ps]() {
+            pkts->clear();
+            pkts->reserve(ps.packets.size() * n_frames);
+            for (size_t pid = 0; pid < ps.packets.size(); ++pid)
+            {
+                for (size_t f = 0; f < n_frames; ++f)
+                {
+                    RxPacket p = ps.packets[pid];
+                    p.hdr.frame_id = *next_id + static_cast<uint32_t>(f);
+                    pkts->push_back(p);
+                }
+            }
+            *next_id += static_cast<uint32_t>(n_frames);
+        };
+        c.run = [=]() {
+            for (const RxPacket& p : *pkts)
+                mgr->pushPacket(p, 0);
+            mgr->pollTimers(0);         // emits the completed frames
+            bench::doNotOptimize(*emitted);
+        };
+        runner.add(std::move(c));
+    }
+
+    for (size_t n_frames : { 1u, 8u, 32u })
+    {
+        // Buffer size is irrelevant to timer cost; keep 32 frames affordable
+        auto mgr     = std::make_shared<FrameReassemblerManager>(
+                           ps.packets.size() * PAYLOAD_STRIDE, PAYLOAD_STRIDE);
+        auto next_id = std::make_shared<uint32_t>(1);
+
+        // pollTimers() with N frames in flight, none expiring
+        bench::Case c;
+        c.name         = "manager/poll_timers_inflight_" + std::to_string(n_frames);
+        c.ops_per_iter = 1;
+        c.setup = [=, &ps]() {
+            bool refill = (mgr->inFlight() < n_frames);
+            if (refill)
+                mgr->forceEmitAll(0);
+
+            // New frames, or a duplicate packet to keep them clear of the idle timeout
+            uint32_t first = refill ? *next_id : *next_id - static_cast<uint32_t>(n_frames);
+            for (size_t f = 0; f < n_frames; ++f)
+            {
+                RxPacket p = ps.packets[0];
+                p.hdr.frame_id = first + static_cast<uint32_t>(f);
+                mgr->pushPacket(p, 0);
+            }
+            if (refill)
+                *next_id += static_cast<uint32_t>(n_frames);
+        };
+        c.run = [=]() { mgr->pollTimers(0); };
+        runner.add(std::move(c));
+    }
+}
+
+/*---------------------------------------------------------------*/
+/* Legacy FrameReassembler                                       */
+/*---------------------------------------------------------------*/
+void addLegacy(bench::Runner& runner, const PacketSet& ps)
+{
+    auto fr = std::make_shared<FrameReassembler>();
+
+    bench::Case c;
+    c.name           = "legacy_reassembler/push_pop_inorder";
+    c.ops_per_iter   = ps.packets.size();
+    c.bytes_per_iter = ps.frame.size();
+    c.run = [fr, &ps]() {
+        for (const RxPacket& p : ps.packets)
+            fr->pushPacket(p.hdr, p.payload());
+        auto frame = fr->popFrame();
+        bench::doNotOptimize(frame.size());
+    };
+    runner.add(std::move(c));
+}
+
+/*---------------------------------------------------------------*/
+/* PacketQueue producer / consumer                               */
+/*---------------------------------------------------------------*/
+/* Packet payloads into a frame buffer, as FrameReassemblerV2 does */
+void copyFrame(const PacketSet& ps, uint8_t* dst)
+{
+    for (size_t pid = 0; pid < ps.packets.size(); ++pid)
+    {
+        const RxPacket& p = ps.packets[pid];
+        hv::copy::payload(dst + pid * PAYLOAD_STRIDE, p.payload(), p.hdr.payload_size);
+    }
+    hv::copy::fence();
+}
+
+/* copyFrame() plus the digest of each completed chunk, read back out of dst */
+uint64_t copyFrameDigest(const PacketSet& ps, uint8_t* dst, FrameDigestTracker& dt)
+{
+    dt.reset(MAX_FRAME_SIZE);
+    for (size_t pid = 0; pid < ps.packets.size(); ++pid)
+    {
+        const RxPacket& p = ps.packets[pid];
+        hv::copy::payload(dst + pid * PAYLOAD_STRIDE, p.payload(), p.hdr.payload_size);
+        dt.onBytes(dst, pid * PAYLOAD_STRIDE, p.hdr.payload_size);
+    }
+    hv::copy::fence();
+    dt.finalize(dst, ps.frame.size(), true);
+    return dt.digest();
+}
+
+/*
+ * Worker hot state (bitmaps, map nodes, queue slots) modelled as a 1 MB
+ * random pointer chase.  Per round: warm it, copy one frame, then time
+ * one pass.  memcpy evicts it from L1/L2; non-temporal stores should not.
+ */
+bench::Result runHotState(const PacketSet& ps, hv::copy::Mode mode, uint8_t* dst)
+{
+    constexpr size_t LINES  = (1u << 20) / 64;
+    constexpr int    ROUNDS = 20;
+
+    struct alignas(64) Line { uint32_t next; uint8_t pad[60]; };
+    std::vector<Line> hot(LINES);
+
+    std::vector<uint32_t> perm(LINES);
+    std::iota(perm.begin(), perm.end(), 0u);
+    std::shuffle(perm.begin() + 1, perm.end(), std::mt19937(7));
+    for (size_t i = 0; i < LINES; ++i)
+        hot[perm[i]].next = perm[(i + 1) % LINES];
+
+    auto chase = [&hot]() {
+        uint32_t at = 0;
+        for (size_t i = 0; i < LINES; ++i)
+            at = hot[at].next;
+        bench::doNotOptimize(at);
+    };
+
+    hv::copy::configure(hv::copy::Config{mode, 0}, MAX_FRAME_SIZE);
+
+    std::vector<double> samples;
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        chase();
+        copyFrame(ps, dst);
+
+        uint64_t t0 = bench::nowNs();
+        chase();
+        samples.push_back(static_cast<double>(bench::nowNs() - t0));
+    }
+    std::sort(samples.begin(), samples.end());
+    hv::copy::configure(hv::copy::Config{}, MAX_FRAME_SIZE);
+
+    bench::Result res;
+    res.iterations  = ROUNDS;
+    res.ops         = LINES * ROUNDS;
+    res.total_ns    = std::accumulate(samples.begin(), samples.end(), 0.0);
+    res.ns_per_op   = res.total_ns / res.ops;
+    res.ops_per_sec = res.ops / (res.total_ns / 1e9);
+    res.iter_min_ns = samples.front();
+    res.iter_p50_ns = samples[samples.size() / 2];
+    res.iter_p99_ns = samples.back();
+    return res;
+}
+
+bench::Result runQueue(const PacketSet& ps, uint64_t n_packets)
+{
+    PacketQueue queue(MAX_QUEUE_SIZE);
+    std::atomic<bool> done{false};
+    uint64_t consumed = 0;
+
+    uint64_t t0 = bench::nowNs();
+
+    std::thread consumer([&]() {
+        std::unique_ptr<RxPacket> pkt;
+        while (true)
+        {
+            if (queue.pop_until(pkt, std::chrono::milliseconds(1), done))
+            {
+                consumed++;
+                bench::doNotOptimize(pkt->hdr.packet_id);
+                continue;
+            }
+            if (done.load() && queue.empty())
+                break;
+        }
+    });
+
+    for (uint64_t i = 0; i < n_packets; ++i)
+    {
+        // Same work as udp_rx_thread: allocate, copy header + payload, push
+        const RxPacket& src = ps.packets[i % ps.packets.size()];
+        std::unique_ptr<RxPacket> pkt(new RxPacket);
+        std::memcpy(&pkt->hdr, &src.hdr, sizeof(UdpPacketHeader));
+        std::memcpy(pkt->reservePayload(src.hdr.payload_size), src.payload(), src.hdr.payload_size);
+        queue.push(std::move(pkt));
+    }
+    done.store(true);
+    consumer.join();
+
+    uint64_t dt = bench::nowNs() - t0;
+
+    bench::Result r;
+    r.iterations    = 1;
+    r.ops           = n_packets;
+    r.total_ns      = static_cast<double>(dt);
+    r.ns_per_op     = r.total_ns / n_packets;
+    r.ops_per_sec   = n_packets / (r.total_ns / 1e9);
+    r.bytes_per_sec = r.ops_per_sec * PAYLOAD_STRIDE;
+    r.iter_min_ns = r.iter_p50_ns = r.iter_p99_ns = r.total_ns;
+    r.extra.emplace_back("dropped", static_cast<double>(queue.dropped()));
+    r.extra.emplace_back("consumed", static_cast<double>(consumed));
+    return r;
+}
+
+/*---------------------------------------------------------------*/
+/* write_frame_to_file                                           */
+/*---------------------------------------------------------------*/
+void addWriter(bench::Runner& runner, const PacketSet& ps)
+{
+    bench::Case c;
+    c.name           = "writer/write_frame_to_file";
+    c.ops_per_iter   = 1;
+    c.bytes_per_iter = ps.frame.size() * 2;     // frame + raw copy (+ header)
+    c.quiet_stderr   = true;
+    c.run = [&ps]() {
+        write_frame_to_file(ps.frame.data(), ps.frame.size(), false);
+    };
+    runner.add(std::move(c));
+}
+
+/*---------------------------------------------------------------*/
+/* Frame digest                                                  */
+/*---------------------------------------------------------------*/
+void addDigest(bench::Runner& runner, const PacketSet& ps)
+{
+    bench::Case c;
+    c.name           = "digest/frame_digest_compute";
+    c.ops_per_iter   = 1;
+    c.bytes_per_iter = ps.frame.size();
+    c.run = [&ps]() {
+        bench::doNotOptimize(frame_digest_compute(ps.frame.data(), ps.frame.size()));
+    };
+    runner.add(std::move(c));
+}
+
+/*---------------------------------------------------------------*/
+/* Payload copy kernels                                          */
+/*---------------------------------------------------------------*/
+void addCopy(bench::Runner& runner, const PacketSet& ps)
+{
+    auto dst = std::make_shared<std::vector<uint8_t>>(MAX_FRAME_SIZE);
+
+    for (hv::copy::Mode mode : { hv::copy::Mode::LIBC, hv::copy::Mode::STREAM })
+    {
+        std::string name = hv::copy::modeName(mode);
+
+        bench::Case c;
+        c.name           = "copy/frame_" + name;
+        c.ops_per_iter   = ps.packets.size();
+        c.bytes_per_iter = ps.frame.size();
+        c.setup = [mode]() { hv::copy::configure(hv::copy::Config{mode, 0}, MAX_FRAME_SIZE); };
+        c.run   = [dst, &ps]() {
+            copyFrame(ps, dst->data());
+            bench::doNotOptimize(dst->data());
+        };
+        runner.add(std::move(c));
+
+        // Digest hashed back out of the frame buffer, as for FRAME_FLAG_DIGEST frames
+        auto dt = std::make_shared<FrameDigestTracker>();
+
+        bench::Case cd;
+        cd.name           = "copy/frame_" + name + "_digest";
+        cd.ops_per_iter   = ps.packets.size();
+        cd.bytes_per_iter = ps.frame.size();
+        cd.setup = [mode]() { hv::copy::configure(hv::copy::Config{mode, 0}, MAX_FRAME_SIZE); };
+        cd.run   = [dst, dt, &ps]() {
+            bench::doNotOptimize(copyFrameDigest(ps, dst->data(), *dt));
+        };
+        runner.add(std::move(cd));
+
+        // What one frame copy costs the worker's hot state afterwards
+        runner.addCustom("copy/hot_state_after_" + name, [mode, dst, &ps]() {
+            return runHotState(ps, mode, dst->data());
+        });
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    bench::Options opt;
+    std::string out_dir = "/tmp/tm_bench";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+            opt.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc)
+            opt.min_time_s = std::stod(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            opt.json_path = argv[++i];
+        else if (arg == "--out-dir" && i + 1 < argc)
+            out_dir = argv[++i];
+        else
+        {
+            std::cerr << "Usage: tm_bench [--filter substr] [--min-time sec]"
+                         " [--json path] [--out-dir dir]\n";
+            return -1;
+        }
+    }
+
+    // Keep the code under test quiet; logging has its own cost profile
+    hv::debug::init();
+    hv::debug::setLevel(hv::debug::Level::Error);
+
+    // write_frame_to_file writes into the current directory
+    mkdir(out_dir.c_str(), 0755);
+    if (chdir(out_dir.c_str()) != 0)
+    {
+        perror("chdir(out_dir)");
+        return -1;
+    }
+
+    PacketSet ps;
+    ps.build(1);
+
+    bench::Runner runner(opt);
+
+    addReassemblerV2(runner, ps);
+    addManager(runner, ps);
+    addLegacy(runner, ps);
+    addWriter(runner, ps);
+    addDigest(runner, ps);
+    addCopy(runner, ps);
+
+    runner.addCustom("packet_queue/spsc_push_pop", [&ps]() {
+        return runQueue(ps, 500000);
+    });
+
+    return runner.runAll();
+}
@@ -0,0 +1,181 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Buffer Pool                               */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <cstring>
+
+#include "common/frame_buffer_pool.hpp"
+
+
+namespace {
+
+FrameBuffer* newBuffer(size_t capacity, bool touch)
+{
+    auto* b = new FrameBuffer;
+    b->capacity = capacity;
+    b->data.reset(new uint8_t[capacity]);
+
+    // Fault the pages in now rather than on the first frame
+    if (touch)
+        std::memset(b->data.get(), 0, capacity);
+    return b;
+}
+
+} // namespace
+
+
+/*-------------------------------------------*/
+/* FrameHandle                               */
+/*-------------------------------------------*/
+FrameHandle FrameHandle::allocate(size_t capacity)
+{
+    return FrameHandle(newBuffer(capacity, false));
+}
+
+void FrameHandle::reset()
+{
+    if (!buf_)
+        return;
+
+    FrameBuffer* b = buf_;
+    buf_ = nullptr;
+
+    if (b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    // Last reference: back to the pool, or freed if there is none (any more)
+    if (b->home)
+    {
+        std::shared_ptr<FramePoolCore> core = b->home;
+        {
+            std::lock_guard<std::mutex> lk(core->mtx);
+            bool keep = !core->closed
+                     && b->capacity == core->buffer_size
+                     && (core->max_buffers == 0 || core->allocated <= core->max_buffers);
+            if (keep)
+            {
+                core->free.push_back(b);
+                return;
+            }
+            core->allocated--;
+        }
+        b->home.reset();
+    }
+    delete b;
+}
+
+
+/*-------------------------------------------*/
+/* FrameBufferPool                           */
+/*-------------------------------------------*/
+FrameBufferPool::FrameBufferPool(size_t buffer_size, size_t max_buffers, size_t prealloc)
+    : core_(std::make_shared<FramePoolCore>())
+{
+    core_->buffer_size = buffer_size;
+    core_->max_buffers = max_buffers;
+
+    if (max_buffers && prealloc > max_buffers)
+        prealloc = max_buffers;
+
+    for (size_t i = 0; i < prealloc; ++i)
+    {
+        FrameBuffer* b = newBuffer(buffer_size, true);
+        b->home = core_;
+        core_->free.push_back(b);
+        core_->allocated++;
+    }
+}
+
+FrameBufferPool::~FrameBufferPool()
+{
+    std::vector<FrameBuffer*> free;
+    {
+        std::lock_guard<std::mutex> lk(core_->mtx);
+        core_->closed = true;
+        free.swap(core_->free);
+        core_->allocated -= free.size();
+    }
+
+    // Buffers still held by consumers are freed on their last release
+    for (FrameBuffer* b : free)
+    {
+        b->home.reset();
+        delete b;
+    }
+}
+
+FrameHandle FrameBufferPool::acquire()
+{
+    FrameBuffer* b = nullptr;
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lk(core_->mtx);
+        size = core_->buffer_size;
+        if (!core_->free.empty())
+        {
+            b = core_->free.back();
+            core_->free.pop_back();
+        }
+        else if (core_->max_buffers == 0 || core_->allocated < core_->max_buffers)
+        {
+            core_->allocated++;
+        }
+        else
+        {
+            return FrameHandle();
+        }
+    }
+
+    if (!b)
+    {
+        b = newBuffer(size, false);
+        b->home = core_;
+    }
+    return FrameHandle(b);
+}
+
+void FrameBufferPool::resize(size_t buffer_size, size_t max_buffers)
+{
+    std::vector<FrameBuffer*> drop;
+    {
+        std::lock_guard<std::mutex> lk(core_->mtx);
+        core_->buffer_size = buffer_size;
+        core_->max_buffers = max_buffers;
+
+        // Only free buffers: the ones in use are checked again on release
+        std::vector<FrameBuffer*> keep;
+        for (FrameBuffer* b : core_->free)
+        {
+            bool fits = b->capacity == buffer_size
+                     && (max_buffers == 0 || core_->allocated - drop.size() <= max_buffers);
+            (fits ? keep : drop).push_back(b);
+        }
+        core_->free.swap(keep);
+        core_->allocated -= drop.size();
+    }
+
+    for (FrameBuffer* b : drop)
+    {
+        b->home.reset();
+        delete b;
+    }
+}
+
+size_t FrameBufferPool::bufferSize() const
+{
+    std::lock_guard<std::mutex> lk(core_->mtx);
+    return core_->buffer_size;
+}
+
+size_t FrameBufferPool::allocated() const
+{
+    std::lock_guard<std::mutex> lk(core_->mtx);
+    return core_->allocated;
+}
+
+size_t FrameBufferPool::available() const
+{
+    std::lock_guard<std::mutex> lk(core_->mtx);
+    return core_->free.size();
+}
@@ -0,0 +1,346 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Chunk Codecs                              */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <cstring>
+
+#include "common/frame_codec.hpp"
+
+#ifdef HV_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+bool parseFrameCodec(const char* s, FrameCodec& out)
+{
+    if (std::strcmp(s, "none") == 0)
+        out = FrameCodec::NONE;
+    else if (std::strcmp(s, "lz4") == 0)
+        out = FrameCodec::LZ4;
+    else if (std::strcmp(s, "zstd") == 0)
+        out = FrameCodec::ZSTD;
+    else
+        return false;
+    return true;
+}
+
+const char* frameCodecName(FrameCodec c)
+{
+    switch (c)
+    {
+    case FrameCodec::NONE: return "none";
+    case FrameCodec::LZ4:  return "lz4";
+    case FrameCodec::ZSTD: return "zstd";
+    }
+    return "unknown";
+}
+
+bool frameCodecAvailable(FrameCodec c)
+{
+#ifdef HV_HAVE_ZSTD
+    (void)c;
+    return true;
+#else
+    return c != FrameCodec::ZSTD;
+#endif
+}
+
+size_t frameCodecBound(FrameCodec c, size_t n)
+{
+#ifdef HV_HAVE_ZSTD
+    if (c == FrameCodec::ZSTD)
+        return ZSTD_compressBound(n);
+#endif
+    (void)c;
+    return n + n / 255 + 16;            // LZ4 worst case
+}
+
+size_t frameCodecCompress(FrameCodec c, int level,
+                          const uint8_t* src, size_t n,
+                          uint8_t* dst, size_t cap)
+{
+    (void)level;
+    size_t out = 0;
+
+    switch (c)
+    {
+    case FrameCodec::LZ4:
+        out = lz4CompressBlock(src, n, dst, cap);
+        break;
+    case FrameCodec::ZSTD:
+#ifdef HV_HAVE_ZSTD
+        {
+            // One context per thread, reused across chunks
+            thread_local ZSTD_CCtx* cctx = ZSTD_createCCtx();
+            size_t r = ZSTD_compressCCtx(cctx, dst, cap, src, n, level ? level : 3);
+            out = ZSTD_isError(r) ? 0 : r;
+        }
+#endif
+        break;
+    case FrameCodec::NONE:
+        break;
+    }
+
+    return (out && out < n) ? out : 0;
+}
+
+bool frameCodecDecompress(FrameCodec c,
+                          const uint8_t* src, size_t n,
+                          uint8_t* dst, size_t out_n)
+{
+    switch (c)
+    {
+    case FrameCodec::LZ4:
+    {
+        size_t got = 0;
+        return lz4DecompressBlock(src, n, dst, out_n, &got) && got == out_n;
+    }
+    case FrameCodec::ZSTD:
+#ifdef HV_HAVE_ZSTD
+    {
+        size_t r = ZSTD_decompress(dst, out_n, src, n);
+        return !ZSTD_isError(r) && r == out_n;
+    }
+#else
+        return false;
+#endif
+    case FrameCodec::NONE:
+        if (n != out_n)
+            return false;
+        std::memcpy(dst, src, n);
+        return true;
+    }
+    return false;
+}
+
+
+/*-------------------------------------------*/
+/* LZ4 block format                          */
+/*-------------------------------------------*/
+namespace {
+
+constexpr int      HASH_BITS    = 14;
+constexpr size_t   MIN_MATCH    = 4;
+constexpr size_t   LAST_LITERALS = 5;   // format: the block ends with >= 5 literals
+constexpr size_t   MF_LIMIT     = 12;   // ... and no match starts in the last 12 bytes
+constexpr size_t   MAX_OFFSET   = 65535;
+
+inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash4(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Common prefix length of a and b, a not beyond limit (little endian)
+inline size_t matchLength(const uint8_t* a, const uint8_t* b, const uint8_t* limit)
+{
+    const uint8_t* start = a;
+    while (a + 8 <= limit)
+    {
+        uint64_t diff = read64(a) ^ read64(b);
+        if (diff)
+            return static_cast<size_t>(a - start) + (__builtin_ctzll(diff) >> 3);
+        a += 8;
+        b += 8;
+    }
+    while (a < limit && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return static_cast<size_t>(a - start);
+}
+
+inline uint8_t* putLength(uint8_t* op, size_t len)
+{
+    while (len >= 255)
+    {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<uint8_t>(len);
+    return op;
+}
+
+} // namespace
+
+size_t lz4CompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t cap)
+{
+    thread_local uint32_t table[1u << HASH_BITS];
+    std::memset(table, 0, sizeof(table));
+
+    const uint8_t* ip     = src;
+    const uint8_t* anchor = src;
+    const uint8_t* const end = src + n;
+    uint8_t*       op     = dst;
+    uint8_t* const oend   = dst + cap;
+
+    if (n > MF_LIMIT)
+    {
+        const uint8_t* const mf_limit    = end - MF_LIMIT;
+        const uint8_t* const match_limit = end - LAST_LITERALS;
+
+        while (ip < mf_limit)
+        {
+            uint32_t seq = read32(ip);
+            uint32_t h   = hash4(seq);
+            const uint8_t* ref = src + table[h];
+            table[h] = static_cast<uint32_t>(ip - src);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != seq)
+            {
+                // Skip faster through data that does not match
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+                continue;
+            }
+
+            // Extend backwards over pending literals, then forwards
+            while (ip > anchor && ref > src && ip[-1] == ref[-1])
+            {
+                ip--;
+                ref--;
+            }
+            size_t mlen = MIN_MATCH + matchLength(ip + MIN_MATCH, ref + MIN_MATCH, match_limit);
+            size_t lit  = static_cast<size_t>(ip - anchor);
+
+            if (static_cast<size_t>(oend - op) < 1 + lit + lit / 255 + 1 + 2 + mlen / 255 + 1)
+                return 0;
+
+            uint8_t* token = op++;
+            if (lit >= 15)
+            {
+                *token = 15 << 4;
+                op = putLength(op, lit - 15);
+            }
+            else
+            {
+                *token = static_cast<uint8_t>(lit << 4);
+            }
+            std::memcpy(op, anchor, lit);
+            op += lit;
+
+            uint16_t off = static_cast<uint16_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(off);
+            *op++ = static_cast<uint8_t>(off >> 8);
+
+            size_t ml = mlen - MIN_MATCH;
+            if (ml >= 15)
+            {
+                *token |= 15;
+                op = putLength(op, ml - 15);
+            }
+            else
+            {
+                *token |= static_cast<uint8_t>(ml);
+            }
+
+            ip    += mlen;
+            anchor = ip;
+
+            if (ip < mf_limit)
+                table[hash4(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+        }
+    }
+
+    // Last literals
+    size_t lit = static_cast<size_t>(end - anchor);
+    if (static_cast<size_t>(oend - op) < 1 + lit + lit / 255 + 1)
+        return 0;
+
+    uint8_t* token = op++;
+    if (lit >= 15)
+    {
+        *token = 15 << 4;
+        op = putLength(op, lit - 15);
+    }
+    else
+    {
+        *token = static_cast<uint8_t>(lit << 4);
+    }
+    std::memcpy(op, anchor, lit);
+    op += lit;
+
+    return static_cast<size_t>(op - dst);
+}
+
+bool lz4DecompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t cap, size_t* out_n)
+{
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src + n;
+    uint8_t*       op   = dst;
+    uint8_t* const oend = dst + cap;
+
+    auto readLength = [&](size_t& len) -> bool
+    {
+        uint8_t b;
+        do
+        {
+            if (ip >= iend)
+                return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend)
+    {
+        uint8_t token = *ip++;
+
+        size_t lit = token >> 4;
+        if (lit == 15 && !readLength(lit))
+            return false;
+        if (lit > static_cast<size_t>(iend - ip) || lit > static_cast<size_t>(oend - op))
+            return false;
+        std::memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+
+        if (ip == iend)
+            break;                          // last sequence: literals only
+
+        if (iend - ip < 2)
+            return false;
+        size_t off = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (off == 0 || off > static_cast<size_t>(op - dst))
+            return false;
+
+        size_t ml = token & 15;
+        if (ml == 15 && !readLength(ml))
+            return false;
+        ml += MIN_MATCH;
+        if (ml > static_cast<size_t>(oend - op))
+            return false;
+
+        const uint8_t* m = op - off;
+        if (off >= ml)
+        {
+            std::memcpy(op, m, ml);
+            op += ml;
+        }
+        else
+        {
+            // Overlapping copy repeats the last off bytes
+            for (size_t i = 0; i < ml; ++i)
+                *op++ = m[i];
+        }
+    }
+
+    *out_n = static_cast<size_t>(op - dst);
+    return true;
+}
@@ -0,0 +1,291 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                          frame_digest.cpp                                 */
+/*                                                                           */
+/*  Fast non-cryptographic frame digest implementation                       */
+/*  Created on: 2026-01-10                                                   */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "common/frame_digest.hpp"
+#include "protocol/frame_header.hpp"
+#include "protocol/protocol_constants.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+constexpr uint64_t PRIME32_1 = 0x9E3779B1u;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+
+constexpr size_t LANES            = 8;                    // 8 x u64 = 64-byte stripe
+constexpr size_t STRIPE_LEN       = LANES * sizeof(uint64_t);
+constexpr size_t STRIPES_PER_BLK  = 16;                   // scramble every 1 KiB
+constexpr size_t SECRET_WORDS     = STRIPES_PER_BLK + LANES;
+
+/* splitmix64 => deterministic secret, identical on sender and receiver */
+constexpr uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+struct Secret
+{
+    uint64_t w[SECRET_WORDS];
+
+    constexpr Secret() : w{}
+    {
+        for (size_t i = 0; i < SECRET_WORDS; ++i)
+            w[i] = splitmix64(0xCC1210B2ull + i);
+    }
+};
+
+constexpr Secret kSecret{};
+
+inline uint64_t mul128_fold64(uint64_t a, uint64_t b)
+{
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t avalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+/* One 64-byte stripe: plain lane loop so -O3 emits SSE2/AVX2/NEON */
+inline void accumulate_stripe(uint64_t* __restrict acc,
+                              const uint8_t* __restrict p,
+                              const uint64_t* __restrict key)
+{
+    uint64_t data[LANES];
+    std::memcpy(data, p, STRIPE_LEN);
+
+    for (size_t i = 0; i < LANES; ++i)
+    {
+        uint64_t dk = data[i] ^ key[i];
+        acc[i ^ 1] += data[i];
+        acc[i]     += (dk & 0xFFFFFFFFu) * (dk >> 32);
+    }
+}
+
+inline void scramble(uint64_t* acc, const uint64_t* key)
+{
+    for (size_t i = 0; i < LANES; ++i)
+    {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= key[i];
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+} // namespace
+
+
+/*-------------------------------------------*/
+/* 64-bit stripe hash                        */
+/*-------------------------------------------*/
+uint64_t frame_digest_hash64(const uint8_t* data, size_t len, uint64_t seed)
+{
+    uint64_t key[SECRET_WORDS];
+    for (size_t i = 0; i < SECRET_WORDS; ++i)
+        key[i] = kSecret.w[i] + ((i & 1) ? 0 - seed : seed);
+
+    uint64_t acc[LANES] = {
+        PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_1 ^ seed,
+        PRIME64_2 ^ seed, PRIME32_1 ^ seed, PRIME64_1 + seed, PRIME64_2 + seed
+    };
+
+    const size_t full_stripes = len / STRIPE_LEN;
+    size_t s = 0;
+
+    for (; s < full_stripes; ++s)
+    {
+        size_t in_blk = s % STRIPES_PER_BLK;
+        accumulate_stripe(acc, data + s * STRIPE_LEN, key + in_blk);
+
+        if (in_blk == STRIPES_PER_BLK - 1)
+            scramble(acc, key + STRIPES_PER_BLK);
+    }
+
+    // Tail: zero-padded last stripe
+    size_t tail = len - full_stripes * STRIPE_LEN;
+    if (tail)
+    {
+        uint8_t last[STRIPE_LEN] = {0,};
+        std::memcpy(last, data + full_stripes * STRIPE_LEN, tail);
+        accumulate_stripe(acc, last, key + (s % STRIPES_PER_BLK));
+    }
+
+    uint64_t h = static_cast<uint64_t>(len) * PRIME64_1;
+    for (size_t i = 0; i < LANES; i += 2)
+        h += mul128_fold64(acc[i] ^ key[i + 1], acc[i + 1] ^ key[i + 2]);
+
+    return avalanche(h);
+}
+
+
+/*-------------------------------------------*/
+/* Digest of a whole contiguous frame        */
+/*-------------------------------------------*/
+uint64_t frame_digest_compute(const uint8_t* data, size_t len)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+
+    uint64_t sum = 0;
+    for (size_t c = 0; c * CH < len; ++c)
+    {
+        size_t n = std::min(CH, len - c * CH);
+        sum += frame_digest_hash64(data + c * CH, n, c);
+    }
+
+    return avalanche(sum ^ (static_cast<uint64_t>(len) * PRIME64_2));
+}
+
+
+/*-------------------------------------------*/
+/* FrameDigestTracker                        */
+/*-------------------------------------------*/
+void FrameDigestTracker::reset(size_t capacity)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+    size_t chunks = (capacity + CH - 1) / CH;
+
+    chunk_fill_.assign(chunks, 0);
+    chunk_hashed_.assign(chunks, false);
+
+    covered_len_ = 0;
+    header_seen_ = false;
+    has_digest_  = false;
+    sum_         = 0;
+    state_       = FrameDigestState::ABSENT;
+    digest_      = 0;
+}
+
+void FrameDigestTracker::parseHeader(const uint8_t* frame)
+{
+    FrameHeader hdr;
+    std::memcpy(&hdr, frame, sizeof(hdr));
+
+    header_seen_ = true;
+
+    if (hdr.magic != protocol::FRAME_MAGIC
+        || (hdr.flags & protocol::FRAME_FLAG_DIGEST) == 0)
+        return;
+
+    size_t covered = sizeof(FrameHeader) + static_cast<size_t>(hdr.frame_size);
+    if (covered + sizeof(FrameTrailer)
+            > chunk_fill_.size() * protocol::DIGEST_CHUNK_SIZE)
+        return;     // does not fit the frame buffer => cannot be verified
+
+    has_digest_  = true;
+    covered_len_ = covered;
+}
+
+void FrameDigestTracker::hashChunk(const uint8_t* frame, size_t chunk)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+
+    size_t begin = chunk * CH;
+    size_t n     = std::min(CH, covered_len_ - begin);
+
+    sum_ += frame_digest_hash64(frame + begin, n, chunk);
+    chunk_hashed_[chunk] = true;
+}
+
+// Hash every filled chunk that lies entirely within the covered region
+void FrameDigestTracker::sweepPending(const uint8_t* frame)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+
+    for (size_t c = 0; c < chunk_fill_.size() && (c + 1) * CH <= covered_len_; ++c)
+    {
+        if (!chunk_hashed_[c] && chunk_fill_[c] == CH)
+            hashChunk(frame, c);
+    }
+}
+
+void FrameDigestTracker::onBytes(const uint8_t* frame, size_t offset, size_t len)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+
+    if (len == 0 || offset + len > chunk_fill_.size() * CH)
+        return;
+
+    size_t first = offset / CH;
+    size_t last  = (offset + len - 1) / CH;
+
+    for (size_t c = first; c <= last; ++c)
+    {
+        size_t lo = std::max(offset, c * CH);
+        size_t hi = std::min(offset + len, (c + 1) * CH);
+        chunk_fill_[c] += static_cast<uint32_t>(hi - lo);
+    }
+
+    if (!header_seen_)
+    {
+        if (offset == 0 && len >= sizeof(FrameHeader))
+        {
+            parseHeader(frame);
+            if (has_digest_)
+                sweepPending(frame);
+        }
+        return;
+    }
+
+    if (!has_digest_)
+        return;
+
+    // Chunks completed by this packet; data is still hot in cache
+    for (size_t c = first; c <= last; ++c)
+    {
+        if (!chunk_hashed_[c]
+            && chunk_fill_[c] == CH
+            && (c + 1) * CH <= covered_len_)
+            hashChunk(frame, c);
+    }
+}
+
+FrameDigestState FrameDigestTracker::finalize(const uint8_t* frame,
+                                              size_t frame_size,
+                                              bool frame_complete)
+{
+    constexpr size_t CH = protocol::DIGEST_CHUNK_SIZE;
+
+    if (!header_seen_ && frame_size >= sizeof(FrameHeader))
+        parseHeader(frame);
+
+    if (!has_digest_)
+        return state_ = FrameDigestState::ABSENT;
+
+    if (!frame_complete
+        || frame_size < covered_len_ + sizeof(FrameTrailer))
+        return state_ = FrameDigestState::UNVERIFIED;
+
+    FrameTrailer tr;
+    std::memcpy(&tr, frame + covered_len_, sizeof(tr));
+
+    if (tr.magic != protocol::TRAILER_MAGIC || tr.chunk_size != CH)
+        return state_ = FrameDigestState::UNVERIFIED;
+
+    for (size_t c = 0; c * CH < covered_len_; ++c)
+    {
+        if (!chunk_hashed_[c])
+            hashChunk(frame, c);
+    }
+
+    digest_ = avalanche(sum_ ^ (static_cast<uint64_t>(covered_len_) * PRIME64_2));
+
+    state_ = (digest_ == tr.digest) ? FrameDigestState::VERIFIED
+                                    : FrameDigestState::MISMATCH;
+    return state_;
+}
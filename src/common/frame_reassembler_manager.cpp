@@ -10,17 +10,60 @@
 #include "common/frame_writer.hpp"
 #include "common/frame_reassembler_manager.hpp"
 #include "common/frame_result.hpp"
+#include "common/payload_copy.hpp"
+#include "protocol/frame_header.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 #include "debug/debug_log.hpp"
 #include "debug/debug_stats.hpp"
+#include "debug/debug_histogram.hpp"
 #include "debug/hv_debug.hpp"
+#include "debug/flight_recorder.hpp"
 
 
 FrameReassemblerManager::FrameReassemblerManager(size_t max_frame_size,
-                                                 size_t payload_stride)
+                                                 size_t payload_stride,
+                                                 size_t max_buffers)
     : max_frame_size_(max_frame_size),
-      payload_stride_(payload_stride)
+      payload_stride_(payload_stride),
+      pool_(max_frame_size, max_buffers),
+      idle_timeout_(FRAME_IDLE_TIMEOUT),
+      lifetime_(MAX_FRAME_LIFETIME)
+{
+}
+
+void FrameReassemblerManager::setTimeouts(std::chrono::milliseconds idle,
+                                          std::chrono::milliseconds lifetime)
+{
+    idle_fixed_     = idle.count() > 0;
+    idle_timeout_   = idle_fixed_ ? idle : FRAME_IDLE_TIMEOUT;
+    lifetime_fixed_ = lifetime.count() > 0;
+    lifetime_       = lifetime_fixed_ ? lifetime : MAX_FRAME_LIFETIME;
+}
+
+void FrameReassemblerManager::reconfigure(size_t max_frame_size,
+                                          size_t payload_stride,
+                                          size_t max_buffers)
+{
+    max_frame_size_ = max_frame_size;
+    payload_stride_ = payload_stride;
+    pool_.resize(max_frame_size, max_buffers);
+}
+
+std::chrono::nanoseconds FrameReassemblerManager::idleDeadline() const
+{
+    if (idle_fixed_ || !estimator_.ready())
+        return idle_timeout_;
+    return estimator_.idle();
+}
+
+std::chrono::nanoseconds FrameReassemblerManager::lifetimeDeadline() const
 {
+    if (lifetime_fixed_ || !estimator_.ready())
+        return lifetime_;
+    return estimator_.lifetime();
 }
 
 bool FrameReassemblerManager::empty() const
@@ -34,49 +77,226 @@ bool FrameReassemblerManager::empty() const
 /*-------------------------------------------*/
 void FrameReassemblerManager::pushPacket(const RxPacket& pkt, size_t queue_drop_count)
 {
-    uint32_t frame_id = pkt.hdr.frame_id;
+    pushPacket(pkt.hdr, pkt.payload(), pkt.gap_before, queue_drop_count, pkt.kernel_drops);
+}
+
+void FrameReassemblerManager::pushPacket(const UdpPacketHeader& hdr,
+                                         const uint8_t* payload,
+                                         bool gap_before,
+                                         size_t queue_drop_count,
+                                         uint32_t kernel_drops)
+{
+    // No FEC decoder: parity packets carry no frame data
+    if (hdr.flags & protocol::PKT_FLAG_PARITY)
+        return;
+
+    uint32_t frame_id = hdr.frame_id;
     auto now = std::chrono::steady_clock::now();
 
     auto it = frames_.find(frame_id);
+    bool adaptive = estimator_.config().adaptive;
 
     if (it == frames_.end())
     {
-        FrameEntry entry(max_frame_size_, payload_stride_);
-        entry.reassembler.startNewFrame(frame_id, pkt.hdr.packet_count);
+        if (Emitted* e = recentlyEmitted(frame_id, now))
+        {
+            // Tail of a cut frame: the deadline was too short for this link
+            if (e->cut)
+            {
+                if (adaptive)
+                    estimator_.onCutTail(
+                        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            now - e->first).count()),
+                        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            now - e->last).count()));
+                e->last = now;
+                e->at   = now;
+            }
+
+            hv::stats::add(hv::stats::LATE_PACKETS);
+            HV_LOGD(hv::debug::Module::FRAME, "[LATE] frame=%u pid=%u already emitted",
+                    frame_id, hdr.packet_id);
+            return;
+        }
+
+        // 32-bit packet counts (v2): reject frames that cannot fit the frame buffer
+        size_t stride = hdr.payload_stride ? hdr.payload_stride : payload_stride_;
+        if (hdr.packet_count == 0
+            || static_cast<size_t>(hdr.packet_count - 1) * stride >= max_frame_size_)
+        {
+            HV_LOGW_RL(hv::debug::Module::FRAME, 10, 20,
+                       "[SIZE ] frame=%u packets=%u stride=%zu exceeds %zu bytes",
+                       frame_id, hdr.packet_count, stride, max_frame_size_);
+            return;
+        }
+
+        FrameEntry entry(max_frame_size_, payload_stride_, &pool_);
+        if (!entry.reassembler.startNewFrame(frame_id, hdr.packet_count, hdr.payload_stride))
+        {
+            // Every buffer is in flight or still held by a consumer
+            hv::stats::add(hv::stats::BUFFER_EXHAUSTED);
+            HV_LOGW_RL(hv::debug::Module::FRAME, 1, 5,
+                       "[POOL] frame=%u no free frame buffer (%zu allocated)",
+                       frame_id, pool_.allocated());
+            return;
+        }
         entry.first_packet_time = now;
         entry.last_update = now;
 
         entry.queue_drop_at_start = queue_drop_count;
 
         it = frames_.emplace(frame_id, std::move(entry)).first;
+
+        hv::stats::add(hv::stats::FRAMES_STARTED);
+        hv::trace::record(hv::trace::EV_FRAME_START, frame_id, 0, hdr.packet_count);
+        hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(frames_.size()));
+
+        if (adaptive)
+            estimator_.onFrameStart(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()));
+    }
+    else if (adaptive)
+    {
+        // Intra-frame gap only: the pause between frames is not an idle frame
+        estimator_.onPacketGap(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - it->second.last_update).count()));
     }
 
     FrameEntry& entry = it->second;
     FrameReassemblerV2& fr = entry.reassembler;
 
-    fr.pushPacket(pkt.hdr, pkt.payload, pkt.gap_before);
+    fr.pushPacket(hdr, payload, gap_before);
     entry.last_update = now;
+    entry.kernel_drops += kernel_drops;
 
     #ifdef HV_DEBUG_ENABLED
     HV_LOGI(hv::debug::Module::FRAME, "[RX ] frame=%u pkt=%u/%u gap=%u",
                         frame_id,
-                        pkt.hdr.packet_id,
-                        pkt.hdr.packet_count,
-                        pkt.gap_before);    
+                        hdr.packet_id,
+                        hdr.packet_count,
+                        gap_before);    
     #endif
 
-#ifdef DEBUG_LOG_ENABLE
-	{
-	    debug_log::PacketTraceEntry te{};
-	    te.frame_id = fr.frameId();
-	    te.packet_id = fr.receivedPackets();
-	    te.packet_count = fr.expectedPackets();
-		te.payload_size = pkt.hdr.payload_size;
-	    te.flags = 3;
-
-	    debug_log::trace_packet(te);
-	}
-#endif
+    if (band_rows_ && onFrameBand && !entry.bands_off)
+        publishBands(entry);
+
+    // Last packet in: emit now instead of on the next pollTimers tick
+    if (fr.receivedPackets() == fr.expectedPackets())
+    {
+        if (adaptive)
+            onFrameSpan(entry);
+
+        emitFrame(entry, FrameState::COMPLETE, queue_drop_count);
+        frames_.erase(it);
+        hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(frames_.size()));
+    }
+}
+
+
+void FrameReassemblerManager::onFrameSpan(const FrameEntry& entry)
+{
+    estimator_.onFrameComplete(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            entry.last_update - entry.first_packet_time).count()));
+
+    if (!adaptive_logged_ && estimator_.ready())
+    {
+        adaptive_logged_ = true;
+        HV_LOGI(hv::debug::Module::FRAME,
+                "[TMO ] s%u adaptive idle=%.2fms lifetime=%.1fms (gap=%.1fus period=%.2fms span=%.2fms)",
+                stream_id_,
+                idleDeadline().count() / 1e6,
+                lifetimeDeadline().count() / 1e6,
+                estimator_.gap().mean / 1e3,
+                estimator_.period().mean / 1e6,
+                estimator_.span().mean / 1e6);
+    }
+}
+
+
+FrameReassemblerManager::Emitted*
+FrameReassemblerManager::recentlyEmitted(uint32_t frame_id,
+                                         std::chrono::steady_clock::time_point now)
+{
+    // Never shorter than the fixed idle timeout, however fast the link
+    auto window = std::max<std::chrono::nanoseconds>(idle_timeout_, idleDeadline());
+
+    for (Emitted& e : recent_)
+    {
+        if (e.frame_id == frame_id && (now - e.at) < window)
+            return &e;
+    }
+    return nullptr;
+}
+
+
+/*-------------------------------------------*/
+/* Streaming delivery (row bands)            */
+/*-------------------------------------------*/
+void FrameReassemblerManager::publishBands(FrameEntry& entry)
+{
+    FrameReassemblerV2& fr = entry.reassembler;
+    size_t contiguous = fr.contiguousBytes();
+
+    if (entry.row_bytes == 0)
+    {
+        if (contiguous < sizeof(FrameHeader))
+            return;
+
+        FrameHeader fh;
+        std::memcpy(&fh, fr.getFrameData(), sizeof(fh));
+
+        size_t row_bytes = static_cast<size_t>(fh.width) * ((fh.bitdepth + 7u) / 8u);
+        if (fh.magic != protocol::FRAME_MAGIC || row_bytes == 0 || fh.height == 0
+            || row_bytes * fh.height > fh.frame_size
+            || sizeof(FrameHeader) + fh.frame_size > fr.expectedPackets() * size_t{fr.stride()})
+        {
+            HV_LOGW_RL(hv::debug::Module::FRAME, 10, 20,
+                       "[BAND] frame=%u no usable frame header, streaming off", fr.frameId());
+            entry.bands_off = true;
+            return;
+        }
+
+        entry.row_bytes = row_bytes;
+        entry.width     = fh.width;
+        entry.height    = fh.height;
+        entry.bitdepth  = fh.bitdepth;
+    }
+
+    size_t rows = std::min<size_t>(entry.height,
+                                   (contiguous - sizeof(FrameHeader)) / entry.row_bytes);
+
+    // Whole bands only, except for the bottom of the image
+    uint16_t row_end = (rows == entry.height)
+                       ? entry.height
+                       : static_cast<uint16_t>(rows - rows % band_rows_);
+    if (row_end <= entry.rows_published)
+        return;
+
+    FrameBand b{};
+    b.frame_id  = fr.frameId();
+    b.stream_id = stream_id_;
+    b.width     = entry.width;
+    b.height    = entry.height;
+    b.bitdepth  = entry.bitdepth;
+    b.row_begin = entry.rows_published;
+    b.row_end   = row_end;
+    b.row_bytes = entry.row_bytes;
+    b.data      = fr.getFrameData() + sizeof(FrameHeader) + b.row_begin * entry.row_bytes;
+    b.last      = (row_end == entry.height);
+
+    if (entry.rows_published == 0)
+    {
+        hv::stats::record(hv::stats::LAT_FIRST_BAND,
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                entry.last_update - entry.first_packet_time).count()));
+    }
+
+    entry.rows_published = row_end;
+    hv::stats::add(hv::stats::FRAME_BANDS);
+
+    hv::copy::fence();
+    onFrameBand(b);
 }
 
 
@@ -91,12 +311,12 @@ void FrameReassemblerManager::pollFlush()
         FrameEntry& entry = it->second;
         FrameReassemblerV2& fr = entry.reassembler;
 
-        uint16_t expected = fr.expectedPackets();
-        uint16_t received = fr.receivedPackets();
+        uint32_t expected = fr.expectedPackets();
+        uint32_t received = fr.receivedPackets();
         bool gap          = fr.hasGap();
         
         bool is_complete = fr.isFrameComplete();
-        bool lifetime_expired = (now - entry.first_packet_time) > MAX_FRAME_LIFETIME;
+        bool lifetime_expired = (now - entry.first_packet_time) > lifetimeDeadline();
 
         //Successful Frame
         if (is_complete && !gap)
@@ -149,6 +369,8 @@ void FrameReassemblerManager::pollFlush()
 
         ++it;
     }
+
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(frames_.size()));
 }
 
 /*-------------------------------------------*/
@@ -162,18 +384,24 @@ void FrameReassemblerManager::flushAll()
 
         if (fr.hasAnyPacket())
         {
-            write_frame_to_file(fr.getFrameData(),
-                                fr.getFrameSize(),
-                                true);
+            hv::trace::record(hv::trace::EV_FRAME_FLUSH, fr.frameId(),
+                              0, fr.expectedPackets(), 0, fr.receivedPackets());
 
             HV_LOGW(hv::debug::Module::FRAME,
                     "[FLUSH - ALL] frame=%u rx=%u/%u",
                     fr.frameId(),
                     fr.receivedPackets(),
                     fr.expectedPackets());
+
+            // Same path as timed-out frames: consumers see the tail frames too
+            FrameState state = (fr.receivedPackets() == fr.expectedPackets())
+                             ? FrameState::COMPLETE
+                             : FrameState::PARTIAL;
+            emitFrame(kv.second, state, kv.second.queue_drop_at_start);
         }
     }
     frames_.clear();
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, 0);
 }
 
 
@@ -187,8 +415,9 @@ void FrameReassemblerManager::emitFrame(FrameEntry& entry,
     FrameReassemblerV2& fr = entry.reassembler;
 
     FrameResult r{};
-    r.frame_id = fr.frameId();
-    r.state    = final_state;
+    r.frame_id  = fr.frameId();
+    r.stream_id = stream_id_;
+    r.state     = final_state;
 
     r.expected_packets = fr.expectedPackets();
     r.received_packets = fr.receivedPackets();
@@ -198,9 +427,37 @@ void FrameReassemblerManager::emitFrame(FrameEntry& entry,
 
     //queue pressure  (   drop ߻ߴ°)
     r.queue_pressure = (queue_drop_now > entry.queue_drop_at_start);
+    r.kernel_drops   = entry.kernel_drops;
+
+    // Reused buffer: missing packets would show an older frame's data
+    if (final_state == FrameState::PARTIAL)
+        fr.zeroMissing();
+
+    // Payloads may have been written with non-temporal stores
+    hv::copy::fence();
 
     r.frame_data = fr.getFrameData();
     r.frame_size = fr.getFrameSize();
+    r.buffer     = fr.buffer();
+
+    r.digest_state = fr.finalizeDigest();
+    r.digest       = fr.digest();
+
+    if (r.digest_state == FrameDigestState::MISMATCH)
+    {
+        hv::stats::add(hv::stats::DIGEST_MISMATCH);
+        hv::trace::record(hv::trace::EV_DIGEST_MISMATCH, r.frame_id,
+                          0, r.expected_packets, 0, 0, r.digest);
+        HV_LOGW(hv::debug::Module::FRAME, "[DIGEST] frame=%u MISMATCH digest=%016llx",
+                                r.frame_id,
+                                static_cast<unsigned long long>(r.digest));
+    }
+    else if (r.digest_state == FrameDigestState::VERIFIED)
+    {
+        HV_LOGI(hv::debug::Module::FRAME, "[DIGEST] frame=%u verified digest=%016llx",
+                                r.frame_id,
+                                static_cast<unsigned long long>(r.digest));
+    }
 
 	//   (ο)
 	//r.state = FrameState::EMITTED;
@@ -209,28 +466,27 @@ void FrameReassemblerManager::emitFrame(FrameEntry& entry,
    
     if (final_state == FrameState::PARTIAL)
     {
-        HV_LOGW(hv::debug::Module::FRAME, "[GAP PARTIAL] frame=%u missing=%u/%u",
+        HV_LOGW(hv::debug::Module::FRAME, "[GAP PARTIAL] frame=%u missing=%u/%u kernel_drops=%u queue_pressure=%d",
                                 r.frame_id,
                                 r.expected_packets - r.received_packets,
-                                r.expected_packets);
+                                r.expected_packets,
+                                r.kernel_drops,
+                                r.queue_pressure);
 
         stats_.partial++;
+        hv::stats::add(hv::stats::FRAMES_PARTIAL);
 
-        #ifdef DEBUG_LOG_ENABLE
-        for (uint16_t i = 0; i < fr.expectedPackets(); ++i)
+        // Missing packet ids for drop diagnosis (bounded per frame)
+        uint32_t reported = 0;
+        for (uint32_t i = 0; i < fr.expectedPackets() && reported < MAX_TRACE_MISSING; ++i)
         {
             if (!fr.hasPacket(i))
             {
-                debug_log::PacketTraceEntry te{};
-                te.frame_id = fr.frameId();
-                te.packet_id = i;
-                te.packet_count = fr.expectedPackets();
-                te.flags = 2;
-
-                debug_log::trace_packet(te);
+                hv::trace::record(hv::trace::EV_PACKET_MISSING,
+                                  r.frame_id, i, r.expected_packets);
+                reported++;
             }
         }
-        #endif
     }
     else
     {
@@ -238,21 +494,45 @@ void FrameReassemblerManager::emitFrame(FrameEntry& entry,
                                 r.frame_id,
                                 r.received_packets);
         stats_.complete++;
+        hv::stats::add(hv::stats::FRAMES_COMPLETED);
     }
 
      
     //if ((stats_.total % 100) == 0)
     {
         HV_LOGI(hv::debug::Module::FRAME, "[STATS] total=%llu complete=%llu partial=%llu success=%.2f%%",
-            stats_.total.load(),
-            stats_.complete.load(),
-            stats_.partial.load(),
+            static_cast<unsigned long long>(stats_.total),
+            static_cast<unsigned long long>(stats_.complete),
+            static_cast<unsigned long long>(stats_.partial),
             stats_.total ? 100.0 * stats_.complete / stats_.total : 0.0);
     }
 
 
+    auto emit_time = std::chrono::steady_clock::now();
+
+    // Cut frames too: the rest of a slow frame would otherwise open ghost entries
+    recent_[recent_next_] = Emitted{r.frame_id, emit_time, entry.first_packet_time,
+                                    entry.last_update, !r.complete};
+    recent_next_ = (recent_next_ + 1) % RECENT_EMITTED;
+
+    uint64_t assembly_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            emit_time - entry.first_packet_time).count());
+
+    hv::stats::record(hv::stats::LAT_FRAME_ASSEMBLY, assembly_ns);
+    hv::trace::record(hv::trace::EV_FRAME_EMIT, r.frame_id,
+                      0, r.expected_packets,
+                      static_cast<uint16_t>(final_state),
+                      r.received_packets, assembly_ns);
+
     if (onFrameDone)
+    {
         onFrameDone(r);
+
+        hv::stats::record(hv::stats::LAT_FRAME_CONSUMER,
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - emit_time).count()));
+    }
 }
 
 
@@ -262,6 +542,8 @@ void FrameReassemblerManager::emitFrame(FrameEntry& entry,
 void FrameReassemblerManager::pollTimers(size_t queue_drop_now)
 {
     auto now = std::chrono::steady_clock::now();
+    auto idle = idleDeadline();
+    auto lifetime = lifetimeDeadline();
 
     for (auto it = frames_.begin(); it != frames_.end(); )
     {
@@ -274,13 +556,16 @@ void FrameReassemblerManager::pollTimers(size_t queue_drop_now)
               
         if (fr.receivedPackets() == fr.expectedPackets())
         {
+            if (estimator_.config().adaptive)
+                onFrameSpan(entry);
+
             emitFrame(entry, FrameState::COMPLETE, queue_drop_now);
             it = frames_.erase(it);
             continue;
         }
 
-        bool hard_timeout = (age > MAX_FRAME_LIFETIME);
-        bool idle_timeout = (since_last > FRAME_IDLE_TIMEOUT);
+        bool hard_timeout = (age > lifetime);
+        bool idle_timeout = (since_last > idle);
        
         // Completed successfully
         if  (!idle_timeout 
@@ -290,13 +575,15 @@ void FrameReassemblerManager::pollTimers(size_t queue_drop_now)
             continue;
         }
 
-        FrameState state = (fr.receivedPackets() != fr.expectedPackets())
+        FrameState state = (fr.receivedPackets() == fr.expectedPackets())
                  ? FrameState::COMPLETE
                  : FrameState::PARTIAL;
 
         emitFrame(entry, state, queue_drop_now);
         it = frames_.erase(it);
     }
+
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(frames_.size()));
 }
 
 
@@ -315,6 +602,8 @@ void FrameReassemblerManager::forceEmitAll(size_t queue_drop_now)
         emitFrame(entry, state, queue_drop_now);
         it = frames_.erase(it);
     }
+
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(frames_.size()));
 }
 
 
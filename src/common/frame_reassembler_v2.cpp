@@ -10,34 +10,58 @@
 
 #include "debug/hv_debug.hpp"
 #include "common/frame_reassembler_v2.hpp"
+#include "common/payload_copy.hpp"
 
 #include <cstring>
 #include <algorithm>
 
 FrameReassemblerV2::FrameReassemblerV2(size_t max_frame_size,
-                                       size_t payload_stride)
+                                       size_t payload_stride,
+                                       FrameBufferPool* pool)
     : max_frame_size_(max_frame_size),
       payload_stride_(payload_stride),
       current_frame_id_(0),
       expected_packet_count_(0),
       received_packets_count_(0),
+      pool_(pool),
       corrupted_detected_(false)
 {
-    frame_buffer_.resize(max_frame_size_);
+    // Pooled: the buffer is taken when a frame starts
+    if (!pool_)
+        frame_buffer_ = FrameHandle::allocate(max_frame_size_);
 }
 
-void FrameReassemblerV2::startNewFrame(uint32_t frame_id,
-                                       uint16_t packet_count)
+bool FrameReassemblerV2::startNewFrame(uint32_t frame_id,
+                                       uint32_t packet_count,
+                                       uint32_t stride)
 {
+    // A consumer still holds the previous frame: write into another buffer
+    if (!frame_buffer_ || frame_buffer_.useCount() > 1)
+    {
+        frame_buffer_ = pool_ ? pool_->acquire()
+                              : FrameHandle::allocate(max_frame_size_);
+        if (!frame_buffer_)
+        {
+            expected_packet_count_  = 0;
+            received_packets_count_ = 0;
+            return false;
+        }
+    }
+
     current_frame_id_       = frame_id;
     expected_packet_count_  = packet_count;
     received_packets_count_ = 0;
+    frame_stride_           = stride ? stride : static_cast<uint32_t>(payload_stride_);
     corrupted_detected_     = false;
     frame_size_             = 0;
+    contiguous_packets_     = 0;
 
     packet_received_.assign(packet_count, false);
     packet_corrupted_.assign(packet_count, false);
-    
+
+    digest_.reset(std::min(max_frame_size_,
+                           static_cast<size_t>(packet_count) * frame_stride_));
+    return true;
 }
 
 
@@ -48,41 +72,84 @@ void FrameReassemblerV2::pushPacket(const UdpPacketHeader& hdr,
                                     const uint8_t* payload,
                                     bool gap_detected)
 {
-    uint16_t pid = hdr.packet_id;
+    uint32_t pid = hdr.packet_id;
 
     if (pid >= expected_packet_count_)
     {
         return;
     }
 
+    // v2 packets carry the stride; it must not change within a frame
+    if (hdr.payload_stride && hdr.payload_stride != frame_stride_)
+    {
+        HV_LOGW_RL(hv::debug::Module::FRAME, 10, 20,
+                   "[STRD] frame=%u pid=%u stride=%u/%u", current_frame_id_, pid,
+                   hdr.payload_stride, frame_stride_);
+        return;
+    }
+
     if (packet_received_[pid])
     {
         // duplicate packet
-        HV_LOGW(hv::debug::Module::FRAME, "[DUP ] frame=%u pid=%u", current_frame_id_, pid);
+        HV_LOGW_RL(hv::debug::Module::FRAME, 10, 20,
+                   "[DUP ] frame=%u pid=%u", current_frame_id_, pid);
         return;
     }
 
     //Frame buffer size check
-    size_t offset = static_cast<size_t>(pid) * payload_stride_;
+    size_t offset = static_cast<size_t>(pid) * frame_stride_;
 
     if (offset + hdr.payload_size > max_frame_size_) 
     {   
-	    HV_LOGW(hv::debug::Module::FRAME, "[SIZE ] frame=%u pid=%u size=%u", current_frame_id_, pid, offset + hdr.payload_size);
+	    HV_LOGW_RL(hv::debug::Module::FRAME, 10, 20,
+                   "[SIZE ] frame=%u pid=%u size=%zu", current_frame_id_, pid, offset + hdr.payload_size);
         return;
     }
 
     
-    //Correct data write (order does not matter)
-    std::memcpy(frame_buffer_.data() + offset,
-                payload,
-                hdr.payload_size);
+    //Correct data write (order does not matter), kept out of the worker's caches
+    //unless the digest hashes it back out of the frame buffer: a chunk written
+    //with non-temporal stores would be read straight back from DRAM
+    if (digest_.readsBack())
+        std::memcpy(frame_buffer_.data() + offset, payload, hdr.payload_size);
+    else
+        hv::copy::payload(frame_buffer_.data() + offset,
+                          payload,
+                          hdr.payload_size);
 
     packet_received_[pid] = true;
     received_packets_count_++;
 
+    digest_.onBytes(frame_buffer_.data(), offset, hdr.payload_size);
+
     //size update
     size_t end = offset + hdr.payload_size;
     frame_size_ = std::max(frame_size_, end);
+
+    while (contiguous_packets_ < expected_packet_count_
+           && packet_received_[contiguous_packets_])
+        contiguous_packets_++;
+}
+
+size_t FrameReassemblerV2::contiguousBytes() const
+{
+    if (contiguous_packets_ == expected_packet_count_)
+        return frame_size_;
+
+    return static_cast<size_t>(contiguous_packets_) * frame_stride_;
+}
+
+void FrameReassemblerV2::zeroMissing()
+{
+    for (uint32_t i = contiguous_packets_; i < expected_packet_count_; ++i)
+    {
+        size_t offset = static_cast<size_t>(i) * frame_stride_;
+        if (offset >= frame_size_)
+            break;
+        if (!packet_received_[i])
+            std::memset(frame_buffer_.data() + offset, 0,
+                        std::min<size_t>(frame_stride_, frame_size_ - offset));
+    }
 }
 
 bool FrameReassemblerV2::hasAnyPacket() const
@@ -106,7 +173,7 @@ bool FrameReassemblerV2::hasCorruption() const
     return corrupted_detected_;
 }
 
-bool FrameReassemblerV2::hasPacket(uint16_t packet_id) const
+bool FrameReassemblerV2::hasPacket(uint32_t packet_id) const
 {
     if (packet_id >= expected_packet_count_)
         return false;
@@ -135,11 +202,20 @@ void FrameReassemblerV2::reset()
 {
     expected_packet_count_ = 0;
     received_packets_count_ = 0;
+    contiguous_packets_ = 0;
     packet_received_.clear();
     corrupted_detected_ = false;
 }
 
 
+FrameDigestState FrameReassemblerV2::finalizeDigest()
+{
+    return digest_.finalize(frame_buffer_.data(),
+                            frame_size_,
+                            isFrameComplete());
+}
+
+
 FrameResult FrameReassemblerV2::makeResult(FrameState final_state) const
 {
     FrameResult r{};
@@ -154,6 +230,10 @@ FrameResult FrameReassemblerV2::makeResult(FrameState final_state) const
 
     r.frame_size = frame_size_;
     r.frame_data = frame_buffer_.data();
+    r.buffer     = frame_buffer_;
+
+    r.digest_state = digest_.state();
+    r.digest       = digest_.digest();
 
     return r;
 }
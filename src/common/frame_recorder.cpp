@@ -0,0 +1,355 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Compressed Frame Recorder                       */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "common/frame_recorder.hpp"
+#include "common/thread_placement.hpp"
+
+#include "debug/debug_histogram.hpp"
+#include "debug/hv_debug.hpp"
+
+
+namespace {
+
+// Sanity limits for the reader (a corrupt record must not allocate gigabytes)
+constexpr uint64_t MAX_RAW_SIZE    = 1ull << 30;
+constexpr uint32_t MAX_CHUNK_COUNT = 1u << 20;
+
+} // namespace
+
+
+/*-------------------------------------------*/
+/* FrameRecorder                             */
+/*-------------------------------------------*/
+FrameRecorder::FrameRecorder(const RecorderConfig& cfg)
+    : cfg_(cfg)
+{
+    if (cfg_.chunk_size == 0)
+        cfg_.chunk_size = RecorderConfig{}.chunk_size;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path)
+{
+    if (fp_)
+        return false;
+
+    if (!frameCodecAvailable(cfg_.codec))
+    {
+        HV_LOGE(hv::debug::Module::FRAME, "[REC ] codec %s not compiled in", frameCodecName(cfg_.codec));
+        return false;
+    }
+
+    fp_ = std::fopen(path.c_str(), "wb");
+    if (!fp_)
+    {
+        perror("fopen(record)");
+        return false;
+    }
+
+    HvrFileHeader fh{};
+    fh.magic      = HVR_FILE_MAGIC;
+    fh.version    = HVR_VERSION;
+    fh.created_ns = hv::stats::realtimeNs();
+    std::fwrite(&fh, sizeof(fh), 1, fp_);
+
+    stop_ = false;
+    if (cfg_.codec != FrameCodec::NONE)
+    {
+        for (uint32_t i = 0; i < cfg_.threads; ++i)
+            workers_.emplace_back(&FrameRecorder::workerLoop, this);
+    }
+
+    HV_LOGI(hv::debug::Module::FRAME, "[REC ] %s codec=%s chunk=%zu KB threads=%u+1",
+            path.c_str(), frameCodecName(cfg_.codec), cfg_.chunk_size / 1024,
+            static_cast<unsigned>(workers_.size()));
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (std::thread& t : workers_)
+        t.join();
+    workers_.clear();
+
+    if (!fp_)
+        return;
+
+    std::fclose(fp_);
+    fp_ = nullptr;
+
+    RecorderStats s = stats();
+    HV_LOGI(hv::debug::Module::FRAME,
+            "[REC ] frames=%llu raw=%.1f MB written=%.1f MB ratio=%.2f stored_chunks=%llu compress=%.1f ms write=%.1f ms",
+            static_cast<unsigned long long>(s.frames),
+            s.raw_bytes / 1e6, s.written_bytes / 1e6,
+            s.written_bytes ? static_cast<double>(s.raw_bytes) / s.written_bytes : 0.0,
+            static_cast<unsigned long long>(s.stored_chunks),
+            s.compress_ns / 1e6, s.write_ns / 1e6);
+}
+
+void FrameRecorder::workerLoop()
+{
+    pthread_setname_np(pthread_self(), "hv_rec");
+    hv::placement::apply(hv::placement::Role::WRITER);
+
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            work_cv_.wait(lk, [&] { return stop_ || (src_ && generation_ != seen); });
+            if (stop_)
+                return;
+            seen = generation_;
+            active_++;
+        }
+
+        compressChunks();
+
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            active_--;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void FrameRecorder::compressChunks()
+{
+    // src_ / chunks_ stay valid until every active thread has left (record())
+    for (;;)
+    {
+        size_t i = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= chunks_)
+            return;
+
+        size_t off = i * cfg_.chunk_size;
+        size_t len = std::min(cfg_.chunk_size, src_size_ - off);
+
+        std::vector<uint8_t>& out = out_[i];
+        size_t n = frameCodecCompress(cfg_.codec, cfg_.level, src_ + off, len,
+                                      out.data(), out.size());
+        table_[i].size  = static_cast<uint32_t>(n ? n : len);
+        table_[i].flags = n ? 0 : HVR_CHUNK_STORED;
+
+        done_chunks_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool FrameRecorder::record(const FrameResult& r)
+{
+    if (!fp_ || !r.frame_data || r.frame_size == 0)
+        return false;
+
+    const size_t n      = r.frame_size;
+    const size_t chunks = (n + cfg_.chunk_size - 1) / cfg_.chunk_size;
+
+    table_.assign(chunks, HvrChunk{});
+    if (out_.size() < chunks)
+        out_.resize(chunks);
+
+    uint64_t t0 = hv::stats::monotonicNs();
+
+    if (cfg_.codec == FrameCodec::NONE)
+    {
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            table_[i].size  = static_cast<uint32_t>(std::min(cfg_.chunk_size, n - i * cfg_.chunk_size));
+            table_[i].flags = HVR_CHUNK_STORED;
+        }
+    }
+    else
+    {
+        size_t bound = frameCodecBound(cfg_.codec, cfg_.chunk_size);
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            if (out_[i].size() < bound)
+                out_[i].resize(bound);
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            src_      = r.frame_data;
+            src_size_ = n;
+            chunks_   = chunks;
+            next_chunk_.store(0, std::memory_order_relaxed);
+            done_chunks_.store(0, std::memory_order_relaxed);
+            generation_++;
+        }
+        work_cv_.notify_all();
+
+        compressChunks();
+
+        // Late workers may still hold a chunk; none may see the next frame's counters
+        std::unique_lock<std::mutex> lk(mtx_);
+        done_cv_.wait(lk, [&] {
+            return active_ == 0 && done_chunks_.load(std::memory_order_acquire) == chunks_;
+        });
+        src_ = nullptr;
+    }
+
+    uint64_t t1 = hv::stats::monotonicNs();
+
+    /* Record header, chunk table, chunk data */
+    uint64_t data_size = 0;
+    uint64_t stored = 0;
+    for (HvrChunk& c : table_)
+    {
+        c.offset   = data_size;
+        data_size += c.size;
+        if (c.flags & HVR_CHUNK_STORED)
+            stored++;
+    }
+
+    HvrFrameRecord rec{};
+    rec.magic            = HVR_RECORD_MAGIC;
+    rec.frame_id         = r.frame_id;
+    rec.stream_id        = r.stream_id;
+    rec.codec            = static_cast<uint8_t>(cfg_.codec);
+    rec.state            = static_cast<uint8_t>(r.state);
+    rec.flags            = (r.state == FrameState::PARTIAL ? HVR_FLAG_PARTIAL : 0)
+                         | (r.corrupted ? HVR_FLAG_CORRUPTED : 0)
+                         | (r.digest_state == FrameDigestState::VERIFIED ? HVR_FLAG_VERIFIED : 0);
+    rec.chunk_size       = static_cast<uint32_t>(cfg_.chunk_size);
+    rec.chunk_count      = static_cast<uint32_t>(chunks);
+    rec.expected_packets = r.expected_packets;
+    rec.received_packets = r.received_packets;
+    rec.raw_size         = n;
+    rec.data_size        = data_size;
+    rec.recorded_ns      = hv::stats::realtimeNs();
+    if (n >= sizeof(FrameHeader))
+        std::memcpy(&rec.header, r.frame_data, sizeof(FrameHeader));
+
+    bool ok = std::fwrite(&rec, sizeof(rec), 1, fp_) == 1
+           && std::fwrite(table_.data(), sizeof(HvrChunk), chunks, fp_) == chunks;
+
+    for (size_t i = 0; ok && i < chunks; ++i)
+    {
+        const uint8_t* p = (table_[i].flags & HVR_CHUNK_STORED)
+                         ? r.frame_data + i * cfg_.chunk_size
+                         : out_[i].data();
+        ok = std::fwrite(p, 1, table_[i].size, fp_) == table_[i].size;
+    }
+
+    if (!ok)
+    {
+        perror("fwrite(record)");
+        return false;
+    }
+
+    uint64_t t2 = hv::stats::monotonicNs();
+
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    stats_.frames++;
+    stats_.raw_bytes     += n;
+    stats_.written_bytes += sizeof(rec) + chunks * sizeof(HvrChunk) + data_size;
+    stats_.stored_chunks += stored;
+    stats_.compress_ns   += t1 - t0;
+    stats_.write_ns      += t2 - t1;
+    return true;
+}
+
+RecorderStats FrameRecorder::stats() const
+{
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    return stats_;
+}
+
+
+/*-------------------------------------------*/
+/* FrameRecordReader                         */
+/*-------------------------------------------*/
+FrameRecordReader::~FrameRecordReader()
+{
+    if (fp_)
+        std::fclose(fp_);
+}
+
+bool FrameRecordReader::open(const std::string& path)
+{
+    fp_ = std::fopen(path.c_str(), "rb");
+    if (!fp_)
+    {
+        perror("fopen");
+        return false;
+    }
+
+    HvrFileHeader fh{};
+    if (std::fread(&fh, sizeof(fh), 1, fp_) != 1 || fh.magic != HVR_FILE_MAGIC
+        || fh.version != HVR_VERSION)
+    {
+        std::fprintf(stderr, "%s: not a frame recording (.hvr v%u)\n", path.c_str(), HVR_VERSION);
+        return false;
+    }
+    return true;
+}
+
+bool FrameRecordReader::next(HvrFrameRecord& rec, std::vector<uint8_t>& out, uint32_t* bad_chunks)
+{
+    if (!fp_ || std::fread(&rec, sizeof(rec), 1, fp_) != 1)
+        return false;
+
+    if (rec.magic != HVR_RECORD_MAGIC || rec.raw_size > MAX_RAW_SIZE
+        || rec.chunk_count > MAX_CHUNK_COUNT || rec.chunk_size == 0
+        || rec.data_size > MAX_RAW_SIZE * 2
+        || static_cast<uint64_t>(rec.chunk_count) * rec.chunk_size < rec.raw_size)
+    {
+        std::fprintf(stderr, "bad frame record (frame=%u)\n", rec.frame_id);
+        return false;
+    }
+
+    table_.resize(rec.chunk_count);
+    data_.resize(rec.data_size);
+    if (std::fread(table_.data(), sizeof(HvrChunk), rec.chunk_count, fp_) != rec.chunk_count
+        || std::fread(data_.data(), 1, rec.data_size, fp_) != rec.data_size)
+    {
+        std::fprintf(stderr, "truncated frame record (frame=%u)\n", rec.frame_id);
+        return false;
+    }
+
+    out.assign(rec.raw_size, 0);
+
+    uint32_t bad = 0;
+    FrameCodec codec = static_cast<FrameCodec>(rec.codec);
+    for (uint32_t i = 0; i < rec.chunk_count; ++i)
+    {
+        const HvrChunk& c = table_[i];
+        uint64_t off = static_cast<uint64_t>(i) * rec.chunk_size;
+        if (off >= rec.raw_size)
+            break;
+        size_t len = static_cast<size_t>(std::min<uint64_t>(rec.chunk_size, rec.raw_size - off));
+
+        // A corrupt offset near 2^64 must not wrap past the bound
+        bool ok = c.offset <= rec.data_size && c.size <= rec.data_size - c.offset;
+        if (ok)
+        {
+            FrameCodec cc = (c.flags & HVR_CHUNK_STORED) ? FrameCodec::NONE : codec;
+            ok = frameCodecDecompress(cc, data_.data() + c.offset, c.size, out.data() + off, len);
+        }
+        if (!ok)
+        {
+            std::memset(out.data() + off, 0, len);
+            bad++;
+        }
+    }
+
+    if (bad_chunks)
+        *bad_chunks = bad;
+    return true;
+}
@@ -11,9 +11,12 @@
 #include "common/frame_result.hpp"
 #include "debug/hv_debug.hpp"
 
+#include <cstdio>
+
 void FrameStreamStats::update(const FrameResult& r)
 {
     frames_total++;
+    stream_id = r.stream_id;
 
     packets_expected += r.expected_packets;
     packets_received += r.received_packets;
@@ -35,20 +38,27 @@ void FrameStreamStats::update(const FrameResult& r)
 
 void FrameStreamStats::log() const
 {
-    uint64_t total = frames_total.load();
-    if (total == 0)
+    if (frames_total == 0)
         return;
 
+    using ull = unsigned long long;
+
+    // Stream 0 keeps the single-stream tag
+    char tag[24] = "STATS";
+    if (stream_id)
+        std::snprintf(tag, sizeof(tag), "STATS s%u", stream_id);
+
     HV_LOGI(hv::debug::Module::FRAME,
-        "[STATS] frames=%llu ok=%llu partial=%llu "
+        "[%s] frames=%llu ok=%llu partial=%llu "
         "queue=%llu gap=%llu pkt=%llu/%llu",
-        total,
-        frames_complete.load(),
-        frames_partial.load(),
-        partial_due_to_queue.load(),
-        partial_due_to_gap.load(),
-        packets_received.load(),
-        packets_expected.load());
+        tag,
+        static_cast<ull>(frames_total),
+        static_cast<ull>(frames_complete),
+        static_cast<ull>(frames_partial),
+        static_cast<ull>(partial_due_to_queue),
+        static_cast<ull>(partial_due_to_gap),
+        static_cast<ull>(packets_received),
+        static_cast<ull>(packets_expected));
 }
 
 
@@ -22,7 +22,8 @@
 
 void write_frame_to_file(const uint8_t* frame,
                             size_t frame_size,
-                            bool is_partial)
+                            bool is_partial,
+                            const char* prefix)
 {
     if (!frame || frame_size < sizeof(FrameHeader))
     {
@@ -41,7 +42,7 @@ void write_frame_to_file(const uint8_t* frame,
     // full frame
     {
         std::string name =
-            std::string("received_") + base + "_frame.bin";
+            std::string(prefix) + "_" + base + "_frame.bin";
 
         FILE* fp = std::fopen(name.c_str(), "wb");
         if (fp)
@@ -54,7 +55,7 @@ void write_frame_to_file(const uint8_t* frame,
     // header
     {
         std::string name =
-            std::string("received_") + base + "_header.bin";
+            std::string(prefix) + "_" + base + "_header.bin";
 
         FILE* fp = std::fopen(name.c_str(), "wb");
         if (fp)
@@ -64,17 +65,25 @@ void write_frame_to_file(const uint8_t* frame,
         }
     }
 
-    // raw payload
+    // raw payload (excludes an optional FrameTrailer)
+    size_t payload_size = frame_size - sizeof(FrameHeader);
+    {
+        FrameHeader hdr;
+        std::memcpy(&hdr, frame, sizeof(hdr));
+        if (hdr.magic == protocol::FRAME_MAGIC && hdr.frame_size < payload_size)
+            payload_size = hdr.frame_size;
+    }
+
     {
         std::string name =
-            std::string("received_") + base + "_raw.bin";
+            std::string(prefix) + "_" + base + "_raw.bin";
 
         FILE* fp = std::fopen(name.c_str(), "wb");
         if (fp)
         {
             std::fwrite(frame + sizeof(FrameHeader),
                          1,
-                         frame_size - sizeof(FrameHeader),
+                         payload_size,
                          fp);
             std::fclose(fp);
         }
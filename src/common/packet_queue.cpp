@@ -9,6 +9,7 @@
 /*===============================================================*/
 
 #include "common/packet_queue.hpp"
+#include "common/payload_copy.hpp"
 #include "protocol/udp_packet.hpp"
 
 bool PacketQueue::push(std::unique_ptr<RxPacket> pkt)
@@ -16,7 +17,7 @@ bool PacketQueue::push(std::unique_ptr<RxPacket> pkt)
     {
         std::lock_guard<std::mutex> lock(mtx_);
 
-        if (q_.size() >= capacity_)
+        if (q_.size() >= capacity_.load(std::memory_order_relaxed))
         {
             // drop newest ()
             dropped_++;
@@ -24,20 +25,32 @@ bool PacketQueue::push(std::unique_ptr<RxPacket> pkt)
         }
 
         q_.push(std::move(pkt));
+        count_.store(q_.size(), std::memory_order_seq_cst);
     }
 
     cv_.notify_one();
+    parker_.notify();
     return true;
 }
 
 bool PacketQueue::try_pop(std::unique_ptr<RxPacket>& out)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (q_.empty())
-        return false;
+    const RxPacket* next = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (q_.empty())
+            return false;
 
-    out = std::move(q_.front());
-    q_.pop();
+        out = std::move(q_.front());
+        q_.pop();
+        count_.store(q_.size(), std::memory_order_relaxed);
+        if (!q_.empty())
+            next = q_.front().get();
+    }
+
+    // Pull the next packet towards this core while the current one is assembled
+    if (next)
+        hv::copy::prefetch(next, sizeof(RxPacket));     // header + inline payload
     return true;
 }
 
@@ -61,6 +74,7 @@ PacketQueue::pop(std::atomic<bool>& shutdown)
 
     auto pkt = std::move(q_.front());
     q_.pop();
+    count_.store(q_.size(), std::memory_order_relaxed);
     return pkt;
 }
 
@@ -97,6 +111,7 @@ bool PacketQueue::pop_until(std::unique_ptr<RxPacket>& out,
         //  Ŷ 
         out = std::move(q_.front());
         q_.pop();
+    count_.store(q_.size(), std::memory_order_relaxed);
         return true;
     }
 
@@ -123,9 +138,64 @@ std::unique_ptr<RxPacket> PacketQueue::pop_or_shutdown(std::atomic<bool>& shutdo
 
     auto pkt = std::move(q_.front());
     q_.pop();
+    count_.store(q_.size(), std::memory_order_relaxed);
     return pkt;
 }
 
 
+bool PacketQueue::pop_wait(std::unique_ptr<RxPacket>& out,
+                           const hv::wait::Config& wait,
+                           std::chrono::nanoseconds timeout,
+                           const std::atomic<bool>& shutdown,
+                           bool* waited)
+{
+    using hv::wait::Mode;
+
+    const bool idle = (count_.load(std::memory_order_acquire) == 0);
+    if (waited)
+        *waited = idle;
 
+    if (!idle || shutdown.load(std::memory_order_relaxed) || timeout.count() <= 0)
+        return try_pop(out);
 
+    if (wait.mode == Mode::BLOCK)
+        return pop_until(out, std::chrono::duration_cast<std::chrono::milliseconds>(timeout)
+                                  + std::chrono::milliseconds(1), shutdown);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto spin  = (wait.mode == Mode::BUSY_POLL) ? timeout
+                     : std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(wait.spin_us));
+
+    // 1) spin on the lock-free count (the lock is only taken once data is there)
+    while (count_.load(std::memory_order_acquire) == 0)
+    {
+        if (shutdown.load(std::memory_order_relaxed))
+            return try_pop(out);
+
+        auto spent = std::chrono::steady_clock::now() - start;
+        if (spent >= spin)
+        {
+            if (wait.mode == Mode::BUSY_POLL)
+                return false;
+
+            // 2) SPIN_PARK: futex park for the rest of the timeout
+            parker_.prepare();
+            if (count_.load(std::memory_order_seq_cst) != 0 || shutdown.load())
+            {
+                parker_.cancel();
+                break;
+            }
+            parker_.park(static_cast<uint64_t>((timeout - spent).count()));
+            break;
+        }
+        hv::wait::cpuRelax();
+    }
+
+    return try_pop(out);
+}
+
+void PacketQueue::wake()
+{
+    cv_.notify_all();
+    parker_.notify();
+}
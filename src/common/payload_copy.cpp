@@ -0,0 +1,250 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                           payload_copy.cpp                                */
+/*                                                                           */
+/*  Non-temporal copy kernels and their selection                            */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "common/payload_copy.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace hv::copy {
+
+size_t g_stream_min = SIZE_MAX;            // memcpy until configure()
+
+namespace {
+
+using CopyFn = void (*)(uint8_t*, const uint8_t*, size_t);
+
+// Head bytes until dst is aligned to `align`
+inline size_t headBytes(const uint8_t* d, size_t align, size_t n)
+{
+    size_t mis = reinterpret_cast<uintptr_t>(d) & (align - 1);
+    size_t head = mis ? align - mis : 0;
+    return head < n ? head : n;
+}
+
+#if defined(__x86_64__)
+
+void copySse2(uint8_t* d, const uint8_t* s, size_t n)
+{
+    size_t head = headBytes(d, 16, n);
+    std::memcpy(d, s, head);
+    d += head; s += head; n -= head;
+
+    for (; n >= 64; n -= 64, d += 64, s += 64)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), e);
+    }
+    std::memcpy(d, s, n);
+}
+
+__attribute__((target("avx2")))
+void copyAvx2(uint8_t* d, const uint8_t* s, size_t n)
+{
+    size_t head = headBytes(d, 32, n);
+    std::memcpy(d, s, head);
+    d += head; s += head; n -= head;
+
+    for (; n >= 128; n -= 128, d += 128, s += 128)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64));
+        __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), e);
+    }
+    for (; n >= 32; n -= 32, d += 32, s += 32)
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+    std::memcpy(d, s, n);
+    _mm256_zeroupper();
+}
+
+CopyFn selectKernel(const char** name)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2-nt";
+        return copyAvx2;
+    }
+    *name = "sse2-nt";
+    return copySse2;
+}
+
+#elif defined(__aarch64__)
+
+// stnp: store pair with a non-temporal hint (Cortex-A78AE keeps it out of L1/L2)
+void copyNeon(uint8_t* d, const uint8_t* s, size_t n)
+{
+    size_t head = headBytes(d, 16, n);
+    std::memcpy(d, s, head);
+    d += head; s += head; n -= head;
+
+    for (; n >= 64; n -= 64, d += 64, s += 64)
+    {
+        uint8x16_t a = vld1q_u8(s);
+        uint8x16_t b = vld1q_u8(s + 16);
+        uint8x16_t c = vld1q_u8(s + 32);
+        uint8x16_t e = vld1q_u8(s + 48);
+        asm volatile("stnp %q0, %q1, [%4]\n\t"
+                     "stnp %q2, %q3, [%4, #32]"
+                     :
+                     : "w"(a), "w"(b), "w"(c), "w"(e), "r"(d)
+                     : "memory");
+    }
+    std::memcpy(d, s, n);
+}
+
+CopyFn selectKernel(const char** name)
+{
+    *name = "neon-stnp";
+    return copyNeon;
+}
+
+#else
+
+CopyFn selectKernel(const char** name)
+{
+    *name = "memcpy";
+    return nullptr;
+}
+
+#endif
+
+struct Kernel
+{
+    const char* name = "memcpy";
+    CopyFn      fn   = nullptr;
+
+    Kernel() { fn = selectKernel(&name); }
+};
+
+const Kernel& kernel()
+{
+    static const Kernel k;
+    return k;
+}
+
+} // namespace
+
+
+bool configure(const Config& cfg, size_t frame_bytes)
+{
+    const bool have = kernel().fn != nullptr;
+
+    switch (cfg.mode)
+    {
+    case Mode::LIBC:
+        g_stream_min = SIZE_MAX;
+        break;
+    case Mode::STREAM:
+        g_stream_min = have ? 0 : SIZE_MAX;
+        break;
+    case Mode::AUTO:
+    {
+        // Frames that stay cached are read back from cache by the consumers
+        size_t llc = llcBytes();
+        bool big = (llc == 0 || frame_bytes > llc / 2);
+        g_stream_min = (have && big) ? cfg.stream_min : SIZE_MAX;
+        break;
+    }
+    }
+    return g_stream_min != SIZE_MAX;
+}
+
+size_t llcBytes()
+{
+    static const size_t bytes = []() -> size_t
+    {
+        size_t best = 0;
+        int best_level = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            char path[96];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+            FILE* fp = std::fopen(path, "r");
+            if (!fp)
+                break;
+            int level = 0;
+            bool ok = std::fscanf(fp, "%d", &level) == 1;
+            std::fclose(fp);
+
+            std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+            fp = std::fopen(path, "r");
+            if (!fp)
+                continue;
+            unsigned long kb = 0;
+            ok = ok && std::fscanf(fp, "%luK", &kb) == 1;
+            std::fclose(fp);
+
+            if (ok && level >= best_level)
+            {
+                best_level = level;
+                best = kb * 1024;
+            }
+        }
+        return best;
+    }();
+    return bytes;
+}
+
+const char* kernelName()
+{
+    return kernel().name;
+}
+
+void streamCopy(void* dst, const void* src, size_t n)
+{
+    CopyFn fn = kernel().fn;
+    if (fn)
+        fn(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), n);
+    else
+        std::memcpy(dst, src, n);
+}
+
+bool parseMode(const std::string& s, Mode& mode)
+{
+    if (s == "memcpy")
+        mode = Mode::LIBC;
+    else if (s == "nt")
+        mode = Mode::STREAM;
+    else if (s == "auto")
+        mode = Mode::AUTO;
+    else
+        return false;
+    return true;
+}
+
+const char* modeName(Mode m)
+{
+    switch (m)
+    {
+    case Mode::LIBC:   return "memcpy";
+    case Mode::STREAM: return "nt";
+    case Mode::AUTO:   return "auto";
+    }
+    return "unknown";
+}
+
+} // namespace hv::copy
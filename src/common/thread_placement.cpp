@@ -0,0 +1,384 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                         thread_placement.cpp                              */
+/*                                                                           */
+/*  CPU affinity / scheduling policy per thread role                         */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "common/thread_placement.hpp"
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include "debug/hv_debug.hpp"
+
+namespace hv::placement {
+
+namespace {
+
+std::mutex          g_mtx;
+Config              g_cfg;
+std::vector<Result> g_results;
+
+std::string readFirstLine(const char* path)
+{
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+/* VmLck from /proc/self/status, in kB (-1 if unavailable) */
+long lockedKb()
+{
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, 6, "VmLck:") == 0)
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+    }
+    return -1;
+}
+
+} // namespace
+
+Config::Config()
+{
+    // Historical tm_receiver behaviour: RX thread tries SCHED_FIFO 80
+    RoleConfig& rx = role[static_cast<size_t>(Role::RX)];
+    rx.policy    = SCHED_FIFO;
+    rx.priority  = 80;
+    rx.set_sched = true;
+
+    // Logging must never compete with RX / frame threads
+    RoleConfig& lg = role[static_cast<size_t>(Role::LOGGER)];
+    lg.nice     = 10;
+    lg.set_nice = true;
+}
+
+void configure(const Config& cfg)
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+    g_cfg = cfg;
+}
+
+Config config()
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+    return g_cfg;
+}
+
+Result apply(Role role)
+{
+    RoleConfig rc = config().role[static_cast<size_t>(role)];
+
+    Result r{};
+    r.role        = role;
+    r.tid         = static_cast<pid_t>(syscall(SYS_gettid));
+    r.affinity_ok = true;
+    r.sched_ok    = true;
+    r.nice_ok     = true;
+
+    auto fail = [&r](int e) { if (!r.err) r.err = e; };
+
+    /* 1. CPU affinity */
+    if (!rc.cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : rc.cpus)
+            CPU_SET(c, &set);
+
+        int e = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (e != 0)
+            fail(e);
+    }
+
+    /* 2. Scheduling policy / priority */
+    if (rc.set_sched)
+    {
+        sched_param sp{};
+        sp.sched_priority = (rc.policy == SCHED_FIFO || rc.policy == SCHED_RR) ? rc.priority : 0;
+
+        int e = pthread_setschedparam(pthread_self(), rc.policy, &sp);
+        if (e != 0)
+            fail(e);
+    }
+
+    /* 3. nice (per thread on Linux) */
+    if (rc.set_nice)
+    {
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(r.tid), rc.nice) < 0)
+            fail(errno);
+    }
+
+    /* Read back what the kernel actually applied */
+    cpu_set_t got;
+    CPU_ZERO(&got);
+    std::vector<int> actual;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(got), &got) == 0)
+    {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &got))
+                actual.push_back(c);
+    }
+    r.cpus = formatCpuList(actual);
+
+    if (!rc.cpus.empty())
+    {
+        std::vector<int> want = rc.cpus;
+        std::sort(want.begin(), want.end());
+        want.erase(std::unique(want.begin(), want.end()), want.end());
+        r.affinity_ok = (want == actual);
+    }
+
+    sched_param sp{};
+    int pol = SCHED_OTHER;
+    pthread_getschedparam(pthread_self(), &pol, &sp);
+    r.policy   = pol;
+    r.priority = sp.sched_priority;
+    if (rc.set_sched)
+        r.sched_ok = (pol == rc.policy)
+                  && (sp.sched_priority == ((pol == SCHED_FIFO || pol == SCHED_RR) ? rc.priority : 0));
+
+    errno = 0;
+    r.nice = getpriority(PRIO_PROCESS, static_cast<id_t>(r.tid));
+    if (rc.set_nice)
+        r.nice_ok = (errno == 0 && r.nice == rc.nice);
+
+    bool ok = r.affinity_ok && r.sched_ok && r.nice_ok;
+
+    if (ok)
+    {
+        HV_LOGI(hv::debug::Module::SYS, "[PLACE] %-6s tid=%d cpus=%s policy=%s/%d nice=%d",
+                roleName(role), r.tid, r.cpus.c_str(), policyName(r.policy), r.priority, r.nice);
+    }
+    else
+    {
+        // Split over three lines: async log records hold ~96 bytes of arguments
+        HV_LOGW(hv::debug::Module::SYS, "[PLACE] %-6s tid=%d NOT APPLIED: %s",
+                roleName(role), r.tid, r.err ? std::strerror(r.err) : "read-back mismatch");
+        HV_LOGW(hv::debug::Module::SYS, "[PLACE] %-6s   have cpus=%s policy=%s/%d nice=%d",
+                roleName(role), r.cpus.c_str(), policyName(r.policy), r.priority, r.nice);
+        HV_LOGW(hv::debug::Module::SYS, "[PLACE] %-6s   want cpus=%s policy=%s/%d nice=%d",
+                roleName(role), rc.cpus.empty() ? "any" : formatCpuList(rc.cpus).c_str(),
+                policyName(rc.policy), rc.priority, rc.nice);
+    }
+
+    /* RX wants CPUs the scheduler keeps free of other work */
+    if (role == Role::RX && !rc.cpus.empty())
+    {
+        std::vector<int> isolated;
+        parseCpuList(readFirstLine("/sys/devices/system/cpu/isolated"), isolated);
+
+        for (int c : rc.cpus)
+        {
+            if (std::find(isolated.begin(), isolated.end(), c) == isolated.end())
+            {
+                HV_LOGW(hv::debug::Module::SYS,
+                        "[PLACE] rx cpu %d is not isolated (isolcpus= / nohz_full= recommended)", c);
+                break;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(g_mtx);
+    g_results.push_back(r);
+    return r;
+}
+
+bool lockMemory()
+{
+    if (!config().lock_memory)
+        return true;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+    {
+        int e = errno;
+        rlimit rl{};
+        getrlimit(RLIMIT_MEMLOCK, &rl);
+        HV_LOGW(hv::debug::Module::SYS, "[PLACE] mlockall failed: %s (RLIMIT_MEMLOCK=%llu kB)",
+                std::strerror(e),
+                static_cast<unsigned long long>(rl.rlim_cur == RLIM_INFINITY ? 0 : rl.rlim_cur / 1024));
+        return false;
+    }
+
+    HV_LOGI(hv::debug::Module::SYS, "[PLACE] mlockall OK (VmLck=%ld kB)", lockedKb());
+    return true;
+}
+
+void applyIrqHints()
+{
+    std::vector<IrqHint> hints = config().irq;
+    if (hints.empty())
+        return;
+
+    std::ifstream in("/proc/interrupts");
+    std::string line;
+    std::getline(in, line);         // CPU header
+
+    while (std::getline(in, line))
+    {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+
+        std::string num = line.substr(0, colon);
+        num.erase(0, num.find_first_not_of(' '));
+        if (num.empty() || !std::all_of(num.begin(), num.end(), ::isdigit))
+            continue;               // NMI, LOC, ...
+
+        for (const IrqHint& h : hints)
+        {
+            if (line.find(h.pattern, colon) == std::string::npos)
+                continue;
+
+            std::string path = "/proc/irq/" + num + "/smp_affinity_list";
+            std::string want = formatCpuList(h.cpus);
+
+            {
+                std::ofstream out(path);
+                out << want << "\n";
+            }
+
+            std::string got = readFirstLine(path.c_str());
+            std::vector<int> got_cpus;
+            parseCpuList(got, got_cpus);
+
+            if (got_cpus == h.cpus)
+                HV_LOGI(hv::debug::Module::SYS, "[PLACE] irq %s (%s) -> cpus %s",
+                        num.c_str(), h.pattern.c_str(), got.c_str());
+            else
+                HV_LOGW(hv::debug::Module::SYS, "[PLACE] irq %s (%s) wanted cpus %s, kernel has %s (root? irqbalance?)",
+                        num.c_str(), h.pattern.c_str(), want.c_str(), got.c_str());
+        }
+    }
+}
+
+std::vector<Result> results()
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+    return g_results;
+}
+
+bool parseCpuList(const std::string& s, std::vector<int>& out)
+{
+    out.clear();
+    std::stringstream ss(s);
+    std::string part;
+
+    while (std::getline(ss, part, ','))
+    {
+        if (part.empty())
+            continue;
+
+        char* end = nullptr;
+        long a = std::strtol(part.c_str(), &end, 10);
+        long b = a;
+        if (*end == '-')
+            b = std::strtol(end + 1, &end, 10);
+        if (*end != '\0' && *end != '\n')
+            return false;
+        if (a < 0 || b < a || b >= CPU_SETSIZE)
+            return false;
+
+        for (long c = a; c <= b; ++c)
+            out.push_back(static_cast<int>(c));
+    }
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return true;
+}
+
+bool parsePolicy(const std::string& s, int& policy, int& priority)
+{
+    std::string name = s.substr(0, s.find(':'));
+    priority = 0;
+
+    if      (name == "other") policy = SCHED_OTHER;
+    else if (name == "fifo")  policy = SCHED_FIFO;
+    else if (name == "rr")    policy = SCHED_RR;
+    else if (name == "batch") policy = SCHED_BATCH;
+    else if (name == "idle")  policy = SCHED_IDLE;
+    else return false;
+
+    if (s.find(':') != std::string::npos)
+        priority = std::atoi(s.c_str() + s.find(':') + 1);
+
+    if (policy == SCHED_FIFO || policy == SCHED_RR)
+        return priority >= 1 && priority <= 99;
+    return true;
+}
+
+bool parseRole(const std::string& s, Role& role)
+{
+    for (size_t i = 0; i < ROLE_COUNT; ++i)
+    {
+        if (s == roleName(static_cast<Role>(i)))
+        {
+            role = static_cast<Role>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    std::string out;
+    size_t i = 0;
+    while (i < cpus.size())
+    {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            ++j;
+
+        if (!out.empty())
+            out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i)
+            out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out.empty() ? "-" : out;
+}
+
+const char* roleName(Role r)
+{
+    switch (r)
+    {
+    case Role::RX:     return "rx";
+    case Role::WORKER: return "worker";
+    case Role::WRITER: return "writer";
+    case Role::LOGGER: return "logger";
+    default:           return "unknown";
+    }
+}
+
+const char* policyName(int policy)
+{
+    switch (policy)
+    {
+    case SCHED_OTHER: return "other";
+    case SCHED_FIFO:  return "fifo";
+    case SCHED_RR:    return "rr";
+    case SCHED_BATCH: return "batch";
+    case SCHED_IDLE:  return "idle";
+    default:          return "?";
+    }
+}
+
+} // namespace hv::placement
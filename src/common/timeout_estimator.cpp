@@ -0,0 +1,89 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Adaptive Frame Timeouts                         */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/timeout_estimator.hpp"
+
+
+void EwmaStat::add(double x, double alpha)
+{
+    if (n++ == 0)
+    {
+        mean = x;
+        var  = 0.0;
+        return;
+    }
+
+    // Incremental EWMA variance (West 1979)
+    double d = x - mean;
+    mean += alpha * d;
+    var   = (1.0 - alpha) * (var + alpha * d * d);
+}
+
+double EwmaStat::sd() const
+{
+    return std::sqrt(var);
+}
+
+
+void TimeoutEstimator::onPacketGap(uint64_t gap_ns)
+{
+    double g = static_cast<double>(gap_ns);
+    gap_.add(g, GAP_ALPHA);
+    gap_peak_ = std::max(gap_peak_, g);
+
+    if (++gaps_ >= RECOMPUTE_GAPS)
+        recompute();
+}
+
+void TimeoutEstimator::onFrameStart(uint64_t now_ns)
+{
+    if (last_start_ns_ && now_ns > last_start_ns_)
+        period_.add(static_cast<double>(now_ns - last_start_ns_), FRAME_ALPHA);
+    last_start_ns_ = now_ns;
+}
+
+void TimeoutEstimator::onFrameComplete(uint64_t span_ns)
+{
+    double s = static_cast<double>(span_ns);
+    span_.add(s, FRAME_ALPHA);
+    span_peak_ = std::max(span_peak_ * PEAK_DECAY, s);
+    gap_peak_ *= PEAK_DECAY;
+
+    frames_++;
+    recompute();
+}
+
+void TimeoutEstimator::onCutTail(uint64_t span_ns, uint64_t gap_ns)
+{
+    // The frame was cut too early: it needed at least span_ns, with gaps this long
+    double g = static_cast<double>(gap_ns);
+    gap_.add(g, GAP_ALPHA);
+    gap_peak_  = std::max(gap_peak_, g);
+    span_peak_ = std::max(span_peak_, static_cast<double>(span_ns));
+    recompute();
+}
+
+void TimeoutEstimator::recompute()
+{
+    using std::chrono::nanoseconds;
+
+    gaps_ = 0;
+
+    double idle = std::max(gap_.mean + cfg_.gap_k * gap_.sd(), PEAK_MARGIN * gap_peak_);
+    idle = std::clamp(idle,
+                      static_cast<double>(nanoseconds(cfg_.idle_min).count()),
+                      static_cast<double>(nanoseconds(cfg_.idle_max).count()));
+
+    double life = std::max(span_.mean + cfg_.span_k * span_.sd(), PEAK_MARGIN * span_peak_) + idle;
+    life = std::clamp(life,
+                      static_cast<double>(nanoseconds(cfg_.life_min).count()),
+                      static_cast<double>(nanoseconds(cfg_.life_max).count()));
+
+    idle_     = nanoseconds(static_cast<int64_t>(idle));
+    lifetime_ = nanoseconds(static_cast<int64_t>(life));
+}
@@ -0,0 +1,102 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                           wait_strategy.cpp                               */
+/*                                                                           */
+/*  Futex parking, busy-poll socket setup, thread CPU time                   */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "common/wait_strategy.hpp"
+
+#include <linux/futex.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include "debug/hv_debug.hpp"
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
+namespace hv::wait {
+
+bool Parker::park(uint64_t timeout_ns)
+{
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(timeout_ns / 1000000000ull);
+    ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000ull);
+
+    // Returns immediately (EAGAIN) if notify() already flipped the state
+    long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_),
+                      FUTEX_WAIT_PRIVATE, PARKED, &ts, nullptr, 0);
+
+    bool timed_out = (rc < 0 && errno == ETIMEDOUT);
+    state_.store(AWAKE, std::memory_order_relaxed);
+    return !timed_out;
+}
+
+void Parker::wake()
+{
+    if (state_.exchange(AWAKE, std::memory_order_seq_cst) == PARKED)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_),
+                FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+uint64_t threadCpuNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool prepareSocket(int sock, const Config& cfg)
+{
+    if (cfg.mode != Mode::BUSY_POLL)
+        return true;
+
+    // Values above net.core.busy_read need CAP_NET_ADMIN
+    int us = static_cast<int>(cfg.busy_poll_us);
+    if (setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, &us, sizeof(us)) < 0)
+    {
+        HV_LOGW(hv::debug::Module::RX, "[WAIT] SO_BUSY_POLL=%d failed: %s", us, std::strerror(errno));
+        return false;
+    }
+
+    // Keep NAPI polling in our context instead of softirq (kernel >= 5.11)
+    int on = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_PREFER_BUSY_POLL, &on, sizeof(on)) < 0)
+        HV_LOGD(hv::debug::Module::RX, "[WAIT] SO_PREFER_BUSY_POLL unsupported");
+
+    HV_LOGI(hv::debug::Module::RX, "[WAIT] SO_BUSY_POLL=%dus", us);
+    return true;
+}
+
+bool parseMode(const std::string& s, Mode& mode)
+{
+    if      (s == "block") mode = Mode::BLOCK;
+    else if (s == "spin")  mode = Mode::SPIN_PARK;
+    else if (s == "busy")  mode = Mode::BUSY_POLL;
+    else return false;
+    return true;
+}
+
+const char* modeName(Mode m)
+{
+    switch (m)
+    {
+    case Mode::BLOCK:     return "block";
+    case Mode::SPIN_PARK: return "spin";
+    case Mode::BUSY_POLL: return "busy";
+    default:              return "?";
+    }
+}
+
+} // namespace hv::wait
@@ -0,0 +1,205 @@
+/*================================================================================*/
+/*  Latency Histogram Source File                                                 */
+/*================================================================================*/
+
+
+#include "debug/debug_histogram.hpp"
+#include "debug/debug_stats.hpp"
+#include "debug/hv_debug.hpp"
+
+#include <mutex>
+
+namespace hv::stats {
+
+namespace {
+
+// Blocks are allocated once per slot and kept for the next thread
+std::atomic<ThreadHistograms*> g_threads[MAX_THREADS];
+std::atomic<bool>              g_in_use[MAX_THREADS];
+
+ThreadHistograms* overflowBlock()
+{
+    static ThreadHistograms* t = []
+    {
+        auto* b = new ThreadHistograms();
+        b->shared = true;
+        return b;
+    }();
+    return t;
+}
+
+// Exited threads; retire() and histogramSnapshot() hold g_retire_mtx
+std::mutex         g_retire_mtx;
+HistogramSnapshot  g_retired[HIST_MAX];
+
+ThreadHistograms* acquire()
+{
+    for (size_t i = 0; i < MAX_THREADS; ++i)
+    {
+        bool expected = false;
+        if (g_in_use[i].load(std::memory_order_relaxed)
+            || !g_in_use[i].compare_exchange_strong(expected, true, std::memory_order_acquire))
+            continue;
+
+        // Only the slot owner publishes its block; readers skip a null one
+        ThreadHistograms* t = g_threads[i].load(std::memory_order_acquire);
+        if (!t)
+        {
+            t = new ThreadHistograms();     // value-initialised => zero
+            g_threads[i].store(t, std::memory_order_release);
+        }
+        return t;
+    }
+
+    // Out of slots: share one block, updated atomically
+    return overflowBlock();
+}
+
+void retire(ThreadHistograms* t)
+{
+    if (t->shared)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_retire_mtx);
+        for (uint32_t h = 0; h < HIST_MAX; ++h)
+        {
+            HistogramCell& c = t->h[h];
+            HistogramSnapshot& r = g_retired[h];
+            r.count += c.count.exchange(0, std::memory_order_relaxed);
+            r.sum   += c.sum.exchange(0, std::memory_order_relaxed);
+            uint64_t m = c.max.exchange(0, std::memory_order_relaxed);
+            if (m > r.max)
+                r.max = m;
+            for (uint32_t b = 0; b < HIST_BUCKETS; ++b)
+                r.buckets[b] += c.buckets[b].exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (size_t i = 0; i < MAX_THREADS; ++i)
+    {
+        if (g_threads[i].load(std::memory_order_relaxed) == t)
+        {
+            g_in_use[i].store(false, std::memory_order_release);
+            break;
+        }
+    }
+}
+
+struct HistOwner
+{
+    ThreadHistograms* hist = nullptr;
+
+    ~HistOwner()
+    {
+        if (hist)
+            retire(hist);
+        hist = nullptr;
+    }
+};
+
+thread_local HistOwner t_hist;
+
+} // namespace
+
+ThreadHistograms& localHistograms()
+{
+    if (__builtin_expect(!t_hist.hist, 0))
+        t_hist.hist = acquire();
+    return *t_hist.hist;
+}
+
+HistogramSnapshot histogramSnapshot(Histogram h)
+{
+    std::lock_guard<std::mutex> lock(g_retire_mtx);
+    HistogramSnapshot s = g_retired[h];
+
+    auto sum = [&s, h](const ThreadHistograms* th)
+    {
+        const HistogramCell& c = th->h[h];
+        s.count += c.count.load(std::memory_order_relaxed);
+        s.sum   += c.sum.load(std::memory_order_relaxed);
+
+        uint64_t m = c.max.load(std::memory_order_relaxed);
+        if (m > s.max)
+            s.max = m;
+
+        for (uint32_t b = 0; b < HIST_BUCKETS; ++b)
+            s.buckets[b] += c.buckets[b].load(std::memory_order_relaxed);
+    };
+
+    // Free slots are zeroed; a null slot is not published yet
+    for (size_t t = 0; t < MAX_THREADS; ++t)
+    {
+        ThreadHistograms* th = g_threads[t].load(std::memory_order_acquire);
+        if (th)
+            sum(th);
+    }
+    sum(overflowBlock());
+
+    return s;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const
+{
+    // Bucket totals may trail count slightly on a live snapshot
+    uint64_t total = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; ++b)
+        total += buckets[b];
+
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; ++b)
+    {
+        seen += buckets[b];
+        if (seen >= rank)
+        {
+            uint64_t upper = histBucketUpper(b);
+            return (upper < max) ? upper : max;
+        }
+    }
+    return max;
+}
+
+const char* histogramName(Histogram h)
+{
+    switch (h)
+    {
+    case LAT_SENDER_TO_KERNEL: return "sender_to_kernel";
+    case LAT_NIC_TO_KERNEL:  return "nic_to_kernel";
+    case LAT_KERNEL_TO_USER: return "kernel_to_user";
+    case LAT_QUEUE_DWELL:    return "queue_dwell";
+    case LAT_WORKER_WAKEUP:  return "worker_wakeup";
+    case LAT_FIRST_BAND:     return "first_band";
+    case LAT_FRAME_ASSEMBLY: return "frame_assembly";
+    case LAT_FRAME_CONSUMER: return "frame_consumer";
+    default:                 return "unknown";
+    }
+}
+
+void logHistograms()
+{
+    for (uint32_t h = 0; h < HIST_MAX; ++h)
+    {
+        HistogramSnapshot s = histogramSnapshot(static_cast<Histogram>(h));
+        if (s.count == 0)
+            continue;
+
+        HV_LOGI(hv::debug::Module::FRAME,
+                "[LAT ] %-14s n=%llu p50=%.1fus p99=%.1fus p999=%.1fus max=%.1fus",
+                histogramName(static_cast<Histogram>(h)),
+                static_cast<unsigned long long>(s.count),
+                s.percentile(50.0)  / 1e3,
+                s.percentile(99.0)  / 1e3,
+                s.percentile(99.9)  / 1e3,
+                s.max / 1e3);
+    }
+}
+
+} // namespace hv::stats
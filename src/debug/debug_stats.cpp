@@ -4,10 +4,141 @@
 
 
 
-#include "debug/hv_stats.hpp"
+#include "debug/debug_stats.hpp"
+
+#include <ctime>
+#include <mutex>
 
 namespace hv::stats {
-Counters g;
+
+namespace {
+
+ThreadCounters        g_blocks[MAX_THREADS];
+std::atomic<bool>     g_in_use[MAX_THREADS];
+
+// Threads beyond MAX_THREADS alive at once
+ThreadCounters        g_overflow{{}, {}, true};
+
+// Counters of exited threads; retire() and snapshot() hold g_retire_mtx so a
+// block is never seen both in its slot and in the total
+std::mutex            g_retire_mtx;
+uint64_t              g_retired[COUNTER_MAX];
+
+ThreadCounters* acquireBlock()
+{
+    for (size_t i = 0; i < MAX_THREADS; ++i)
+    {
+        bool expected = false;
+        if (!g_in_use[i].load(std::memory_order_relaxed)
+            && g_in_use[i].compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return &g_blocks[i];
+    }
+    return &g_overflow;
+}
+
+void retire(ThreadCounters* b)
+{
+    if (b == &g_overflow)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_retire_mtx);
+        for (uint32_t c = 0; c < COUNTER_MAX; ++c)
+            g_retired[c] += b->counters[c].exchange(0, std::memory_order_relaxed);
+        for (uint32_t g = 0; g < GAUGE_MAX; ++g)
+            b->gauges[g].store(0, std::memory_order_relaxed);
+    }
+    g_in_use[b - g_blocks].store(false, std::memory_order_release);
 }
 
+struct BlockOwner
+{
+    ThreadCounters* block = nullptr;
+
+    ~BlockOwner()
+    {
+        if (block)
+            retire(block);
+        block = nullptr;
+    }
+};
+
+thread_local BlockOwner t_block;
+
+} // namespace
+
+ThreadCounters& local()
+{
+    if (__builtin_expect(!t_block.block, 0))
+        t_block.block = acquireBlock();
+    return *t_block.block;
+}
 
+Snapshot snapshot()
+{
+    Snapshot s{};
+
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    s.ts_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+
+    auto sum = [&s](const ThreadCounters& b)
+    {
+        for (uint32_t c = 0; c < COUNTER_MAX; ++c)
+            s.counters[c] += b.counters[c].load(std::memory_order_relaxed);
+
+        for (uint32_t g = 0; g < GAUGE_MAX; ++g)
+            s.gauges[g] += b.gauges[g].load(std::memory_order_relaxed);
+    };
+
+    // Free slots are zeroed, summing them is harmless
+    std::lock_guard<std::mutex> lock(g_retire_mtx);
+    for (const ThreadCounters& b : g_blocks)
+        sum(b);
+    sum(g_overflow);
+
+    for (uint32_t c = 0; c < COUNTER_MAX; ++c)
+        s.counters[c] += g_retired[c];
+
+    return s;
+}
+
+const char* counterName(Counter c)
+{
+    switch (c)
+    {
+    case RX_PACKETS:        return "rx_packets";
+    case RX_BYTES:          return "rx_bytes";
+    case QUEUE_DROPS:       return "queue_drops";
+    case RING_DROPS:        return "ring_drops";
+    case KERNEL_DROPS:      return "kernel_drops";
+    case STREAM_REJECTS:    return "stream_rejects";
+    case FRAMES_STARTED:    return "frames_started";
+    case FRAMES_COMPLETED:  return "frames_complete";
+    case FRAMES_PARTIAL:    return "frames_partial";
+    case DIGEST_MISMATCH:   return "digest_mismatch";
+    case LATE_PACKETS:      return "late_packets";
+    case FRAME_BANDS:       return "frame_bands";
+    case STAGE_DROPS:       return "stage_drops";
+    case BUFFER_EXHAUSTED:  return "buffer_exhausted";
+    case SHED_FRAMES:       return "shed_frames";
+    case SHED_PACKETS:      return "shed_packets";
+    case CAPTURE_PACKETS:   return "capture_packets";
+    case CAPTURE_DROPS:     return "capture_drops";
+    default:                return "unknown";
+    }
+}
+
+const char* gaugeName(Gauge g)
+{
+    switch (g)
+    {
+    case QUEUE_DEPTH:       return "queue_depth";
+    case FRAMES_IN_FLIGHT:  return "frames_in_flight";
+    case RX_CPU_US:         return "rx_cpu_us";
+    case WORKER_CPU_US:     return "worker_cpu_us";
+    default:                return "unknown";
+    }
+}
+
+}
@@ -0,0 +1,218 @@
+/*================================================================================*/
+/*  Flight Recorder Source File                                                   */
+/*================================================================================*/
+
+
+#include "debug/flight_recorder.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hv::trace {
+
+namespace detail {
+std::atomic<uint32_t> g_epoch{0};
+}
+
+namespace {
+
+std::mutex  g_mtx;              // open/close/attach (cold path)
+uint8_t*    g_base = nullptr;
+size_t      g_size = 0;
+uint32_t    g_next_epoch = 1;
+uint64_t    g_freed_seq = 0;        // rings released so far
+
+FileHeader* header() { return reinterpret_cast<FileHeader*>(g_base); }
+
+RingHeader* ringAt(size_t idx)
+{
+    return reinterpret_cast<RingHeader*>(
+        g_base + FILE_HEADER_SIZE + idx * ringBytes(header()->ring_events));
+}
+
+uint64_t clockNs(clockid_t id)
+{
+    timespec ts;
+    clock_gettime(id, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+} // namespace
+
+namespace detail {
+
+Local& local()
+{
+    thread_local Local t_local;
+    return t_local;
+}
+
+void attach(Local& l, uint32_t epoch)
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+
+    l.epoch = epoch;
+    l.ring  = nullptr;
+
+    if (g_epoch.load(std::memory_order_relaxed) != epoch || !g_base)
+        return;
+
+    FileHeader* fh = header();
+    uint32_t used = fh->threads_used.load(std::memory_order_relaxed);
+
+    // Unused rings first: an exited thread's events stay readable as long as possible
+    RingHeader* r = nullptr;
+    if (used < fh->max_threads)
+    {
+        r = ringAt(used);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < used; ++i)
+        {
+            RingHeader* c = ringAt(i);
+            if (!c->in_use && (!r || c->freed_seq < r->freed_seq))
+                r = c;
+        }
+        if (!r)
+            return;
+        r->head.store(0, std::memory_order_release);
+    }
+
+    r->tid    = static_cast<uint32_t>(syscall(SYS_gettid));
+    r->in_use = 1;
+    std::memset(r->name, 0, sizeof(r->name));
+    pthread_getname_np(pthread_self(), r->name, sizeof(r->name));
+
+    if (used < fh->max_threads)
+        fh->threads_used.store(used + 1, std::memory_order_release);
+
+    l.ring = r;
+    l.ev   = reinterpret_cast<Event*>(reinterpret_cast<uint8_t*>(r) + sizeof(RingHeader));
+    l.mask = fh->ring_events - 1;
+}
+
+Local::~Local()
+{
+    if (!ring)
+        return;
+
+    // Same file still open (close() unmaps, a later open() starts a new epoch)
+    std::lock_guard<std::mutex> lk(g_mtx);
+    if (g_base && g_epoch.load(std::memory_order_relaxed) == epoch)
+    {
+        ring->freed_seq = ++g_freed_seq;
+        ring->in_use    = 0;
+    }
+    ring = nullptr;
+}
+
+} // namespace detail
+
+bool open(const char* path, size_t ring_events, size_t max_threads)
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+
+    if (g_base)
+        return false;
+
+    size_t n = 1;
+    while (n < ring_events)
+        n <<= 1;
+    ring_events = n;
+
+    if (max_threads == 0)
+        max_threads = 1;
+
+    size_t size = FILE_HEADER_SIZE + max_threads * ringBytes(ring_events);
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        perror("open(flight recorder)");
+        return false;
+    }
+
+    // Sparse file: pages are only allocated once a ring reaches them
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0)
+    {
+        perror("ftruncate(flight recorder)");
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        perror("mmap(flight recorder)");
+        return false;
+    }
+
+    g_base = static_cast<uint8_t*>(p);
+    g_size = size;
+
+    FileHeader* fh = header();
+    fh->version      = FILE_VERSION;
+    fh->event_size   = sizeof(Event);
+    fh->ring_events  = ring_events;
+    fh->max_threads  = static_cast<uint32_t>(max_threads);
+    fh->pid          = static_cast<uint32_t>(getpid());
+    fh->mono_base_ns = clockNs(CLOCK_MONOTONIC);
+    fh->real_base_ns = clockNs(CLOCK_REALTIME);
+    fh->threads_used.store(0, std::memory_order_relaxed);
+
+    // Magic last: a decoder never sees a half-initialised header
+    std::atomic_thread_fence(std::memory_order_release);
+    fh->magic = FILE_MAGIC;
+
+    detail::g_epoch.store(g_next_epoch++, std::memory_order_release);
+    return true;
+}
+
+void close()
+{
+    std::lock_guard<std::mutex> lk(g_mtx);
+
+    if (!g_base)
+        return;
+
+    detail::g_epoch.store(0, std::memory_order_release);
+
+    msync(g_base, g_size, MS_ASYNC);
+    munmap(g_base, g_size);
+    g_base = nullptr;
+    g_size = 0;
+}
+
+bool isOpen()
+{
+    return detail::g_epoch.load(std::memory_order_acquire) != 0;
+}
+
+const char* eventName(EventType t)
+{
+    switch (t)
+    {
+    case EV_RX_PACKET:       return "rx_packet";
+    case EV_QUEUE_DROP:      return "queue_drop";
+    case EV_FRAME_START:     return "frame_start";
+    case EV_FRAME_EMIT:      return "frame_emit";
+    case EV_PACKET_MISSING:  return "packet_missing";
+    case EV_DIGEST_MISMATCH: return "digest_mismatch";
+    case EV_FRAME_FLUSH:     return "frame_flush";
+    case EV_MARK:            return "mark";
+    case EV_FRAME_SHED:      return "frame_shed";
+    case EV_KERNEL_DROP:     return "kernel_drop";
+    default:                 return "unknown";
+    }
+}
+
+} // namespace hv::trace
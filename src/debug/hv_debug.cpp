@@ -8,15 +8,254 @@
 
 
 #include "debug/hv_debug.hpp"
+#include "common/thread_placement.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <unistd.h>
 
 namespace hv::debug {
 
-static std::atomic<uint32_t> g_module_mask{Module::All};
-static std::atomic<Level>    g_level{Level::Info};
+namespace detail {
+std::atomic<uint32_t> g_module_mask{Module::All};
+std::atomic<Level>    g_level{Level::Info};
+} // namespace detail
+
+using detail::g_module_mask;
+using detail::g_level;
+
+/*----------------------------------------------------------------------------*/
+/* Async backend state                                                        */
+/*----------------------------------------------------------------------------*/
+namespace {
+
+constexpr size_t RING_SLOTS     = 1024;         // per thread: 128 KiB
+constexpr size_t BATCH_BYTES    = 64 * 1024;    // one write() per batch
+constexpr auto   DRAIN_IDLE     = std::chrono::milliseconds(2);
+
+/* Single producer (owner thread) / single consumer (drain thread) */
+struct LogRing
+{
+    alignas(64) std::atomic<uint64_t> head{0};     // written by producer
+    alignas(64) std::atomic<uint64_t> tail{0};     // written by consumer
+    alignas(64) std::atomic<uint64_t> dropped{0};  // producer only
+    uint64_t dropped_reported = 0;                 // consumer only
+    std::atomic<bool> retired{false};              // owner thread exited
+
+    LogRecord slots[RING_SLOTS];
+};
+
+struct AsyncState
+{
+    std::mutex             rings_mtx;
+    std::vector<LogRing*>  rings;
+
+    std::atomic<bool>      running{false};
+
+    // Producer gate: shutdown() closes it and waits for writers inside
+    // reserve()..commit() before the drain thread's final pass
+    std::atomic<bool>      accepting{false};
+    std::atomic<uint32_t>  writers{0};
+    std::atomic<uint64_t>  dropped_total{0};
+    std::thread            drain;
+};
+
+// Intentionally leaked: must outlive thread_local destructors and atexit
+AsyncState& state()
+{
+    static AsyncState* s = new AsyncState();
+    return *s;
+}
+
+struct RingOwner
+{
+    LogRing* ring = nullptr;
+
+    ~RingOwner()
+    {
+        if (ring)
+            ring->retired.store(true, std::memory_order_release);
+        ring = nullptr;
+    }
+};
+
+thread_local RingOwner t_ring;
+
+LogRing* threadRing()
+{
+    if (t_ring.ring)
+        return t_ring.ring;
+
+    LogRing* r = new LogRing();
+    {
+        std::lock_guard<std::mutex> lock(state().rings_mtx);
+        state().rings.push_back(r);
+    }
+    t_ring.ring = r;
+    return r;
+}
+
+uint64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+void writeAll(const char* buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = ::write(STDOUT_FILENO, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+/* Append one formatted line to the batch, flushing when it fills up */
+void appendLine(std::vector<char>& batch, size_t& used, const LogRecord& rec)
+{
+    if (BATCH_BYTES - used < 512)
+    {
+        writeAll(batch.data(), used);
+        used = 0;
+    }
+
+    size_t room = BATCH_BYTES - used - 1;
+    int n = rec.format(rec, batch.data() + used, room);
+    if (n < 0)
+        return;
+
+    used += std::min(static_cast<size_t>(n), room - 1);
+    batch[used++] = '\n';
+}
+
+void appendDropNotice(std::vector<char>& batch, size_t& used, uint64_t n)
+{
+    if (BATCH_BYTES - used < 128)
+    {
+        writeAll(batch.data(), used);
+        used = 0;
+    }
+    used += std::snprintf(batch.data() + used, BATCH_BYTES - used,
+                          "[LOG ] dropped %llu messages (ring full)\n",
+                          static_cast<unsigned long long>(n));
+}
+
+/* Merge all rings in timestamp order; returns number of records written */
+size_t drainOnce(std::vector<char>& batch)
+{
+    AsyncState& st = state();
+
+    std::vector<LogRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(st.rings_mtx);
+        rings = st.rings;
+    }
+
+    size_t used = 0;
+    size_t written = 0;
+
+    for (LogRing* r : rings)
+    {
+        uint64_t d = r->dropped.load(std::memory_order_relaxed);
+        if (d != r->dropped_reported)
+        {
+            appendDropNotice(batch, used, d - r->dropped_reported);
+            st.dropped_total.fetch_add(d - r->dropped_reported, std::memory_order_relaxed);
+            r->dropped_reported = d;
+        }
+    }
+
+    while (true)
+    {
+        LogRing* best = nullptr;
+        uint64_t best_ts = UINT64_MAX;
+
+        for (LogRing* r : rings)
+        {
+            uint64_t tail = r->tail.load(std::memory_order_relaxed);
+            if (tail == r->head.load(std::memory_order_acquire))
+                continue;
+
+            const LogRecord& rec = r->slots[tail % RING_SLOTS];
+            if (rec.ts_ns < best_ts)
+            {
+                best_ts = rec.ts_ns;
+                best = r;
+            }
+        }
+
+        if (!best)
+            break;
+
+        uint64_t tail = best->tail.load(std::memory_order_relaxed);
+        appendLine(batch, used, best->slots[tail % RING_SLOTS]);
+        best->tail.store(tail + 1, std::memory_order_release);
+        written++;
+    }
+
+    if (used)
+        writeAll(batch.data(), used);
+
+    // Reclaim rings of exited threads once they are empty
+    {
+        std::lock_guard<std::mutex> lock(st.rings_mtx);
+        for (auto it = st.rings.begin(); it != st.rings.end(); )
+        {
+            LogRing* r = *it;
+            if (r->retired.load(std::memory_order_acquire)
+                && r->tail.load() == r->head.load()
+                && r->dropped.load() == r->dropped_reported)
+            {
+                delete r;
+                it = st.rings.erase(it);
+                continue;
+            }
+            ++it;
+        }
+    }
+
+    return written;
+}
+
+void drainThread()
+{
+    // Low priority by default (nice +10): logging must never compete with RX / frame threads
+    pthread_setname_np(pthread_self(), "hv_log");
+    hv::placement::apply(hv::placement::Role::LOGGER);
+
+    std::vector<char> batch(BATCH_BYTES);
+
+    while (state().running.load(std::memory_order_acquire))
+    {
+        if (drainOnce(batch) == 0)
+            std::this_thread::sleep_for(DRAIN_IDLE);
+    }
+
+    // Final drain after producers stopped
+    while (drainOnce(batch) > 0) {}
+}
+
+} // namespace
+
 
 void init()
 {
@@ -24,6 +263,22 @@ void init()
     //setvbuf(stderr, nullptr, _IONBF, 0);
 }
 
+void shutdown()
+{
+    AsyncState& st = state();
+
+    if (!st.accepting.exchange(false))
+        return;
+
+    // Late producers now fall back to sync; records already reserved are committed first
+    while (st.writers.load() != 0)
+        std::this_thread::yield();
+
+    st.running.store(false, std::memory_order_release);
+    if (st.drain.joinable())
+        st.drain.join();
+}
+
 void setLevel(Level level)
 {
     g_level.store(level, std::memory_order_relaxed);
@@ -39,6 +294,131 @@ void disable(uint32_t mask)
     g_module_mask.fetch_and(~mask, std::memory_order_relaxed);
 }
 
+void setBackend(Backend b)
+{
+    AsyncState& st = state();
+
+    if (b == Backend::Sync)
+    {
+        shutdown();
+        return;
+    }
+
+    if (st.running.exchange(true))
+        return;
+
+    st.drain = std::thread(drainThread);
+    st.accepting.store(true);
+
+    static bool atexit_registered = false;
+    if (!atexit_registered)
+    {
+        std::atexit(shutdown);
+        atexit_registered = true;
+    }
+}
+
+Backend backend()
+{
+    return state().running.load(std::memory_order_relaxed) ? Backend::Async
+                                                           : Backend::Sync;
+}
+
+uint64_t droppedMessages()
+{
+    return state().dropped_total.load(std::memory_order_relaxed);
+}
+
+namespace detail {
+
+bool asyncActive()
+{
+    return state().running.load(std::memory_order_relaxed);
+}
+
+bool enter()
+{
+    AsyncState& st = state();
+
+    // seq_cst pairs with shutdown(): either it sees this writer or we see the gate closed
+    st.writers.fetch_add(1);
+    if (st.accepting.load())
+        return true;
+
+    st.writers.fetch_sub(1, std::memory_order_release);
+    return false;
+}
+
+void leave()
+{
+    state().writers.fetch_sub(1, std::memory_order_release);
+}
+
+LogRecord* reserve()
+{
+    LogRing* r = threadRing();
+
+    uint64_t head = r->head.load(std::memory_order_relaxed);
+    if (head - r->tail.load(std::memory_order_acquire) >= RING_SLOTS)
+    {
+        r->dropped.store(r->dropped.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    LogRecord* rec = &r->slots[head % RING_SLOTS];
+    rec->ts_ns = nowNs();
+    return rec;
+}
+
+void commit(LogRecord*)
+{
+    LogRing* r = t_ring.ring;
+    r->head.store(r->head.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+    leave();
+}
+
+} // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/* Rate limiter registry                                                      */
+/*----------------------------------------------------------------------------*/
+static std::atomic<RateLimiter*> g_rl_head{nullptr};
+
+RateLimiter::RateLimiter(uint32_t rate_per_sec, uint32_t burst,
+                         const char* file, int line)
+    : interval_ns_(1000000000ull / (rate_per_sec ? rate_per_sec : 1)),
+      limit_ns_(interval_ns_ * (burst ? burst - 1 : 0)),
+      file_(file),
+      line_(line)
+{
+    RateLimiter* h = g_rl_head.load(std::memory_order_relaxed);
+    do {
+        next_ = h;
+    } while (!g_rl_head.compare_exchange_weak(h, this,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+RateLimiter* RateLimiter::head()
+{
+    return g_rl_head.load(std::memory_order_acquire);
+}
+
+void reportSuppressed()
+{
+    for (RateLimiter* rl = RateLimiter::head(); rl; rl = rl->next())
+    {
+        uint64_t n = rl->takeSuppressed();
+        if (n)
+            emit(Level::Warn, Module::All,
+                 "[RATE] %s:%d suppressed %llu messages",
+                 rl->file(), rl->line(),
+                 static_cast<unsigned long long>(n));
+    }
+}
+
 void log(Level level, uint32_t module, const char* fmt, ...)
 {
 
@@ -46,7 +426,7 @@ void log(Level level, uint32_t module, const char* fmt, ...)
    if (static_cast<uint8_t>(level) >
         static_cast<uint8_t>(g_level.load(std::memory_order_relaxed)))
         return;
-    
+
     /* Actual output only when reaching this point */
     if ((g_module_mask.load() & module) == 0)
         return;
@@ -59,4 +439,3 @@ void log(Level level, uint32_t module, const char* fmt, ...)
 }
 
 } // namespace hv::debug
-
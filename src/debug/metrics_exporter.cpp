@@ -0,0 +1,283 @@
+/*================================================================================*/
+/*  Metrics Exporter Source File                                                  */
+/*================================================================================*/
+
+
+#include "debug/metrics_exporter.hpp"
+#include "debug/debug_histogram.hpp"
+#include "debug/hv_debug.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace hv::stats {
+
+namespace {
+
+constexpr int      SAMPLE_PERIOD_MS  = 1000;
+constexpr int      REQUEST_WAIT_MS   = 50;
+
+void appendf(std::string& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string& out, const char* fmt, ...)
+{
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = std::vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > 0)
+        out.append(buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1));
+}
+
+void sendAll(int fd, const std::string& s)
+{
+    size_t off = 0;
+    while (off < s.size())
+    {
+        ssize_t n = ::send(fd, s.data() + off, s.size() - off, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        off += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+bool MetricsExporter::start(const std::string& socket_path)
+{
+    if (running_.load())
+        return true;
+
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path))
+    {
+        HV_LOGE(hv::debug::Module::RX, "[METRICS] socket path too long: %s", socket_path.c_str());
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+    {
+        perror("socket(AF_UNIX)");
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    ::unlink(socket_path.c_str());
+
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::listen(listen_fd_, 8) < 0)
+    {
+        perror("bind/listen(metrics)");
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    path_ = socket_path;
+    prev_ = snapshot();
+    running_.store(true);
+    thread_ = std::thread(&MetricsExporter::run, this);
+
+    HV_LOGI(hv::debug::Module::RX, "[METRICS] exporting on %s", path_.c_str());
+    return true;
+}
+
+void MetricsExporter::stop()
+{
+    if (!running_.exchange(false))
+        return;
+
+    if (thread_.joinable())
+        thread_.join();
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(path_.c_str());
+}
+
+void MetricsExporter::addSection(Section s)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    sections_.push_back(std::move(s));
+}
+
+void MetricsExporter::sample()
+{
+    Snapshot now = snapshot();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    double dt = (now.ts_ns - prev_.ts_ns) / 1e9;
+    if (dt > 0.0)
+    {
+        pps_ = (now.counters[RX_PACKETS] - prev_.counters[RX_PACKETS]) / dt;
+        bps_ = (now.counters[RX_BYTES]   - prev_.counters[RX_BYTES])   / dt;
+    }
+    prev_ = now;
+}
+
+std::string MetricsExporter::render(Format fmt)
+{
+    Snapshot s = snapshot();
+    std::string out;
+    out.reserve(2048);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (fmt == Format::Prometheus)
+    {
+        for (uint32_t c = 0; c < COUNTER_MAX; ++c)
+        {
+            const char* name = counterName(static_cast<Counter>(c));
+            appendf(out, "# TYPE hv_%s_total counter\nhv_%s_total %llu\n",
+                    name, name, static_cast<unsigned long long>(s.counters[c]));
+        }
+        for (uint32_t g = 0; g < GAUGE_MAX; ++g)
+        {
+            const char* name = gaugeName(static_cast<Gauge>(g));
+            appendf(out, "# TYPE hv_%s gauge\nhv_%s %lld\n",
+                    name, name, static_cast<long long>(s.gauges[g]));
+        }
+        appendf(out, "# TYPE hv_rx_pps gauge\nhv_rx_pps %.1f\n", pps_);
+        appendf(out, "# TYPE hv_rx_bytes_per_sec gauge\nhv_rx_bytes_per_sec %.1f\n", bps_);
+    }
+    else
+    {
+        out += "{";
+        appendf(out, "\"ts_ns\":%llu", static_cast<unsigned long long>(s.ts_ns));
+        for (uint32_t c = 0; c < COUNTER_MAX; ++c)
+            appendf(out, ",\"%s\":%llu", counterName(static_cast<Counter>(c)),
+                    static_cast<unsigned long long>(s.counters[c]));
+        for (uint32_t g = 0; g < GAUGE_MAX; ++g)
+            appendf(out, ",\"%s\":%lld", gaugeName(static_cast<Gauge>(g)),
+                    static_cast<long long>(s.gauges[g]));
+        appendf(out, ",\"rx_pps\":%.1f,\"rx_bytes_per_sec\":%.1f", pps_, bps_);
+    }
+
+    renderHistograms(fmt, out);
+
+    for (auto& sec : sections_)
+        sec(fmt, out);
+
+    if (fmt == Format::Json)
+        out += "}\n";
+
+    return out;
+}
+
+void MetricsExporter::renderHistograms(Format fmt, std::string& out)
+{
+    static const double kQuantiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    if (fmt == Format::Prometheus)
+        out += "# TYPE hv_latency_seconds summary\n";
+    else
+        out += ",\"latency_us\":{";
+
+    for (uint32_t h = 0; h < HIST_MAX; ++h)
+    {
+        HistogramSnapshot hs = histogramSnapshot(static_cast<Histogram>(h));
+        const char* stage = histogramName(static_cast<Histogram>(h));
+
+        if (fmt == Format::Prometheus)
+        {
+            for (double q : kQuantiles)
+                appendf(out, "hv_latency_seconds{stage=\"%s\",quantile=\"%g\"} %.9f\n",
+                        stage, q / 100.0, hs.percentile(q) / 1e9);
+            appendf(out, "hv_latency_seconds_sum{stage=\"%s\"} %.9f\n", stage, hs.sum / 1e9);
+            appendf(out, "hv_latency_seconds_count{stage=\"%s\"} %llu\n",
+                    stage, static_cast<unsigned long long>(hs.count));
+        }
+        else
+        {
+            appendf(out, "%s\"%s\":{\"count\":%llu,\"mean\":%.1f,\"p50\":%.1f,"
+                         "\"p90\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}",
+                    h ? "," : "", stage,
+                    static_cast<unsigned long long>(hs.count),
+                    hs.mean() / 1e3,
+                    hs.percentile(50.0) / 1e3, hs.percentile(90.0) / 1e3,
+                    hs.percentile(99.0) / 1e3, hs.percentile(99.9) / 1e3,
+                    hs.max / 1e3);
+        }
+    }
+
+    if (fmt == Format::Json)
+        out += "}";
+}
+
+void MetricsExporter::serve(int client)
+{
+    char req[256] = {0,};
+
+    // Optional request line; a bare connect gets Prometheus text
+    pollfd pfd{client, POLLIN, 0};
+    if (::poll(&pfd, 1, REQUEST_WAIT_MS) > 0)
+        ::recv(client, req, sizeof(req) - 1, MSG_DONTWAIT);
+
+    bool http = (std::strncmp(req, "GET ", 4) == 0);
+    bool json = (std::strstr(req, "json") != nullptr);
+
+    std::string body = render(json ? Format::Json : Format::Prometheus);
+
+    if (http)
+    {
+        std::string hdr;
+        appendf(hdr, "HTTP/1.0 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n",
+                json ? "application/json" : "text/plain; version=0.0.4",
+                body.size());
+        sendAll(client, hdr);
+    }
+    sendAll(client, body);
+}
+
+void MetricsExporter::run()
+{
+    auto next_sample = std::chrono::steady_clock::now()
+                     + std::chrono::milliseconds(SAMPLE_PERIOD_MS);
+
+    while (running_.load(std::memory_order_relaxed))
+    {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        int ret = ::poll(&pfd, 1, 100);
+
+        if (ret > 0 && (pfd.revents & POLLIN))
+        {
+            int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0)
+            {
+                serve(client);
+                ::close(client);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_sample)
+        {
+            sample();
+            next_sample = now + std::chrono::milliseconds(SAMPLE_PERIOD_MS);
+        }
+    }
+}
+
+} // namespace hv::stats
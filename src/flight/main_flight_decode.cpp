@@ -0,0 +1,273 @@
+/*=====================================================================================*/
+/*                     tm_flight_decode : flight recorder => trace JSON                */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Usage: tm_flight_decode <file.rec> [-o trace.json] [--last-ms N] [--no-packets]    */
+/*                                                                                     */
+/*  Writes Chrome trace event JSON (chrome://tracing, ui.perfetto.dev):                */
+/*   - one track per recording thread (RX, frame worker, ...)                          */
+/*   - frame assembly as duration slices, packets/drops/missing packets as instants    */
+/*  A per-thread summary goes to stderr.  Works on files of crashed processes.         */
+/*=====================================================================================*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "debug/flight_recorder.hpp"
+
+using namespace hv::trace;
+
+namespace {
+
+struct Track
+{
+    const RingHeader* ring;
+    const Event*      ev;
+    uint64_t          head;
+    uint64_t          first;        // oldest retained sequence number
+};
+
+void jsonEscape(FILE* fp, const char* s)
+{
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+            std::fputc('\\', fp);
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            std::fputc(*s, fp);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: tm_flight_decode <file.rec> [-o trace.json] [--last-ms N] [--no-packets]\n";
+        return -1;
+    }
+
+    std::string path = argv[1];
+    std::string out_path;
+    double      last_ms = 0.0;
+    bool        packets = true;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            out_path = argv[++i];
+        else if (arg == "--last-ms" && i + 1 < argc)
+            last_ms = std::stod(argv[++i]);
+        else if (arg == "--no-packets")
+            packets = false;
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return -1;
+        }
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        perror("open");
+        return -1;
+    }
+
+    struct stat st{};
+    fstat(fd, &st);
+    size_t size = static_cast<size_t>(st.st_size);
+
+    if (size < FILE_HEADER_SIZE)
+    {
+        std::cerr << "file too small for a flight recording\n";
+        ::close(fd);
+        return -1;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        perror("mmap");
+        return -1;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(map);
+    const FileHeader* fh = reinterpret_cast<const FileHeader*>(base);
+
+    if (fh->magic != FILE_MAGIC || fh->version != FILE_VERSION || fh->event_size != sizeof(Event))
+    {
+        std::cerr << "not a flight recording (magic/version mismatch)\n";
+        munmap(map, size);
+        return -1;
+    }
+
+    uint32_t threads = std::min(fh->threads_used.load(std::memory_order_acquire), fh->max_threads);
+    size_t need = FILE_HEADER_SIZE + threads * ringBytes(fh->ring_events);
+    if (size < need)
+    {
+        std::cerr << "truncated recording\n";
+        munmap(map, size);
+        return -1;
+    }
+
+    std::vector<Track> tracks;
+    uint64_t newest = 0;
+
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        const uint8_t* rb = base + FILE_HEADER_SIZE + t * ringBytes(fh->ring_events);
+
+        Track tr;
+        tr.ring  = reinterpret_cast<const RingHeader*>(rb);
+        tr.ev    = reinterpret_cast<const Event*>(rb + sizeof(RingHeader));
+        tr.head  = tr.ring->head.load(std::memory_order_acquire);
+        tr.first = (tr.head > fh->ring_events) ? tr.head - fh->ring_events : 0;
+
+        if (tr.head)
+            newest = std::max(newest, tr.ev[(tr.head - 1) & (fh->ring_events - 1)].ts_ns);
+
+        tracks.push_back(tr);
+    }
+
+    const uint64_t cutoff = (last_ms > 0.0 && newest > last_ms * 1e6)
+                          ? newest - static_cast<uint64_t>(last_ms * 1e6) : 0;
+
+    // Time origin: oldest retained event inside the window
+    uint64_t origin = UINT64_MAX;
+    for (const Track& tr : tracks)
+    {
+        for (uint64_t s = tr.first; s < tr.head; ++s)
+        {
+            const Event& e = tr.ev[s & (fh->ring_events - 1)];
+            if (e.ts_ns >= cutoff && e.type != EV_NONE && e.type < EV_TYPE_MAX)
+            {
+                origin = std::min(origin, e.ts_ns);
+                break;
+            }
+        }
+    }
+    if (origin == UINT64_MAX)
+        origin = fh->mono_base_ns;
+
+    FILE* fp = out_path.empty() ? stdout : std::fopen(out_path.c_str(), "w");
+    if (!fp)
+    {
+        perror("fopen");
+        munmap(map, size);
+        return -1;
+    }
+
+    const unsigned pid = fh->pid;
+    auto us = [origin](uint64_t ns) { return (static_cast<double>(ns) - origin) / 1e3; };
+
+    std::fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"pid\":%u,"
+                     "\"origin_monotonic_ns\":%" PRIu64 ",\"real_minus_mono_ns\":%" PRId64 "},\n"
+                     "\"traceEvents\":[\n",
+                 pid, origin,
+                 static_cast<int64_t>(fh->real_base_ns - fh->mono_base_ns));
+
+    std::fprintf(fp, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%u,\"args\":{\"name\":\"tm_receiver\"}}", pid);
+
+    uint64_t type_count[EV_TYPE_MAX] = {};
+    uint64_t skipped = 0;
+
+    for (const Track& tr : tracks)
+    {
+        unsigned tid = tr.ring->tid;
+
+        char name[sizeof(tr.ring->name) + 1] = {};
+        std::memcpy(name, tr.ring->name, sizeof(tr.ring->name));
+
+        std::fprintf(fp, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"", pid, tid);
+        jsonEscape(fp, name[0] ? name : "thread");
+        std::fprintf(fp, "\"}}");
+
+        for (uint64_t s = tr.first; s < tr.head; ++s)
+        {
+            const Event& e = tr.ev[s & (fh->ring_events - 1)];
+
+            if (e.type == EV_NONE || e.type >= EV_TYPE_MAX)
+            {
+                skipped++;          // torn slot (crash mid-write) or never written
+                continue;
+            }
+            if (e.ts_ns < cutoff)
+                continue;
+
+            type_count[e.type]++;
+
+            auto type = static_cast<EventType>(e.type);
+            switch (type)
+            {
+            case EV_RX_PACKET:
+                if (!packets)
+                    break;
+                std::fprintf(fp, ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"rx\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                 "\"args\":{\"frame\":%u,\"pkt\":%u,\"count\":%u,\"bytes\":%u}}",
+                             pid, tid, us(e.ts_ns), e.frame_id, e.packet_id, e.packet_count, e.arg0);
+                break;
+
+            case EV_FRAME_EMIT:
+            {
+                bool complete = (e.arg0 == e.packet_count);
+                double start = us(e.ts_ns >= e.arg1 ? e.ts_ns - e.arg1 : e.ts_ns);
+                std::fprintf(fp, ",\n{\"ph\":\"X\",\"name\":\"frame %u %s\",\"cat\":\"frame\",\"pid\":%u,\"tid\":%u,"
+                                 "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"received\":%u,\"expected\":%u,\"state\":%u}}",
+                             e.frame_id, complete ? "complete" : "partial", pid, tid,
+                             start, e.arg1 / 1e3, e.arg0, e.packet_count, e.flags);
+                break;
+            }
+
+            case EV_DIGEST_MISMATCH:
+                std::fprintf(fp, ",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":\"digest_mismatch\",\"pid\":%u,\"tid\":%u,"
+                                 "\"ts\":%.3f,\"args\":{\"frame\":%u,\"digest\":\"%016" PRIx64 "\"}}",
+                             pid, tid, us(e.ts_ns), e.frame_id, e.arg1);
+                break;
+
+            default:
+                std::fprintf(fp, ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                                 "\"args\":{\"frame\":%u,\"pkt\":%u,\"count\":%u,\"arg0\":%u,\"arg1\":%" PRIu64 "}}",
+                             eventName(type), pid, tid, us(e.ts_ns),
+                             e.frame_id, e.packet_id, e.packet_count, e.arg0, e.arg1);
+                break;
+            }
+        }
+
+        uint64_t kept = tr.head - tr.first;
+        double span_ms = kept ? (tr.ev[(tr.head - 1) & (fh->ring_events - 1)].ts_ns
+                                 - tr.ev[tr.first & (fh->ring_events - 1)].ts_ns) / 1e6 : 0.0;
+        std::fprintf(stderr, "[FLIGHT] thread %-15s tid=%-7u recorded=%-10" PRIu64 " retained=%-9" PRIu64 " span=%.1fms\n",
+                     name[0] ? name : "?", tid, tr.head, kept, span_ms);
+    }
+
+    std::fprintf(fp, "\n]}\n");
+    if (fp != stdout)
+        std::fclose(fp);
+
+    for (uint32_t t = 1; t < EV_TYPE_MAX; ++t)
+    {
+        if (type_count[t])
+            std::fprintf(stderr, "[FLIGHT] %-16s %" PRIu64 "\n",
+                         eventName(static_cast<EventType>(t)), type_count[t]);
+    }
+    if (skipped)
+        std::fprintf(stderr, "[FLIGHT] skipped %" PRIu64 " invalid slots\n", skipped);
+
+    munmap(map, size);
+    return 0;
+}
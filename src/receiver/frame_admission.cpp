@@ -0,0 +1,185 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame-Aware Admission                           */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <cstring>
+
+#include "receiver/frame_admission.hpp"
+
+#include "debug/debug_stats.hpp"
+#include "debug/flight_recorder.hpp"
+#include "debug/hv_debug.hpp"
+
+
+bool parseShedPolicy(const char* s, ShedPolicy& out)
+{
+    if (std::strcmp(s, "tail") == 0)
+        out = ShedPolicy::TAIL;
+    else if (std::strcmp(s, "newest") == 0)
+        out = ShedPolicy::NEWEST;
+    else if (std::strcmp(s, "every-nth") == 0)
+        out = ShedPolicy::EVERY_NTH;
+    else
+        return false;
+    return true;
+}
+
+const char* shedPolicyName(ShedPolicy p)
+{
+    switch (p)
+    {
+    case ShedPolicy::TAIL:      return "tail";
+    case ShedPolicy::NEWEST:    return "newest";
+    case ShedPolicy::EVERY_NTH: return "every-nth";
+    }
+    return "unknown";
+}
+
+
+/*-------------------------------------------*/
+/* Frame table                               */
+/*-------------------------------------------*/
+FrameAdmission::Slot* FrameAdmission::find(const UdpPacketHeader& hdr,
+                                           uint32_t src_ip, uint16_t src_port)
+{
+    auto match = [&](const Slot& s)
+    {
+        return s.used && s.frame_id == hdr.frame_id && s.stream_id == hdr.stream_id
+            && s.src_ip == src_ip && s.src_port == src_port;
+    };
+
+    if (last_ && match(*last_))
+        return last_;
+
+    for (Slot& s : slots_)
+    {
+        if (match(s))
+            return last_ = &s;
+    }
+    return nullptr;
+}
+
+FrameAdmission::Slot& FrameAdmission::insert(const UdpPacketHeader& hdr,
+                                             uint32_t src_ip, uint16_t src_port)
+{
+    // Free slot, or the least recently seen frame (long gone or stalled)
+    Slot* victim = &slots_[0];
+    for (Slot& s : slots_)
+    {
+        if (!s.used)
+        {
+            victim = &s;
+            break;
+        }
+        if (s.last_seen < victim->last_seen)
+            victim = &s;
+    }
+
+    *victim = Slot{};
+    victim->used         = true;
+    victim->frame_id     = hdr.frame_id;
+    victim->stream_id    = hdr.stream_id;
+    victim->src_ip       = src_ip;
+    victim->src_port     = src_port;
+    victim->packet_count = hdr.packet_count;
+    return *(last_ = victim);
+}
+
+void FrameAdmission::shed(Slot& s, const char* why)
+{
+    s.shed = true;
+
+    hv::stats::add(hv::stats::SHED_FRAMES);
+    hv::trace::record(hv::trace::EV_FRAME_SHED, s.frame_id, 0,
+                      s.packet_count, 0, s.admitted);
+    HV_LOGW_RL(hv::debug::Module::RX, 1, 10, "[SHED] frame=%u stream=%u %s (%u/%u admitted)",
+               s.frame_id, s.stream_id, why, s.admitted, s.packet_count);
+}
+
+
+/*-------------------------------------------*/
+/* Admission                                 */
+/*-------------------------------------------*/
+bool FrameAdmission::admit(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port,
+                           size_t depth, size_t capacity)
+{
+    if (cfg_.policy == ShedPolicy::TAIL)
+        return true;
+
+    // Hysteresis between the two watermarks
+    size_t fill_pct = capacity ? depth * 100 / capacity : 0;
+    if (!pressure_ && fill_pct >= cfg_.high_pct)
+        pressure_ = true;
+    else if (pressure_ && fill_pct <= cfg_.low_pct)
+        pressure_ = false;
+
+    Slot* s = find(hdr, src_ip, src_port);
+    if (!s)
+    {
+        s = &insert(hdr, src_ip, src_port);
+
+        if (pressure_)
+        {
+            bool drop = (cfg_.policy == ShedPolicy::NEWEST)
+                     || (cfg_.every_n && (new_frames_ % cfg_.every_n) == 0);
+            new_frames_++;
+            if (drop)
+                shed(*s, "new frame under queue pressure");
+        }
+    }
+
+    s->last_seen = ++seq_;
+
+    if (s->shed)
+    {
+        hv::stats::add(hv::stats::SHED_PACKETS);
+        return false;
+    }
+
+    // Last packet admitted: the slot is free for the next frame
+    if (++s->admitted >= s->packet_count)
+    {
+        s->used = false;
+        last_ = nullptr;
+    }
+    return true;
+}
+
+void FrameAdmission::onQueueFull(const UdpPacketHeader& hdr, uint32_t src_ip, uint16_t src_port)
+{
+    if (cfg_.policy == ShedPolicy::TAIL)
+        return;
+
+    pressure_ = true;
+
+    // Counted by admit(), but never made it into the queue
+    if (Slot* own = find(hdr, src_ip, src_port))
+    {
+        if (own->admitted)
+            own->admitted--;
+    }
+
+    // This frame lost a packet; abandon the frame that has least to lose,
+    // as long as it is not nearly complete, to make room for the others
+    Slot* victim = nullptr;
+    uint64_t victim_pct = 0;
+    for (Slot& s : slots_)
+    {
+        if (!s.used || s.shed || s.packet_count == 0)
+            continue;
+
+        uint64_t pct = uint64_t{s.admitted} * 100 / s.packet_count;
+        if (pct >= cfg_.protect_pct)
+            continue;
+        if (!victim || pct < victim_pct)
+        {
+            victim = &s;
+            victim_pct = pct;
+        }
+    }
+
+    // None => every frame in flight is protected: the loss stays on this one
+    if (victim)
+        shed(*victim, "queue full");
+}
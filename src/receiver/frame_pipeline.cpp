@@ -0,0 +1,361 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Frame Consumer Pipeline                         */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <pthread.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "receiver/frame_pipeline.hpp"
+
+#include "common/thread_placement.hpp"
+
+#include "debug/debug_stats.hpp"
+#include "debug/hv_debug.hpp"
+
+
+namespace {
+
+void addSample(hv::stats::HistogramSnapshot& h, uint64_t ns)
+{
+    h.buckets[hv::stats::histBucket(ns)]++;
+    h.count++;
+    h.sum += ns;
+    h.max = std::max(h.max, ns);
+}
+
+} // namespace
+
+
+bool parseStagePolicy(const std::string& s, StagePolicy& out)
+{
+    if (s == "block")            out = StagePolicy::BLOCK;
+    else if (s == "drop-oldest") out = StagePolicy::DROP_OLDEST;
+    else if (s == "drop-newest") out = StagePolicy::DROP_NEWEST;
+    else return false;
+    return true;
+}
+
+const char* stagePolicyName(StagePolicy p)
+{
+    switch (p)
+    {
+    case StagePolicy::BLOCK:       return "block";
+    case StagePolicy::DROP_OLDEST: return "drop-oldest";
+    case StagePolicy::DROP_NEWEST: return "drop-newest";
+    default:                       return "unknown";
+    }
+}
+
+
+FramePipeline::~FramePipeline()
+{
+    stop();
+}
+
+void FramePipeline::addStage(const StageConfig& cfg)
+{
+    if (running_)
+        return;
+
+    auto s = std::make_unique<Stage>();
+    s->cfg = cfg;
+    s->cfg.queue_depth = std::max<size_t>(1, cfg.queue_depth);
+    stages_.push_back(std::move(s));
+}
+
+bool FramePipeline::start()
+{
+    if (running_)
+        return false;
+
+    stop_.store(false, std::memory_order_relaxed);
+
+    bool use_pool = false;
+    for (auto& sp : stages_)
+    {
+        Stage& s = *sp;
+        if (s.cfg.threads == 0)
+        {
+            use_pool = true;
+            continue;
+        }
+        for (uint32_t t = 0; t < s.cfg.threads; ++t)
+            s.threads.emplace_back(&FramePipeline::stageLoop, this, std::ref(s));
+    }
+
+    if (use_pool)
+    {
+        for (uint32_t t = 0; t < std::max<uint32_t>(1, pool_threads_); ++t)
+            pool_.emplace_back(&FramePipeline::poolLoop, this);
+    }
+
+    for (const auto& sp : stages_)
+        HV_LOGI(hv::debug::Module::FRAME, "[PIPE] stage %s depth=%zu policy=%s threads=%u%s",
+                sp->cfg.name.c_str(), sp->cfg.queue_depth, stagePolicyName(sp->cfg.policy),
+                sp->cfg.threads, sp->cfg.threads ? "" : " (pool)");
+
+    running_ = true;
+    return true;
+}
+
+void FramePipeline::stop()
+{
+    if (!running_)
+        return;
+
+    // Under each lock: no waiter can miss the flag between its check and its wait
+    stop_.store(true, std::memory_order_release);
+    for (auto& sp : stages_)
+    {
+        {
+            std::lock_guard<std::mutex> lk(sp->mtx);
+        }
+        sp->not_empty.notify_all();
+        sp->not_full.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lk(pool_mtx_);
+    }
+    pool_cv_.notify_all();
+
+    for (auto& sp : stages_)
+    {
+        for (std::thread& t : sp->threads)
+            t.join();
+        sp->threads.clear();
+    }
+    for (std::thread& t : pool_)
+        t.join();
+    pool_.clear();
+
+    running_ = false;
+}
+
+
+/*-------------------------------------------*/
+/* Fan-out (reassembly thread)               */
+/*-------------------------------------------*/
+void FramePipeline::submit(const FrameResult& r)
+{
+    if (stages_.empty())
+        return;
+
+    Job job;
+    job.result = r;
+    job.submit_ns = hv::stats::monotonicNs();
+
+    // Not backed by a handle (plain pointer): one copy, shared by every stage
+    if (!job.result.buffer && r.frame_size)
+    {
+        job.result.buffer = FrameHandle::allocate(r.frame_size);
+        std::memcpy(job.result.buffer.data(), r.frame_data, r.frame_size);
+        job.result.frame_data = job.result.buffer.data();
+    }
+
+    for (auto& sp : stages_)
+    {
+        Stage& s = *sp;
+        bool queued = true;
+        {
+            std::unique_lock<std::mutex> lk(s.mtx);
+            s.submitted++;
+
+            if (s.queue.size() >= s.cfg.queue_depth)
+            {
+                switch (s.cfg.policy)
+                {
+                case StagePolicy::BLOCK:
+                {
+                    uint64_t t0 = hv::stats::monotonicNs();
+                    s.not_full.wait(lk, [&] {
+                        return s.queue.size() < s.cfg.queue_depth
+                            || stop_.load(std::memory_order_relaxed);
+                    });
+                    s.blocked_ns += hv::stats::monotonicNs() - t0;
+
+                    // Woken by stop(): the stage threads may already have exited
+                    if (stop_.load(std::memory_order_relaxed))
+                        return;
+                    break;
+                }
+                case StagePolicy::DROP_OLDEST:
+                    s.queue.pop_front();
+                    s.dropped++;
+                    hv::stats::add(hv::stats::STAGE_DROPS);
+                    break;
+                case StagePolicy::DROP_NEWEST:
+                    s.dropped++;
+                    hv::stats::add(hv::stats::STAGE_DROPS);
+                    queued = false;
+                    break;
+                }
+            }
+
+            if (queued)
+                s.queue.push_back(job);
+        }
+
+        if (!queued)
+        {
+            HV_LOGW_RL(hv::debug::Module::FRAME, 1, 5, "[PIPE] stage %s full, frame=%u dropped",
+                       s.cfg.name.c_str(), r.frame_id);
+            continue;
+        }
+
+        if (s.cfg.threads)
+            s.not_empty.notify_one();
+        else
+            notifyPool();
+    }
+}
+
+void FramePipeline::notifyPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(pool_mtx_);
+        pool_seq_++;
+    }
+    pool_cv_.notify_one();
+}
+
+
+/*-------------------------------------------*/
+/* Stage execution                           */
+/*-------------------------------------------*/
+void FramePipeline::run(Stage& s, Job& job)
+{
+    uint64_t start = hv::stats::monotonicNs();
+
+    if (s.cfg.fn)
+        s.cfg.fn(job.result);
+
+    uint64_t end = hv::stats::monotonicNs();
+
+    std::lock_guard<std::mutex> lk(s.mtx);
+    s.processed++;
+    addSample(s.dwell, start - job.submit_ns);
+    addSample(s.service, end - start);
+}
+
+void FramePipeline::stageLoop(Stage& s)
+{
+    char name[16];
+    std::snprintf(name, sizeof(name), "hv_st_%s", s.cfg.name.c_str());
+    pthread_setname_np(pthread_self(), name);
+    hv::placement::apply(hv::placement::Role::WRITER);
+
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(s.mtx);
+            s.not_empty.wait(lk, [&] {
+                return !s.queue.empty() || stop_.load(std::memory_order_relaxed);
+            });
+
+            // Stop only once the queue is drained
+            if (s.queue.empty())
+                break;
+
+            job = std::move(s.queue.front());
+            s.queue.pop_front();
+        }
+        s.not_full.notify_one();
+
+        run(s, job);
+    }
+}
+
+void FramePipeline::poolLoop()
+{
+    pthread_setname_np(pthread_self(), "hv_st_pool");
+    hv::placement::apply(hv::placement::Role::WRITER);
+
+    for (;;)
+    {
+        uint64_t seen;
+        {
+            std::lock_guard<std::mutex> lk(pool_mtx_);
+            seen = pool_seq_;
+        }
+
+        // Take from any idle pool stage; a busy stage is left to its current thread,
+        // which rescans after each job
+        bool did = false;
+        for (auto& sp : stages_)
+        {
+            Stage& s = *sp;
+            if (s.cfg.threads)
+                continue;
+
+            Job job;
+            {
+                std::lock_guard<std::mutex> lk(s.mtx);
+                if (s.busy || s.queue.empty())
+                    continue;
+                job = std::move(s.queue.front());
+                s.queue.pop_front();
+                s.busy = true;
+            }
+            s.not_full.notify_one();
+
+            run(s, job);
+
+            {
+                std::lock_guard<std::mutex> lk(s.mtx);
+                s.busy = false;
+            }
+            did = true;
+        }
+
+        if (did)
+            continue;
+
+        std::unique_lock<std::mutex> lk(pool_mtx_);
+        if (stop_.load(std::memory_order_relaxed))
+            break;
+        pool_cv_.wait(lk, [&] {
+            return pool_seq_ != seen || stop_.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+
+/*-------------------------------------------*/
+/* Stats (any thread)                        */
+/*-------------------------------------------*/
+std::vector<StageStats> FramePipeline::stats() const
+{
+    std::vector<StageStats> out;
+    out.reserve(stages_.size());
+
+    for (const auto& sp : stages_)
+    {
+        const Stage& s = *sp;
+        std::lock_guard<std::mutex> lk(s.mtx);
+        out.push_back(StageStats{s.cfg.name, s.cfg.policy,
+                                 s.submitted, s.processed, s.dropped, s.blocked_ns,
+                                 s.queue.size(), s.dwell, s.service});
+    }
+    return out;
+}
+
+void FramePipeline::logStats() const
+{
+    for (const StageStats& st : stats())
+    {
+        HV_LOGI(hv::debug::Module::FRAME, "[PIPE] %s processed=%llu dropped=%llu blocked=%.1fms",
+                st.name.c_str(),
+                static_cast<unsigned long long>(st.processed),
+                static_cast<unsigned long long>(st.dropped),
+                st.blocked_ns / 1e6);
+        HV_LOGI(hv::debug::Module::FRAME, "[PIPE] %s dwell p99=%.1fus service p50=%.1fus p99=%.1fus",
+                st.name.c_str(),
+                st.dwell.percentile(99.0) / 1e3,
+                st.service.percentile(50.0) / 1e3,
+                st.service.percentile(99.0) / 1e3);
+    }
+}
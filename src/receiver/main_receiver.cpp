@@ -5,31 +5,35 @@
 
 #include <arpa/inet.h>
 #include <unistd.h>
-#include <cstring>
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <thread>
 #include <vector>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 
-#include "debug/debug_log.hpp"
+#include "debug/flight_recorder.hpp"
 #include "debug/debug_stats.hpp"
 #include "debug/hv_debug.hpp"
+#include "debug/metrics_exporter.hpp"
+#include "debug/debug_histogram.hpp"
 
-#include "protocol/udp_packet.hpp"
-#include "protocol/frame_header.hpp"
-
+#include "common/frame_recorder.hpp"
 #include "common/frame_writer.hpp"
-#include "common/packet_queue.hpp"
-#include "common/frame_reassembler_v2.hpp"
-#include "common/frame_reassembler_manager.hpp"
+#include "common/frame_result.hpp"
+#include "common/thread_placement.hpp"
+#include "common/wait_strategy.hpp"
+
+#include "receiver/frame_pipeline.hpp"
+#include "receiver/rx_capture.hpp"
+#include "receiver/rx_control.hpp"
+#include "receiver/rx_pipeline.hpp"
 
 
+#include <cerrno>
 #include <cstdlib>
 #include <csignal>
 #include <atomic>
-#include <poll.h>
 
 
 /* ================================
@@ -37,205 +41,301 @@
  * ================================ */
 static std::atomic<bool> g_shutdown{false};
 
-constexpr size_t MAX_QUEUE_SIZE  = 4096 * 4;        // Queue capacity
-constexpr size_t MAX_FRAME_SIZE  = 4096 * 2160 * 2; // Ex: 4K RAW
-constexpr size_t PAYLOAD_STRIDE  = 1400;            // UDP payload size
-static constexpr int PACKET_BURST_LIMIT = 1295;
 
 /* ================================
- * Thread-safe Queue
+ * Signal Handler
  * ================================ */
 
- PacketQueue packet_queue(MAX_QUEUE_SIZE);
 
+static void on_signal(int)
+{
+    g_shutdown.store(true, std::memory_order_relaxed);
+}
 
 
 /* ================================
- *  UDP RX Thread (recvfrom ONLY)
+ * Numeric option values
+ *  decimal, the whole string, within [lo, hi] (std::sto* would throw on a typo)
  * ================================ */
-void udp_rx_thread(int sock, PacketQueue& queue) 
+static bool parse_uint(const std::string& value, uint64_t lo, uint64_t hi, uint64_t& out)
 {
-    uint8_t buf[2048] = {0,};
-
-    struct pollfd pfd;
-    pfd.fd = sock;
-    pfd.events = POLLIN;
-
-    //static uint32_t last_frame_id   = 0;
-    //static uint16_t last_packet_id  = 0;
-    //static bool     have_last       = false;
-    //static bool     gap_reported_in_frame = false;
+    if (value.empty() || value[0] < '0' || value[0] > '9')
+        return false;
 
-    sched_param sch{};
-    sch.sched_priority = 80; // root 
-    pthread_setschedparam(pthread_self(), SCHED_FIFO, &sch);
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long n = std::strtoull(value.c_str(), &end, 10);
+    if (errno || *end != '\0' || n < lo || n > hi)
+        return false;
 
-	HV_LOGI(hv::debug::Module::RX, "##udp_rx_thread created...");
+    out = n;
+    return true;
+}
 
-    while (!g_shutdown.load(std::memory_order_relaxed))
+// "a:b:c" => {"a", "b", "c"} (empty fields kept, so "8::" fails parse_uint)
+static std::vector<std::string> split_fields(const std::string& value, char sep = ':')
+{
+    std::vector<std::string> out;
+    size_t pos = 0;
+    for (;;)
     {
-        int ret = poll(&pfd, 1, 100); // 100ms timeout
-
-        if (ret < 0)
-        {
-            // EINTR etc. => After checking the termination flag, retry
-            if (errno == EINTR)
-                continue;
-            
-            perror("poll");
-            break;
-        }
-        if (ret == 0)
-        {
-            // timeout => shutdown Just checking continue
-            continue;
-        }
-
-        if (pfd.revents & POLLIN)
-        {
-            ssize_t len = recvfrom(sock, buf, sizeof(buf), 0, nullptr, nullptr);
-            if (len <= (ssize_t)sizeof(UdpPacketHeader))
-                continue;
-            
-            auto pkt = std::make_unique<RxPacket>();
-            
-            // Copy header data
-            std::memcpy(&pkt->hdr, buf, sizeof(UdpPacketHeader));
-
-            // payload size sanity check
-            if (pkt->hdr.payload_size > len - sizeof(UdpPacketHeader))
-                continue;
-
-            debug_log::rx_packet(len);
-               
-            pkt->gap_before = false;
-            
-    #ifdef DEBUG_LOG_ENABLE            
-            debug_log::PacketTraceEntry te;
-            te.seq          = 0;  // Internal overwriting (placeholder)
-            te.frame_id     = pkt->hdr.frame_id;
-            te.packet_id    = pkt->hdr.packet_id;
-            te.packet_count = pkt->hdr.packet_count;
-            te.payload_size = pkt->hdr.payload_size;
-            te.flags        = 1; //te.flags        = gap_detected ? TRACE_FLAG_GAP : 0;
-
-            debug_log::trace_packet(te);
-#if 0
-            if (gap_detected && !gap_reported_in_frame) 
-            {
-                HV_LOGW(hv::debug::Module::RX,
-                        "Packet gap detected: frame=%u last_pkt=%u curr_pkt=%u",
-                        pkt->hdr.frame_id,
-                        last_packet_id,
-                        pkt->hdr.packet_id);
-
-                gap_reported_in_frame = true;
-            }
-#endif   
-    #endif
-            // payload Copy
-            std::memcpy(pkt->payload,
-                        buf + sizeof(UdpPacketHeader),
-                        pkt->hdr.payload_size);
-
-            //  Move ownership to the queue.
-            queue.push(std::move(pkt));
-
-        }
+        size_t next = value.find(sep, pos);
+        out.push_back(value.substr(pos, next - pos));
+        if (next == std::string::npos)
+            return out;
+        pos = next + 1;
     }
+}
 
-    HV_LOGI(hv::debug::Module::RX, "udp_rx_thread exiting!!!");
+template <typename T>
+static bool parse_uint_arg(const std::string& opt, const std::string& value,
+                           uint64_t lo, uint64_t hi, T& out)
+{
+    uint64_t n = 0;
+    if (!parse_uint(value, lo, hi, n))
+    {
+        std::cerr << "Invalid " << opt << " value: " << value
+                  << " (" << lo << ".." << hi << ")\n";
+        return false;
+    }
+    out = static_cast<T>(n);
+    return true;
 }
 
+
 /* ================================
- * Frame Worker Thread
- *  - FrameReassemblerManager
+ * Thread placement options
+ *  --cpus rx=2-3  --sched rx=fifo:80  --nice logger=10  --irq eth0=2
  * ================================ */
-void frame_worker_thread(PacketQueue& queue)
+static bool parse_placement_arg(const std::string& opt,
+                                const std::string& value,
+                                hv::placement::Config& cfg)
 {
-    FrameReassemblerManager manager(MAX_FRAME_SIZE, PAYLOAD_STRIDE);
+    size_t eq = value.find('=');
+    if (eq == std::string::npos)
+        return false;
+
+    std::string key = value.substr(0, eq);
+    std::string val = value.substr(eq + 1);
 
-    manager.onFrameDone = [](const FrameResult& r)
+    if (opt == "--irq")
     {
-        write_frame_to_file(r.frame_data,
-                            r.frame_size,
-                            r.state == FrameState::PARTIAL);
-    };
+        hv::placement::IrqHint h;
+        h.pattern = key;
+        if (!hv::placement::parseCpuList(val, h.cpus) || h.cpus.empty())
+            return false;
+        cfg.irq.push_back(h);
+        return true;
+    }
+
+    hv::placement::Role role;
+    if (!hv::placement::parseRole(key, role))
+        return false;
 
-    auto last_timer = std::chrono::steady_clock::now();
+    hv::placement::RoleConfig& rc = cfg.role[static_cast<size_t>(role)];
 
-    static auto reminder_start = std::chrono::steady_clock::time_point{};
+    if (opt == "--cpus")
+        return hv::placement::parseCpuList(val, rc.cpus) && !rc.cpus.empty();
 
-    while (true)
+    if (opt == "--sched")
     {
+        rc.set_sched = hv::placement::parsePolicy(val, rc.policy, rc.priority);
+        return rc.set_sched;
+    }
 
-         //blocking pop (CPU 0% idle)
-        std::unique_ptr<RxPacket> pkt;
+    // --nice: signed, so not parse_uint
+    char* end = nullptr;
+    errno = 0;
+    long n = std::strtol(val.c_str(), &end, 10);
+    if (val.empty() || errno || *end != '\0' || n < -20 || n > 19)
+        return false;
 
+    rc.nice     = static_cast<int>(n);
+    rc.set_nice = true;
+    return true;
+}
 
-        // ? shutdown-aware blocking pop
-        bool got = queue.pop_until(
-            pkt,
-            std::chrono::milliseconds(1),
-            g_shutdown
-        );
 
-        if (got)
-        {
-            size_t queue_now = queue.dropped();
-            manager.pushPacket(*pkt, queue_now);
-        }  
-        
-        //Timer processing
-        auto now = std::chrono::steady_clock::now();
-        if (now - last_timer >= std::chrono::milliseconds(5))
-        {
-            manager.pollTimers(queue.dropped());
-            last_timer = now;
-        }
+/* ================================
+ * Per-stream settings
+ *  --stream 3=16:50:4000          stream id 3: 16 MB frames, 50 ms idle, 4 s lifetime
+ *  --stream 10.0.0.7:5000=8       source address (--demux source)
+ * ================================ */
+static bool parse_stream_arg(const std::string& value,
+                             std::map<uint64_t, StreamConfig>& streams)
+{
+    size_t eq = value.find('=');
+    if (eq == std::string::npos)
+        return false;
 
-        //Termination condition
-        if (g_shutdown.load() 
-                && queue.empty())
-        {
-            if (reminder_start.time_since_epoch().count() == 0)
-                reminder_start = std::chrono::steady_clock::now();
+    std::string key = value.substr(0, eq);
+    std::string val = value.substr(eq + 1);
 
-            if (std::chrono::steady_clock::now() - reminder_start
-                > std::chrono::milliseconds(100))
-                break;
-        }
+    uint64_t k;
+    size_t colon = key.find(':');
+    if (colon != std::string::npos)
+    {
+        in_addr addr{};
+        uint64_t port = 0;
+        if (inet_pton(AF_INET, key.substr(0, colon).c_str(), &addr) != 1
+            || !parse_uint(key.substr(colon + 1), 1, 65535, port))
+            return false;
+        k = StreamDemux::sourceKey(addr.s_addr, htons(static_cast<uint16_t>(port)));
+    }
+    else if (!parse_uint(key, 0, 65535, k))      // v2 header stream_id
+    {
+        return false;
+    }
+
+    // Same bounds as the control socket: 256 MB frames, 600 s deadlines
+    std::vector<std::string> f = split_fields(val);
+    uint64_t mb = 0, idle = 0, life = 0;
+    if (f.size() > 3
+        || !parse_uint(f[0], 0, 256, mb)
+        || (f.size() > 1 && !parse_uint(f[1], 0, 600000, idle))
+        || (f.size() > 2 && !parse_uint(f[2], 0, 600000, life)))
+        return false;
+
+    StreamConfig sc;
+    sc.max_frame_size  = static_cast<size_t>(mb) << 20;
+    sc.idle_timeout_ms = static_cast<uint32_t>(idle);
+    sc.lifetime_ms     = static_cast<uint32_t>(life);
+    streams[k] = sc;
+    return true;
+}
 
-        // CPU yield
-        std::this_thread::yield();
+
+/* ================================
+ * Frame timeouts
+ *  --timeouts fixed                    30 ms idle / 8 s lifetime
+ *  --timeouts adaptive[:min:max]       learned idle deadline, clamped to [min, max] ms
+ * ================================ */
+static bool parse_timeouts_arg(const std::string& value, TimeoutConfig& cfg)
+{
+    if (value == "fixed")
+    {
+        cfg.adaptive = false;
+        return true;
     }
-    
-    // Forced flush at termination 
-    HV_LOGI(hv::debug::Module::FRAME, "frame_worker_thread exiting");
+    if (value.compare(0, 8, "adaptive") != 0)
+        return false;
+
+    cfg.adaptive = true;
+    if (value.size() == 8)
+        return true;
+
+    // Same bound as the control socket's deadlines (600 s)
+    std::vector<std::string> f = split_fields(value.substr(8));
+    uint64_t lo = 0, hi = 0;
+    if (f.size() != 3 || !f[0].empty()
+        || !parse_uint(f[1], 1, 600000, lo)
+        || !parse_uint(f[2], lo, 600000, hi))
+        return false;
+
+    cfg.idle_min = std::chrono::milliseconds(lo);
+    cfg.idle_max = std::chrono::milliseconds(hi);
+    return true;
+}
 
-    manager.flushAll();
 
+/* ================================
+ * Overload shedding (socket ingress)
+ *  --shed newest                       drop frames starting under pressure
+ *  --shed every-nth:3:80:40            1 of 3 new frames, high / low watermark %
+ * ================================ */
+static bool parse_shed_arg(const std::string& value, AdmissionConfig& cfg)
+{
+    std::vector<std::string> f = split_fields(value);
+    uint64_t n = cfg.every_n, high = cfg.high_pct, low = cfg.low_pct;
+    if (f.size() > 4
+        || !parseShedPolicy(f[0].c_str(), cfg.policy)
+        || (f.size() > 1 && !parse_uint(f[1], 1, 1u << 16, n))
+        || (f.size() > 2 && !parse_uint(f[2], 1, 100, high))
+        || (f.size() > 3 && !parse_uint(f[3], 0, 99, low)))
+        return false;
+    if (low >= high)
+        return false;
+
+    cfg.every_n  = static_cast<uint32_t>(n);
+    cfg.high_pct = static_cast<uint32_t>(high);
+    cfg.low_pct  = static_cast<uint32_t>(low);
+    return true;
 }
 
+
 /* ================================
- * Signal Handler
+ * Frame assembly copy
+ *  --copy nt                           non-temporal stores for every payload
+ *  --copy auto:512                     non-temporal from 512 bytes (default 1024)
  * ================================ */
+static bool parse_copy_arg(const std::string& value, hv::copy::Config& cfg)
+{
+    size_t colon = value.find(':');
+    if (!hv::copy::parseMode(value.substr(0, colon), cfg.mode))
+        return false;
+    uint64_t min = cfg.stream_min;
+    if (colon != std::string::npos && !parse_uint(value.substr(colon + 1), 0, 1u << 30, min))
+        return false;
+    cfg.stream_min = min;
+    return true;
+}
 
 
-static void on_signal(int)
+/* ================================
+ * Recording codec
+ *  --compress lz4                      built-in LZ4, 2 helper threads, 256 KB chunks
+ *  --compress zstd:3:1024              codec, helper threads, chunk KB
+ * ================================ */
+static bool parse_compress_arg(const std::string& value, RecorderConfig& cfg)
 {
-#ifdef DEBUG_LOG_ENABLE
-    //debug_log::dump_ring("packet_trace.log");
-#endif
-    g_shutdown.store(true, std::memory_order_relaxed);
+    // Helpers besides the caller: no more than the machine has cores
+    uint64_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> f = split_fields(value);
+    uint64_t threads = cfg.threads, chunk_kb = cfg.chunk_size / 1024;
+    if (f.size() > 3
+        || !parseFrameCodec(f[0].c_str(), cfg.codec)
+        || (f.size() > 1 && !parse_uint(f[1], 0, max_threads, threads))
+        || (f.size() > 2 && !parse_uint(f[2], 4, 64 * 1024, chunk_kb)))
+        return false;
+
+    cfg.threads    = static_cast<uint32_t>(threads);
+    cfg.chunk_size = static_cast<size_t>(chunk_kb) * 1024;
+    return true;
 }
 
 
-static void on_exit_dump()
+/* ================================
+ * Consumer stages
+ *  --stage writer=16:drop-oldest       queue depth, overflow policy
+ *  --stage stats=8:block:0             0 threads => shared pool (--stage-pool)
+ * ================================ */
+static bool parse_stage_arg(const std::string& value,
+                            std::map<std::string, StageConfig>& stages)
 {
-#ifdef DEBUG_LOG_ENABLE
-    debug_log::dump_ring("packet_trace.log");
-#endif
+    size_t eq = value.find('=');
+    if (eq == std::string::npos)
+        return false;
+
+    auto it = stages.find(value.substr(0, eq));
+    if (it == stages.end())
+        return false;
+
+    StageConfig& sc = it->second;
+    std::string val = value.substr(eq + 1);
+
+    // depth 1..65536 frames, threads 0 (shared pool) .. 64 like --stage-pool
+    std::vector<std::string> f = split_fields(val);
+    uint64_t depth = 0, threads = sc.threads;
+    if (f.size() > 3
+        || !parse_uint(f[0], 1, 65536, depth)
+        || (f.size() > 1 && !parseStagePolicy(f[1], sc.policy))
+        || (f.size() > 2 && !parse_uint(f[2], 0, 64, threads)))
+        return false;
+
+    sc.queue_depth = static_cast<size_t>(depth);
+    sc.threads     = static_cast<uint32_t>(threads);
+    return true;
 }
 
 
@@ -245,84 +345,513 @@ static void on_exit_dump()
 int main(int argc, char* argv[])
  {
     if (argc < 2) {
-        std::cerr << "Usage: receiver <port>\n";
+        std::cerr << "Usage: receiver <port> [--metrics <unix socket path>] [--capture <file.pcap>]"
+                     " [--flight <file>|--no-flight] [--flight-events N]\n"
+                     "                [--cpus role=list] [--sched role=policy[:prio]] [--nice role=n]\n"
+                     "                [--mlock] [--irq pattern=cpus]   (role: rx|worker|writer|logger)\n"
+                     "                [--wait block|spin|busy] [--spin-us N] [--busy-poll-us N]\n"
+                     "                [--ingress socket|rtc|ring|uring] [--iface NAME] [--ring-blocks N] [--ring-block-kb N]\n"
+                     "                [--demux none|id|source] [--max-streams N] [--stream key=MB[:idle_ms[:life_ms]]]\n"
+                     "                [--band-rows N] [--stage writer|stats=depth[:block|drop-oldest|drop-newest[:threads]]]\n"
+                     "                [--stage-pool N] [--timeouts fixed|adaptive[:min_ms:max_ms]]\n"
+                     "                [--shed tail|newest|every-nth[:N[:high%:low%]]]\n"
+                     "                [--record <file.hvr>] [--compress none|lz4|zstd[:threads[:chunk_kb]]]\n"
+                     "                [--copy memcpy|nt|auto[:min_bytes]]\n"
+                     "                [--config <file>] [--control <unix socket path>]\n";
         return -1;
     }
 
     int port = std::stoi(argv[1]);
 
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sock < 0) {
-        perror("socket");
-        return -1;
-    }
-
-    int rcvbuf = 16 * 1024 * 1024; // 16MB ̻
-    if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) < 0)
+    std::string metrics_path;
+    std::string capture_path;
+    std::string flight_path = "hv_flight.rec";
+    size_t      flight_events = hv::trace::DEFAULT_RING_EVENTS;
+    hv::placement::Config placement;
+    hv::wait::Config wait;
+    RxPipelineConfig rx_cfg;
+
+    // Frame consumers, off the reassembly thread
+    std::map<std::string, StageConfig> stage_cfg;
+    stage_cfg["writer"].name = "writer";
+    stage_cfg["stats"].name  = "stats";
+    stage_cfg["record"].name = "record";
+    uint32_t stage_pool = 1;
+
+    std::string    record_path;
+    RecorderConfig record_cfg;
+
+    // Live tuning: --config file (also `reload`), --control socket
+    std::string      config_path;
+    std::string      control_path;
+    hv::debug::Level log_level = hv::debug::Level::Debug;
+
+    for (int i = 2; i < argc; ++i)
     {
-        perror("setsockopt(SO_RCVBUF)");
-    }
-   
-    int reuse = 1;
-    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR,
-                &reuse, sizeof(reuse)) < 0)
-    {
-        perror("setsockopt(SO_REUSEADDR)");
+        std::string arg = argv[i];
+        if (arg == "--metrics" && i + 1 < argc)
+        {
+            metrics_path = argv[++i];
+        }
+        else if (arg == "--config" && i + 1 < argc)
+        {
+            // Applied in argument order: later options override the file
+            config_path = argv[++i];
+            if (!loadRxTunables(config_path, rx_cfg, log_level))
+                return -1;
+        }
+        else if (arg == "--control" && i + 1 < argc)
+        {
+            control_path = argv[++i];
+        }
+        else if (arg == "--capture" && i + 1 < argc)
+        {
+            capture_path = argv[++i];
+        }
+        else if (arg == "--flight" && i + 1 < argc)
+        {
+            flight_path = argv[++i];
+        }
+        else if (arg == "--no-flight")
+        {
+            flight_path.clear();
+        }
+        else if (arg == "--flight-events" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 16, 1u << 22, flight_events))
+                return -1;
+        }
+        else if (arg == "--wait" && i + 1 < argc)
+        {
+            if (!hv::wait::parseMode(argv[++i], wait.mode))
+            {
+                std::cerr << "Invalid --wait value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--copy" && i + 1 < argc)
+        {
+            if (!parse_copy_arg(argv[++i], rx_cfg.copy))
+            {
+                std::cerr << "Invalid --copy value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--spin-us" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 0, 1000000, wait.spin_us))
+                return -1;
+        }
+        else if (arg == "--busy-poll-us" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 0, 1000000, wait.busy_poll_us))
+                return -1;
+        }
+        else if (arg == "--ingress" && i + 1 < argc)
+        {
+            std::string v = argv[++i];
+            if (v == "socket")
+                rx_cfg.ingress = RxIngress::SOCKET;
+            else if (v == "rtc")
+                rx_cfg.ingress = RxIngress::SOCKET_RTC;
+            else if (v == "ring")
+                rx_cfg.ingress = RxIngress::PACKET_RING;
+            else if (v == "uring")
+                rx_cfg.ingress = RxIngress::URING;
+            else
+            {
+                std::cerr << "Invalid --ingress value: " << v << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--demux" && i + 1 < argc)
+        {
+            std::string v = argv[++i];
+            if (v == "none")
+                rx_cfg.demux = StreamKeyMode::SINGLE;
+            else if (v == "id")
+                rx_cfg.demux = StreamKeyMode::STREAM_ID;
+            else if (v == "source")
+                rx_cfg.demux = StreamKeyMode::SOURCE;
+            else
+            {
+                std::cerr << "Invalid --demux value: " << v << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--max-streams" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 1, 1024, rx_cfg.max_streams))
+                return -1;
+        }
+        else if (arg == "--stream" && i + 1 < argc)
+        {
+            if (!parse_stream_arg(argv[++i], rx_cfg.streams))
+            {
+                std::cerr << "Invalid --stream value: " << argv[i]
+                          << " (id|ip:port=MB[:idle_ms[:life_ms]], MB <= 256, ms <= 600000)\n";
+                return -1;
+            }
+        }
+        else if (arg == "--band-rows" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 0, 65535, rx_cfg.band_rows))
+                return -1;
+        }
+        else if (arg == "--shed" && i + 1 < argc)
+        {
+            if (!parse_shed_arg(argv[++i], rx_cfg.admission))
+            {
+                std::cerr << "Invalid --shed value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--timeouts" && i + 1 < argc)
+        {
+            if (!parse_timeouts_arg(argv[++i], rx_cfg.timeouts))
+            {
+                std::cerr << "Invalid --timeouts value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            record_path = argv[++i];
+        }
+        else if (arg == "--compress" && i + 1 < argc)
+        {
+            if (!parse_compress_arg(argv[++i], record_cfg))
+            {
+                std::cerr << "Invalid --compress value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--stage" && i + 1 < argc)
+        {
+            if (!parse_stage_arg(argv[++i], stage_cfg))
+            {
+                std::cerr << "Invalid --stage value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--stage-pool" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 1, 64, stage_pool))
+                return -1;
+        }
+        else if (arg == "--iface" && i + 1 < argc)
+        {
+            rx_cfg.ring_ifname = argv[++i];
+        }
+        else if (arg == "--ring-blocks" && i + 1 < argc)
+        {
+            if (!parse_uint_arg(arg, argv[++i], 1, 4096, rx_cfg.ring.block_count))
+                return -1;
+        }
+        else if (arg == "--ring-block-kb" && i + 1 < argc)
+        {
+            uint32_t kb = 0;
+            if (!parse_uint_arg(arg, argv[++i], 4, 64 * 1024, kb))
+                return -1;
+            rx_cfg.ring.block_size = kb * 1024;
+        }
+        else if (arg == "--mlock")
+        {
+            placement.lock_memory = true;
+        }
+        else if ((arg == "--cpus" || arg == "--sched" || arg == "--nice" || arg == "--irq")
+                 && i + 1 < argc)
+        {
+            if (!parse_placement_arg(arg, argv[++i], placement))
+            {
+                std::cerr << "Invalid " << arg << " value: " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return -1;
+        }
     }
 
+    // Before any thread starts (the async log drain thread included)
+    hv::placement::configure(placement);
 
     std::signal(SIGTERM, on_signal);
     std::signal(SIGINT,  on_signal);
 
-    std::atexit(on_exit_dump);
 
 
     /* Debug log Initialisation */
     hv::debug::init();
-    hv::debug::setLevel(hv::debug::Level::Debug);
+    hv::debug::setBackend(hv::debug::Backend::Async);
+    hv::debug::setLevel(log_level);
     hv::debug::enable(hv::debug::Module::RX
-                     | hv::debug::Module::FRAME);
+                     | hv::debug::Module::FRAME
+                     | hv::debug::Module::SYS);
 
     HV_LOGI(hv::debug::Module::RX, "##hv_debug init OK");
 
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    addr.sin_addr.s_addr = INADDR_ANY;
+    // Always-on flight recorder (survives crashes; decode with tm_flight_decode)
+    if (!flight_path.empty())
+    {
+        if (hv::trace::open(flight_path.c_str(), flight_events))
+            HV_LOGI(hv::debug::Module::RX, "flight recorder: %s", flight_path.c_str());
+    }
+
+    hv::placement::lockMemory();
+    hv::placement::applyIrqHints();
+
+    int sock = open_rx_socket(static_cast<uint16_t>(port), nullptr, nullptr, rx_cfg.rcvbuf);
+    if (sock < 0)
+        return -1;
+
+    hv::stats::MetricsExporter metrics;
+    if (!metrics_path.empty())
+    {
+        metrics.start(metrics_path);
+    }
+
+    RxCapture capture;
+    if (!capture_path.empty())
+    {
+        capture.open(capture_path, static_cast<uint16_t>(port));
+    }
+
+    // One stats block and one output file set per stream
+    std::map<uint32_t, FrameStreamStats> stream_stats;
+    const bool multi_stream = (rx_cfg.demux != StreamKeyMode::SINGLE);
+
+    rx_cfg.capture = &capture;
+    rx_cfg.wait    = wait;
+
+    // File output and statistics run as pipeline stages: a slow disk no longer
+    // stalls reassembly (unless the writer stage is set to block)
+    FramePipeline consumers;
+    consumers.setPoolThreads(stage_pool);
+
+    stage_cfg["writer"].fn = [multi_stream](const FrameResult& r)
+    {
+        std::string prefix = "received";
+        if (multi_stream)
+            prefix += "_s" + std::to_string(r.stream_id);
+
+        write_frame_to_file(r.frame_data,
+                            r.frame_size,
+                            r.state == FrameState::PARTIAL,
+                            prefix.c_str());
+    };
+    stage_cfg["stats"].fn = [&stream_stats](const FrameResult& r)
+    {
+        FrameStreamStats& ss = stream_stats[r.stream_id];
+        ss.update(r);
+        if ((ss.frames_total % 100) == 0)
+        {
+            ss.log();
+            hv::stats::logHistograms();
+        }
+    };
+
+    // Neither is reentrant (stream_stats map, shared output files): one frame at a time
+    for (const char* name : {"writer", "stats"})
+    {
+        if (stage_cfg[name].threads > 1)
+        {
+            HV_LOGW(hv::debug::Module::FRAME, "[PIPE] stage %s runs on 1 thread (asked %u)",
+                    name, stage_cfg[name].threads);
+            stage_cfg[name].threads = 1;
+        }
+    }
+    consumers.addStage(stage_cfg["writer"]);
+    consumers.addStage(stage_cfg["stats"]);
+
+    // Compressed recording: chunks of one frame compress in parallel, frames stay in order
+    FrameRecorder recorder(record_cfg);
+    if (!record_path.empty())
+    {
+        if (!recorder.open(record_path))
+        {
+            close(sock);
+            return -1;
+        }
+        stage_cfg["record"].threads = 1;            // record() is single-caller
+        stage_cfg["record"].fn = [&recorder](const FrameResult& r)
+        {
+            recorder.record(r);
+        };
+        consumers.addStage(stage_cfg["record"]);
+    }
+
+    RxPipeline pipeline(rx_cfg);
+    pipeline.onFrameDone = [&consumers](const FrameResult& r)
+    {
+        consumers.submit(r);
+    };
 
-    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0)
+    // Streaming delivery: rows become usable before the frame is complete
+    if (rx_cfg.band_rows)
     {
-        perror("bind");
+        pipeline.onFrameBand = [](const FrameBand& b)
+        {
+            HV_LOGD(hv::debug::Module::FRAME, "[BAND] s%u frame=%u rows %u-%u/%u%s",
+                    b.stream_id, b.frame_id, b.row_begin, b.row_end, b.height,
+                    b.last ? " last" : "");
+        };
+    }
+
+    if (multi_stream && !metrics_path.empty())
+    {
+        metrics.addSection([&pipeline](hv::stats::Format fmt, std::string& out)
+        {
+            char line[512];
+            bool first = true;
+            if (fmt == hv::stats::Format::Json)
+                out += ",\"streams\":[";
+            for (const StreamStatsSnapshot& st : pipeline.streamStats())
+            {
+                if (fmt == hv::stats::Format::Prometheus)
+                    std::snprintf(line, sizeof(line),
+                                  "hv_stream_packets_total{stream=\"%u\"} %llu\n"
+                                  "hv_stream_frames_complete_total{stream=\"%u\"} %llu\n"
+                                  "hv_stream_frames_partial_total{stream=\"%u\"} %llu\n"
+                                  "hv_stream_idle_timeout_us{stream=\"%u\"} %llu\n"
+                                  "hv_stream_lifetime_us{stream=\"%u\"} %llu\n",
+                                  st.id, static_cast<unsigned long long>(st.packets),
+                                  st.id, static_cast<unsigned long long>(st.frames_complete),
+                                  st.id, static_cast<unsigned long long>(st.frames_partial),
+                                  st.id, static_cast<unsigned long long>(st.idle_timeout_us),
+                                  st.id, static_cast<unsigned long long>(st.lifetime_us));
+                else
+                    std::snprintf(line, sizeof(line),
+                                  "%s{\"id\":%u,\"name\":\"%s\",\"packets\":%llu,"
+                                  "\"complete\":%llu,\"partial\":%llu,\"in_flight\":%llu,"
+                                  "\"idle_timeout_us\":%llu,\"lifetime_us\":%llu}",
+                                  first ? "" : ",", st.id, st.name.c_str(),
+                                  static_cast<unsigned long long>(st.packets),
+                                  static_cast<unsigned long long>(st.frames_complete),
+                                  static_cast<unsigned long long>(st.frames_partial),
+                                  static_cast<unsigned long long>(st.in_flight),
+                                  static_cast<unsigned long long>(st.idle_timeout_us),
+                                  static_cast<unsigned long long>(st.lifetime_us));
+                out += line;
+                first = false;
+            }
+            if (fmt == hv::stats::Format::Json)
+                out += "]";
+        });
+    }
+    if (!metrics_path.empty())
+    {
+        metrics.addSection([&consumers](hv::stats::Format fmt, std::string& out)
+        {
+            char line[320];
+            bool first = true;
+            if (fmt == hv::stats::Format::Json)
+                out += ",\"stages\":[";
+            for (const StageStats& st : consumers.stats())
+            {
+                if (fmt == hv::stats::Format::Prometheus)
+                    std::snprintf(line, sizeof(line),
+                                  "hv_stage_processed_total{stage=\"%s\"} %llu\n"
+                                  "hv_stage_dropped_total{stage=\"%s\"} %llu\n"
+                                  "hv_stage_queued{stage=\"%s\"} %zu\n"
+                                  "hv_stage_service_p99_ns{stage=\"%s\"} %llu\n",
+                                  st.name.c_str(), static_cast<unsigned long long>(st.processed),
+                                  st.name.c_str(), static_cast<unsigned long long>(st.dropped),
+                                  st.name.c_str(), st.queued,
+                                  st.name.c_str(),
+                                  static_cast<unsigned long long>(st.service.percentile(99.0)));
+                else
+                    std::snprintf(line, sizeof(line),
+                                  "%s{\"name\":\"%s\",\"policy\":\"%s\",\"processed\":%llu,"
+                                  "\"dropped\":%llu,\"queued\":%zu,\"dwell_p99_ns\":%llu,"
+                                  "\"service_p99_ns\":%llu}",
+                                  first ? "" : ",", st.name.c_str(), stagePolicyName(st.policy),
+                                  static_cast<unsigned long long>(st.processed),
+                                  static_cast<unsigned long long>(st.dropped), st.queued,
+                                  static_cast<unsigned long long>(st.dwell.percentile(99.0)),
+                                  static_cast<unsigned long long>(st.service.percentile(99.0)));
+                out += line;
+                first = false;
+            }
+            if (fmt == hv::stats::Format::Json)
+                out += "]";
+        });
+    }
+
+    consumers.start();
+
+    const uint64_t run_start_ns = hv::stats::monotonicNs();
+    if (!pipeline.start(sock))
+    {
+        consumers.stop();
         close(sock);
         return -1;
     }
 
-    std::thread rx_thread(udp_rx_thread, sock, std::ref(packet_queue));
-    std::thread frame_thread(frame_worker_thread, std::ref(packet_queue));
+    RxControl control;
+    if (!control_path.empty())
+    {
+        control.start(control_path, pipeline, config_path);
+    }
     
     
     // 4. The main thread waits until a termination request is received.
+    auto last_rate_report = std::chrono::steady_clock::now();
     while (!g_shutdown.load(std::memory_order_relaxed))
     {
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // Summaries of rate-limited log call sites
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_rate_report >= std::chrono::seconds(1))
+        {
+            hv::debug::reportSuppressed();
+            last_rate_report = now;
+        }
     }
 
     HV_LOGI(hv::debug::Module::RX, "shutdown requested");
 
-    // 5. RX End
-    if (rx_thread.joinable())
-        rx_thread.join();
-
-    // 6. PROC End (Queue emptying + partial flush included)
-    if (frame_thread.joinable())
-        frame_thread.join();
-
-    // 7. After all threads have terminated and trace dump
-#ifdef DEBUG_LOG_ENABLE
-    debug_log::dump_ring("packet_trace.log");
-#endif
-
+    // No reconfigure() once the pipeline is stopping
+    control.stop();
+
+    // 5. RX End, 6. PROC End (Queue emptying + partial flush included)
+    pipeline.stop();
+    consumers.stop();
+    consumers.logStats();
+    recorder.close();
+    for (const auto& kv : stream_stats)
+        kv.second.log();
+
+    // Idle cost of the wait strategy, compare with worker_wakeup below
+    double run_ns = static_cast<double>(hv::stats::monotonicNs() - run_start_ns);
+    HV_LOGI(hv::debug::Module::RX, "[WAIT] mode=%s cpu rx=%.1f%% worker=%.1f%%",
+            hv::wait::modeName(wait.mode),
+            100.0 * pipeline.rxCpuNs() / run_ns,
+            100.0 * pipeline.workerCpuNs() / run_ns);
+    hv::stats::logHistograms();
+
+    // Where packets were lost: socket buffer / RX thread (kernel) vs worker (queue)
+    hv::stats::Snapshot drops = hv::stats::snapshot();
+    HV_LOGI(hv::debug::Module::RX, "[DROP] kernel=%llu ring=%llu queue=%llu shed=%llu",
+            static_cast<unsigned long long>(drops.counters[hv::stats::KERNEL_DROPS]),
+            static_cast<unsigned long long>(drops.counters[hv::stats::RING_DROPS]),
+            static_cast<unsigned long long>(drops.counters[hv::stats::QUEUE_DROPS]),
+            static_cast<unsigned long long>(drops.counters[hv::stats::SHED_PACKETS]));
+
+    // 7. After all threads have terminated: recorder file stays on disk
+    hv::trace::close();
+
+    capture.close();
+    metrics.stop();
     close(sock);
+
+    hv::debug::reportSuppressed();
+    HV_LOGI(hv::debug::Module::RX, "log messages dropped=%llu",
+            static_cast<unsigned long long>(hv::debug::droppedMessages()));
+    hv::debug::shutdown();
     return 0;
 }
 
@@ -0,0 +1,192 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX UDP Receive Capture                             */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <cstring>
+#include <chrono>
+
+#include "receiver/rx_capture.hpp"
+
+#include "common/pcap_format.hpp"
+#include "common/thread_placement.hpp"
+
+#include "debug/debug_stats.hpp"
+#include "debug/hv_debug.hpp"
+
+
+namespace {
+
+uint16_t ipv4Checksum(const uint8_t* hdr, size_t len)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2)
+        sum += (static_cast<uint32_t>(hdr[i]) << 8) | hdr[i + 1];
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return static_cast<uint16_t>(~sum);
+}
+
+} // namespace
+
+
+RxCapture::~RxCapture()
+{
+    close();
+}
+
+bool RxCapture::open(const std::string& path, uint16_t dst_port)
+{
+    if (fp_)
+        return false;
+
+    fp_ = std::fopen(path.c_str(), "wb");
+    if (!fp_)
+    {
+        perror("fopen(capture)");
+        return false;
+    }
+
+    // Large stdio buffer: the writer thread issues few, big write()s
+    std::setvbuf(fp_, nullptr, _IOFBF, 1 << 20);
+
+    pcap::FileHeader fh{};
+    fh.magic         = pcap::MAGIC_NSEC;
+    fh.version_major = 2;
+    fh.version_minor = 4;
+    fh.snaplen       = pcap::SNAPLEN;
+    fh.linktype      = pcap::LINKTYPE_RAW;
+    std::fwrite(&fh, sizeof(fh), 1, fp_);
+
+    dst_port_ = dst_port;
+    slots_.reset(new Slot[SLOT_COUNT]);
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    stop_.store(false, std::memory_order_relaxed);
+
+    writer_ = std::thread(&RxCapture::writerLoop, this);
+
+    HV_LOGI(hv::debug::Module::RX, "[CAP ] capturing to %s", path.c_str());
+    return true;
+}
+
+void RxCapture::close()
+{
+    if (!fp_)
+        return;
+
+    stop_.store(true, std::memory_order_release);
+    if (writer_.joinable())
+        writer_.join();
+
+    std::fclose(fp_);
+    fp_ = nullptr;
+
+    HV_LOGI(hv::debug::Module::RX, "[CAP ] closed captured=%llu dropped=%llu",
+            static_cast<unsigned long long>(captured()),
+            static_cast<unsigned long long>(dropped()));
+}
+
+void RxCapture::record(const uint8_t* data, size_t len, uint64_t ts_ns,
+                       uint32_t src_ip, uint16_t src_port)
+{
+    uint64_t head = head_.load(std::memory_order_relaxed);
+
+    if (head - tail_.load(std::memory_order_acquire) >= SLOT_COUNT)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        hv::stats::add(hv::stats::CAPTURE_DROPS);
+        return;
+    }
+
+    if (len > SLOT_DATA)
+        len = SLOT_DATA;
+
+    Slot& s = slots_[head & (SLOT_COUNT - 1)];
+    s.ts_ns    = ts_ns;
+    s.len      = static_cast<uint32_t>(len);
+    s.src_ip   = src_ip;
+    s.src_port = src_port;
+    std::memcpy(s.data, data, len);
+
+    head_.store(head + 1, std::memory_order_release);
+    hv::stats::add(hv::stats::CAPTURE_PACKETS);
+}
+
+void RxCapture::writeSlot(const Slot& s)
+{
+    const uint32_t ip_len = pcap::IPV4_HDR_LEN + pcap::UDP_HDR_LEN + s.len;
+
+    pcap::RecordHeader rh{};
+    rh.ts_sec   = static_cast<uint32_t>(s.ts_ns / 1000000000ull);
+    rh.ts_frac  = static_cast<uint32_t>(s.ts_ns % 1000000000ull);
+    rh.incl_len = ip_len;
+    rh.orig_len = ip_len;
+
+    // Synthesized IPv4 + UDP header (UDP checksum 0 = not computed)
+    uint8_t hdr[pcap::IPV4_HDR_LEN + pcap::UDP_HDR_LEN] = {};
+    uint32_t dst_ip = htonl(INADDR_LOOPBACK);
+
+    hdr[0] = 0x45;                                  // v4, IHL 5
+    hdr[2] = static_cast<uint8_t>(ip_len >> 8);
+    hdr[3] = static_cast<uint8_t>(ip_len);
+    hdr[6] = 0x40;                                  // DF
+    hdr[8] = 64;                                    // TTL
+    hdr[9] = 17;                                    // UDP
+    std::memcpy(&hdr[12], &s.src_ip, 4);
+    std::memcpy(&hdr[16], &dst_ip, 4);
+
+    uint16_t csum = ipv4Checksum(hdr, pcap::IPV4_HDR_LEN);
+    hdr[10] = static_cast<uint8_t>(csum >> 8);
+    hdr[11] = static_cast<uint8_t>(csum);
+
+    uint8_t* udp = hdr + pcap::IPV4_HDR_LEN;
+    uint16_t dport   = htons(dst_port_);
+    uint16_t udp_len = htons(static_cast<uint16_t>(pcap::UDP_HDR_LEN + s.len));
+    std::memcpy(&udp[0], &s.src_port, 2);
+    std::memcpy(&udp[2], &dport, 2);
+    std::memcpy(&udp[4], &udp_len, 2);
+
+    std::fwrite(&rh, sizeof(rh), 1, fp_);
+    std::fwrite(hdr, sizeof(hdr), 1, fp_);
+    std::fwrite(s.data, 1, s.len, fp_);
+}
+
+void RxCapture::writerLoop()
+{
+    pthread_setname_np(pthread_self(), "hv_capture");
+    hv::placement::apply(hv::placement::Role::WRITER);
+
+    for (;;)
+    {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+
+        if (tail == head)
+        {
+            if (stop_.load(std::memory_order_acquire))
+            {
+                // Producer has stopped: one last check for late records
+                if (head_.load(std::memory_order_acquire) == tail)
+                    break;
+                continue;
+            }
+
+            std::fflush(fp_);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        for (; tail != head; ++tail)
+        {
+            writeSlot(slots_[tail & (SLOT_COUNT - 1)]);
+            captured_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    std::fflush(fp_);
+}
@@ -0,0 +1,469 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Receiver Runtime Control                        */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "receiver/rx_control.hpp"
+
+#include "debug/hv_debug.hpp"
+
+
+namespace {
+
+constexpr int CLIENT_IDLE_MS = 30000;   // an idle control connection is closed
+constexpr size_t MAX_LINE    = 1024;
+
+struct TunableInfo
+{
+    const char* key;
+    const char* help;
+};
+
+const TunableInfo kTunables[] = {
+    { "queue_capacity",  "packets, PacketQueue (SOCKET ingress); immediate" },
+    { "rcvbuf",          "bytes, SO_RCVBUF; immediate" },
+    { "max_frame_size",  "bytes, default frame buffer size; next frames" },
+    { "payload_stride",  "bytes, v1 packet payload stride; next frames" },
+    { "frame_buffers",   "pooled frame buffers per stream; next frames" },
+    { "idle_timeout_ms", "fixed idle deadline, 0 => adaptive / default" },
+    { "lifetime_ms",     "fixed frame lifetime, 0 => adaptive / default" },
+    { "timeouts",        "adaptive | fixed" },
+    { "log_level",       "error | warn | info | debug" },
+};
+
+std::string trim(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// Unsigned with an optional K / M suffix (x1024), within [lo, hi]
+bool parseSize(const std::string& v, uint64_t lo, uint64_t hi, uint64_t& out)
+{
+    if (v.empty() || v[0] == '-')
+        return false;
+
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long n = std::strtoull(v.c_str(), &end, 10);
+    if (errno || end == v.c_str())
+        return false;
+
+    unsigned long long mult = 1;
+    if (*end == 'K' || *end == 'k')
+    {
+        mult = 1024;
+        end++;
+    }
+    else if (*end == 'M' || *end == 'm')
+    {
+        mult = 1024 * 1024;
+        end++;
+    }
+
+    // Range before the multiply: a huge count must not wrap into range
+    if (*end != '\0' || n > hi / mult)
+        return false;
+    n *= mult;
+    if (n < lo)
+        return false;
+
+    out = n;
+    return true;
+}
+
+const char* levelName(hv::debug::Level l)
+{
+    switch (l)
+    {
+    case hv::debug::Level::Error: return "error";
+    case hv::debug::Level::Warn:  return "warn";
+    case hv::debug::Level::Info:  return "info";
+    case hv::debug::Level::Debug: return "debug";
+    }
+    return "unknown";
+}
+
+bool parseLevel(const std::string& s, hv::debug::Level& out)
+{
+    if (s == "error")
+        out = hv::debug::Level::Error;
+    else if (s == "warn")
+        out = hv::debug::Level::Warn;
+    else if (s == "info")
+        out = hv::debug::Level::Info;
+    else if (s == "debug")
+        out = hv::debug::Level::Debug;
+    else
+        return false;
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>> tunableValues(const RxPipelineConfig& cfg,
+                                                               hv::debug::Level level)
+{
+    return {
+        { "queue_capacity",  std::to_string(cfg.queue_capacity) },
+        { "rcvbuf",          std::to_string(cfg.rcvbuf) },
+        { "max_frame_size",  std::to_string(cfg.max_frame_size) },
+        { "payload_stride",  std::to_string(cfg.payload_stride) },
+        { "frame_buffers",   std::to_string(cfg.frame_buffers) },
+        { "idle_timeout_ms", std::to_string(cfg.idle_timeout_ms) },
+        { "lifetime_ms",     std::to_string(cfg.lifetime_ms) },
+        { "timeouts",        cfg.timeouts.adaptive ? "adaptive" : "fixed" },
+        { "log_level",       levelName(level) },
+    };
+}
+
+void sendAll(int fd, const std::string& s)
+{
+    size_t off = 0;
+    while (off < s.size())
+    {
+        ssize_t n = ::send(fd, s.data() + off, s.size() - off, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        off += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+
+/*-------------------------------------------*/
+/* Tunables                                  */
+/*-------------------------------------------*/
+bool setRxTunable(RxPipelineConfig& cfg, hv::debug::Level& log_level,
+                  const std::string& key, const std::string& value,
+                  std::string* err)
+{
+    auto bad = [&](const char* range)
+    {
+        if (err)
+            *err = "invalid " + key + " value '" + value + "' (" + range + ")";
+        return false;
+    };
+
+    uint64_t n = 0;
+
+    if (key == "queue_capacity")
+    {
+        if (!parseSize(value, 16, 1u << 22, n))
+            return bad("16 .. 4M packets");
+        cfg.queue_capacity = n;
+    }
+    else if (key == "rcvbuf")
+    {
+        if (!parseSize(value, 64 * 1024, INT_MAX / 2, n))
+            return bad("64K .. 1G bytes");
+        cfg.rcvbuf = static_cast<int>(n);
+    }
+    else if (key == "max_frame_size")
+    {
+        if (!parseSize(value, 1024, 256u << 20, n))
+            return bad("1K .. 256M bytes");
+        cfg.max_frame_size = n;
+    }
+    else if (key == "payload_stride")
+    {
+        if (!parseSize(value, 64, 65507, n))
+            return bad("64 .. 65507 bytes");
+        cfg.payload_stride = n;
+    }
+    else if (key == "frame_buffers")
+    {
+        if (!parseSize(value, 1, 1024, n))
+            return bad("1 .. 1024");
+        cfg.frame_buffers = n;
+    }
+    else if (key == "idle_timeout_ms" || key == "lifetime_ms")
+    {
+        if (!parseSize(value, 0, 600000, n))
+            return bad("0 .. 600000 ms");
+        (key == "idle_timeout_ms" ? cfg.idle_timeout_ms : cfg.lifetime_ms) = static_cast<uint32_t>(n);
+    }
+    else if (key == "timeouts")
+    {
+        if (value != "adaptive" && value != "fixed")
+            return bad("adaptive | fixed");
+        cfg.timeouts.adaptive = (value == "adaptive");
+    }
+    else if (key == "log_level")
+    {
+        if (!parseLevel(value, log_level))
+            return bad("error | warn | info | debug");
+    }
+    else
+    {
+        if (err)
+            *err = "unknown key '" + key + "'";
+        return false;
+    }
+    return true;
+}
+
+std::string getRxTunables(const RxPipelineConfig& cfg, hv::debug::Level log_level,
+                          const std::string& key)
+{
+    std::string out;
+    for (const auto& kv : tunableValues(cfg, log_level))
+    {
+        if (!key.empty() && kv.first != key)
+            continue;
+        out += kv.first + " = " + kv.second + "\n";
+    }
+    return out;
+}
+
+bool loadRxTunables(const std::string& path, RxPipelineConfig& cfg,
+                    hv::debug::Level& log_level)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    std::string line;
+    for (int no = 1; std::getline(in, line); ++no)
+    {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.resize(hash);
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        size_t sep = line.find_first_of("= \t");
+        std::string key   = trim(line.substr(0, sep));
+        std::string value = sep == std::string::npos ? "" : trim(line.substr(sep + 1));
+        if (!value.empty() && value[0] == '=')
+            value = trim(value.substr(1));
+
+        std::string err;
+        if (!setRxTunable(cfg, log_level, key, value, &err))
+        {
+            std::fprintf(stderr, "%s:%d: %s\n", path.c_str(), no, err.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/*-------------------------------------------*/
+/* RxControl                                 */
+/*-------------------------------------------*/
+RxControl::~RxControl()
+{
+    stop();
+}
+
+bool RxControl::start(const std::string& socket_path, RxPipeline& pipeline,
+                      const std::string& config_path)
+{
+    if (running_.load())
+        return true;
+
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path))
+    {
+        HV_LOGE(hv::debug::Module::RX, "[CTRL] socket path too long: %s", socket_path.c_str());
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+    {
+        perror("socket(AF_UNIX)");
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    ::unlink(socket_path.c_str());
+
+    // Owner only: the socket changes how the receiver runs
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::chmod(socket_path.c_str(), 0600) < 0
+        || ::listen(listen_fd_, 4) < 0)
+    {
+        perror("bind/listen(control)");
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    pipeline_    = &pipeline;
+    config_path_ = config_path;
+    path_        = socket_path;
+    running_.store(true);
+    thread_ = std::thread(&RxControl::run, this);
+
+    HV_LOGI(hv::debug::Module::RX, "[CTRL] control socket on %s", path_.c_str());
+    return true;
+}
+
+void RxControl::stop()
+{
+    if (!running_.exchange(false))
+        return;
+
+    if (thread_.joinable())
+        thread_.join();
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(path_.c_str());
+}
+
+std::string RxControl::apply(const RxPipelineConfig& cfg, hv::debug::Level level)
+{
+    pipeline_->reconfigure(cfg);
+    hv::debug::setLevel(level);
+    return "ok\n";
+}
+
+std::string RxControl::execute(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string cmd, key, value;
+    in >> cmd >> key;
+    std::getline(in, value);
+    value = trim(value);
+
+    if (cmd.empty())
+        return "";
+
+    std::lock_guard<std::mutex> lk(mtx_);
+
+    RxPipelineConfig cfg = pipeline_->config();
+    hv::debug::Level level = hv::debug::detail::g_level.load(std::memory_order_relaxed);
+
+    if (cmd == "get")
+    {
+        std::string out = getRxTunables(cfg, level, key);
+        return out.empty() ? "error: unknown key '" + key + "'\n" : out;
+    }
+
+    if (cmd == "set")
+    {
+        std::string err;
+        if (key.empty() || value.empty())
+            return "error: usage: set <key> <value>\n";
+        if (!setRxTunable(cfg, level, key, value, &err))
+            return "error: " + err + "\n";
+
+        HV_LOGI(hv::debug::Module::RX, "[CTRL] set %s %s", key.c_str(), value.c_str());
+        return apply(cfg, level);
+    }
+
+    if (cmd == "reload")
+    {
+        if (config_path_.empty())
+            return "error: no config file (--config)\n";
+        if (!loadRxTunables(config_path_, cfg, level))
+            return "error: " + config_path_ + " not applied (see stderr)\n";
+
+        HV_LOGI(hv::debug::Module::RX, "[CTRL] reload %s", config_path_.c_str());
+        return apply(cfg, level);
+    }
+
+    if (cmd == "help")
+    {
+        std::string out = "get [key] | set <key> <value> | reload | help\n";
+        for (const TunableInfo& t : kTunables)
+            out += std::string("  ") + t.key + " : " + t.help + "\n";
+        return out;
+    }
+
+    return "error: unknown command '" + cmd + "' (help)\n";
+}
+
+void RxControl::serve(int client)
+{
+    std::string buf;
+    char chunk[256];
+    int idle_ms = 0;
+
+    // A client that stops talking must not hold the socket forever
+    while (running_.load(std::memory_order_relaxed) && idle_ms < CLIENT_IDLE_MS)
+    {
+        pollfd pfd{client, POLLIN, 0};
+        int ret = ::poll(&pfd, 1, 100);
+        if (ret < 0 && errno != EINTR)
+            return;
+        if (ret <= 0)
+        {
+            idle_ms += 100;
+            continue;
+        }
+        idle_ms = 0;
+
+        ssize_t n = ::recv(client, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+        {
+            // Last command without a newline (printf "get" | socat ...)
+            if (n == 0 && !trim(buf).empty())
+                sendAll(client, execute(buf));
+            return;
+        }
+        buf.append(chunk, static_cast<size_t>(n));
+
+        size_t nl;
+        while ((nl = buf.find('\n')) != std::string::npos)
+        {
+            std::string reply = execute(buf.substr(0, nl));
+            buf.erase(0, nl + 1);
+            sendAll(client, reply);
+        }
+
+        if (buf.size() > MAX_LINE)
+        {
+            sendAll(client, "error: line too long\n");
+            return;
+        }
+    }
+}
+
+void RxControl::run()
+{
+    while (running_.load(std::memory_order_relaxed))
+    {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        int ret = ::poll(&pfd, 1, 100);
+
+        if (ret > 0 && (pfd.revents & POLLIN))
+        {
+            int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0)
+            {
+                serve(client);
+                ::close(client);
+            }
+        }
+    }
+}
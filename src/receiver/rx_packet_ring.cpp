@@ -0,0 +1,218 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX AF_PACKET Receive Ring                          */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+
+#include "receiver/rx_packet_ring.hpp"
+
+#include "debug/hv_debug.hpp"
+
+#ifndef PACKET_IGNORE_OUTGOING
+#define PACKET_IGNORE_OUTGOING 23
+#endif
+
+
+PacketRing::~PacketRing()
+{
+    close();
+}
+
+bool PacketRing::open(const std::string& ifname, uint16_t port, const PacketRingConfig& cfg)
+{
+    if (fd_ >= 0)
+        return false;
+
+    // SOCK_DGRAM: link header stripped, data (and the filter) start at the IP header
+    fd_ = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+    if (fd_ < 0)
+    {
+        perror("socket(AF_PACKET)");
+        return false;
+    }
+
+    /*
+     * Classic BPF, offsets relative to the IPv4 header:
+     *   proto == UDP, not a fragment, UDP dst port == port
+     */
+    sock_filter code[] = {
+        BPF_STMT(BPF_LD  | BPF_B   | BPF_ABS, 9),               // ip proto
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,   IPPROTO_UDP, 0, 6),
+        BPF_STMT(BPF_LD  | BPF_H   | BPF_ABS, 6),               // flags / frag offset
+        BPF_JUMP(BPF_JMP | BPF_JSET| BPF_K,   0x3FFF, 4, 0),    // MF or offset => drop
+        BPF_STMT(BPF_LDX | BPF_B   | BPF_MSH, 0),               // X = IHL * 4
+        BPF_STMT(BPF_LD  | BPF_H   | BPF_IND, 2),               // udp dst port
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,   port, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K,             0x40000),         // accept
+        BPF_STMT(BPF_RET | BPF_K,             0),               // drop
+    };
+    sock_fprog prog{static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+
+    if (setsockopt(fd_, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0)
+    {
+        perror("setsockopt(SO_ATTACH_FILTER)");
+        close();
+        return false;
+    }
+
+    // Loopback delivers every packet twice (outgoing + incoming); keep the incoming one
+    int one = 1;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one)) < 0)
+        HV_LOGD(hv::debug::Module::RX, "[RING] PACKET_IGNORE_OUTGOING unsupported, filtering in user space");
+
+    int ver = TPACKET_V3;
+    if (setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver)) < 0)
+    {
+        perror("setsockopt(PACKET_VERSION)");
+        close();
+        return false;
+    }
+
+    tpacket_req3 req{};
+    req.tp_block_size       = cfg.block_size;
+    req.tp_block_nr         = cfg.block_count;
+    req.tp_frame_size       = cfg.frame_size;
+    req.tp_frame_nr         = (cfg.block_size / cfg.frame_size) * cfg.block_count;
+    req.tp_retire_blk_tov   = cfg.block_timeout_ms;
+    req.tp_feature_req_word = 0;
+
+    if (setsockopt(fd_, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+    {
+        perror("setsockopt(PACKET_RX_RING)");
+        close();
+        return false;
+    }
+
+    map_len_ = static_cast<size_t>(cfg.block_size) * cfg.block_count;
+    void* m = mmap(nullptr, map_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fd_, 0);
+    if (m == MAP_FAILED)
+        m = mmap(nullptr, map_len_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (m == MAP_FAILED)
+    {
+        perror("mmap(PACKET_RX_RING)");
+        map_len_ = 0;
+        close();
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(m);
+
+    block_size_  = cfg.block_size;
+    block_count_ = cfg.block_count;
+    next_        = 0;
+    stats_       = Stats{};
+
+    // Bind last: packets start landing in the ring from here on
+    sockaddr_ll sll{};
+    sll.sll_family   = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_IP);
+    sll.sll_ifindex  = static_cast<int>(if_nametoindex(ifname.c_str()));
+    if (sll.sll_ifindex == 0)
+    {
+        std::fprintf(stderr, "unknown interface: %s\n", ifname.c_str());
+        close();
+        return false;
+    }
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&sll), sizeof(sll)) < 0)
+    {
+        perror("bind(AF_PACKET)");
+        close();
+        return false;
+    }
+
+    HV_LOGI(hv::debug::Module::RX, "[RING] %s udp/%u TPACKET_V3 %u x %u KB, retire %u ms",
+            ifname.c_str(), port, block_count_, block_size_ / 1024, cfg.block_timeout_ms);
+    return true;
+}
+
+void PacketRing::close()
+{
+    if (map_)
+    {
+        munmap(map_, map_len_);
+        map_ = nullptr;
+        map_len_ = 0;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+tpacket_block_desc* PacketRing::waitBlock(int timeout_ms)
+{
+    auto* b = reinterpret_cast<tpacket_block_desc*>(map_ + static_cast<size_t>(next_) * block_size_);
+
+    if ((__atomic_load_n(&b->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+    {
+        if (timeout_ms == 0)
+            return nullptr;
+
+        pollfd pfd{fd_, POLLIN | POLLERR, 0};
+        if (::poll(&pfd, 1, timeout_ms) <= 0)
+            return nullptr;
+
+        if ((__atomic_load_n(&b->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+            return nullptr;
+    }
+
+    return b;
+}
+
+void PacketRing::releaseBlock(tpacket_block_desc* b)
+{
+    __atomic_store_n(&b->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    next_ = (next_ + 1) % block_count_;
+}
+
+bool PacketRing::parse(const tpacket3_hdr* h, Datagram& out)
+{
+    const auto* sll = reinterpret_cast<const sockaddr_ll*>(
+        reinterpret_cast<const uint8_t*>(h) + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+    if (sll->sll_pkttype == PACKET_OUTGOING)
+        return false;
+
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(h) + h->tp_net;
+    uint32_t cap = h->tp_snaplen;
+
+    if (cap < 20 || (ip[0] >> 4) != 4)
+        return false;
+
+    uint32_t ihl = (ip[0] & 0x0F) * 4u;
+    if (ihl < 20 || cap < ihl + 8)
+        return false;
+
+    const uint8_t* udp = ip + ihl;
+    uint32_t udp_len = (static_cast<uint32_t>(udp[4]) << 8) | udp[5];
+    if (udp_len < 8 || ihl + udp_len > cap)
+        return false;               // truncated (snaplen) or bogus
+
+    std::memcpy(&out.src_ip, ip + 12, 4);
+    std::memcpy(&out.src_port, udp, 2);
+    out.data  = udp + 8;
+    out.len   = udp_len - 8;
+    out.ts_ns = static_cast<uint64_t>(h->tp_sec) * 1000000000ull + h->tp_nsec;
+    return true;
+}
+
+const PacketRing::Stats& PacketRing::updateStats()
+{
+    tpacket_stats_v3 st{};
+    socklen_t len = sizeof(st);
+    if (fd_ >= 0 && getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0)
+    {
+        stats_.drops   += st.tp_drops;
+        stats_.freezes += st.tp_freeze_q_cnt;
+    }
+    return stats_;
+}
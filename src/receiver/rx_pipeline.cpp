@@ -0,0 +1,981 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX UDP Receive Pipeline                            */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "receiver/rx_pipeline.hpp"
+#include "receiver/rx_capture.hpp"
+
+#include "debug/debug_log.hpp"
+#include "debug/debug_stats.hpp"
+#include "debug/debug_histogram.hpp"
+#include "debug/hv_debug.hpp"
+#include "debug/flight_recorder.hpp"
+
+#include "protocol/udp_packet.hpp"
+
+#include "common/thread_placement.hpp"
+
+
+/* ================================
+ * Socket setup
+ * ================================ */
+int open_rx_socket(uint16_t port, const char* bind_ip, uint16_t* bound_port, int rcvbuf)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) < 0)
+    {
+        perror("setsockopt(SO_RCVBUF)");
+    }
+
+    // Kernel / NIC receive timestamps and the socket drop counter
+    enable_rx_instrumentation(sock);
+
+    int reuse = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR,
+                &reuse, sizeof(reuse)) < 0)
+    {
+        perror("setsockopt(SO_REUSEADDR)");
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind_ip && inet_pton(AF_INET, bind_ip, &addr.sin_addr) != 1)
+    {
+        std::fprintf(stderr, "invalid bind address: %s\n", bind_ip);
+        close(sock);
+        return -1;
+    }
+
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind");
+        close(sock);
+        return -1;
+    }
+
+    if (bound_port)
+    {
+        socklen_t alen = sizeof(addr);
+        if (getsockname(sock, (sockaddr*)&addr, &alen) == 0)
+            *bound_port = ntohs(addr.sin_port);
+        else
+            *bound_port = port;
+    }
+
+    return sock;
+}
+
+
+RxPipeline::RxPipeline(const RxPipelineConfig& cfg)
+    : cfg_(cfg),
+      queue_(cfg.queue_capacity)
+{
+}
+
+RxPipeline::~RxPipeline()
+{
+    stop();
+}
+
+bool RxPipeline::start(int sock)
+{
+    if (running_)
+        return false;
+
+    shutdown_.store(false, std::memory_order_relaxed);
+
+    demux_ = std::make_unique<StreamDemux>(cfg_.demux, cfg_.max_streams,
+                                           cfg_.max_frame_size, cfg_.payload_stride,
+                                           cfg_.frame_buffers);
+    for (const auto& kv : cfg_.streams)
+        demux_->configure(kv.first, kv.second);
+    demux_->setTimeoutConfig(cfg_.timeouts);
+    demux_->setTimeouts(cfg_.idle_timeout_ms, cfg_.lifetime_ms);
+
+    demux_->onFrameDone = [this](const FrameResult& r)
+    {
+        if (onFrameDone)
+            onFrameDone(r);
+    };
+
+    if (onFrameBand)
+    {
+        demux_->setBandRows(cfg_.band_rows);
+        demux_->onFrameBand = [this](const FrameBand& b) { onFrameBand(b); };
+    }
+
+    bool nt = hv::copy::configure(cfg_.copy, cfg_.max_frame_size);
+    HV_LOGI(hv::debug::Module::RX, "[COPY] mode=%s kernel=%s llc=%zu KB frame=%zu KB => %s",
+            hv::copy::modeName(cfg_.copy.mode), hv::copy::kernelName(),
+            hv::copy::llcBytes() / 1024, cfg_.max_frame_size / 1024,
+            nt ? "non-temporal" : "memcpy");
+
+    sock_ = sock;
+
+    // Spinning threads need cores of their own (see --cpus)
+    unsigned ncpu = std::thread::hardware_concurrency();
+    if (cfg_.wait.mode != hv::wait::Mode::BLOCK && ncpu < 3)
+        HV_LOGW(hv::debug::Module::RX, "[WAIT] mode=%s on %u CPU(s): spinning will starve other threads",
+                hv::wait::modeName(cfg_.wait.mode), ncpu);
+
+    if (cfg_.ingress == RxIngress::PACKET_RING)
+    {
+        sockaddr_in addr{};
+        socklen_t alen = sizeof(addr);
+        if (getsockname(sock, (sockaddr*)&addr, &alen) < 0)
+        {
+            perror("getsockname");
+            return false;
+        }
+
+        if (!ring_.open(cfg_.ring_ifname, ntohs(addr.sin_port), cfg_.ring))
+            return false;
+
+        // The UDP socket keeps the port (no ICMP unreachable) but must not queue a second copy
+        sock_filter drop_all = BPF_STMT(BPF_RET | BPF_K, 0);
+        sock_fprog prog{1, &drop_all};
+        if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0)
+            perror("setsockopt(SO_ATTACH_FILTER)");
+
+        rx_thread_ = std::thread(&RxPipeline::ringLoop, this);
+    }
+    else if (cfg_.ingress == RxIngress::URING)
+    {
+        std::promise<bool> ready;
+        std::future<bool> ok = ready.get_future();
+
+        rx_thread_ = std::thread(&RxPipeline::uringLoop, this, sock, &ready);
+        if (!ok.get())
+        {
+            rx_thread_.join();
+            return false;
+        }
+    }
+    else if (cfg_.ingress == RxIngress::SOCKET_RTC)
+    {
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0)
+        {
+            perror("eventfd");
+            return false;
+        }
+
+        rx_thread_ = std::thread(&RxPipeline::rtcLoop, this, sock);
+    }
+    else
+    {
+        rx_thread_     = std::thread(&RxPipeline::rxLoop, this, sock);
+        worker_thread_ = std::thread(&RxPipeline::workerLoop, this);
+    }
+
+    running_ = true;
+    return true;
+}
+
+void RxPipeline::stop()
+{
+    if (!running_)
+        return;
+
+    shutdown_.store(true, std::memory_order_relaxed);
+    queue_.wake();
+
+    if (wake_fd_ >= 0)
+    {
+        uint64_t one = 1;
+        if (write(wake_fd_, &one, sizeof(one)) < 0)
+            perror("write(eventfd)");
+    }
+
+    // RX End
+    if (rx_thread_.joinable())
+        rx_thread_.join();
+
+    // PROC End (Queue emptying + partial flush included)
+    if (worker_thread_.joinable())
+        worker_thread_.join();
+
+    ring_.close();
+
+    if (wake_fd_ >= 0)
+    {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+
+    running_ = false;
+}
+
+
+std::vector<StreamStatsSnapshot> RxPipeline::streamStats() const
+{
+    return demux_ ? demux_->snapshot() : std::vector<StreamStatsSnapshot>{};
+}
+
+
+/* ================================
+ *  Live tuning
+ * ================================ */
+namespace {
+
+bool sameTimeouts(const TimeoutConfig& a, const TimeoutConfig& b)
+{
+    return a.adaptive == b.adaptive
+        && a.idle_min == b.idle_min && a.idle_max == b.idle_max
+        && a.life_min == b.life_min && a.life_max == b.life_max
+        && a.gap_k == b.gap_k && a.span_k == b.span_k
+        && a.warmup_frames == b.warmup_frames;
+}
+
+} // namespace
+
+RxPipelineConfig RxPipeline::config() const
+{
+    std::lock_guard<std::mutex> lk(cfg_mtx_);
+    return cfg_;
+}
+
+void RxPipeline::reconfigure(const RxPipelineConfig& next)
+{
+    std::lock_guard<std::mutex> lk(cfg_mtx_);
+
+    if (next.queue_capacity != cfg_.queue_capacity)
+    {
+        // Packets queued beyond a smaller capacity stay; new ones drop until it drains
+        queue_.setCapacity(next.queue_capacity);
+        HV_LOGI(hv::debug::Module::RX, "[CONF] queue_capacity %zu => %zu (depth %zu)",
+                cfg_.queue_capacity, next.queue_capacity, queue_.depth());
+        cfg_.queue_capacity = next.queue_capacity;
+    }
+
+    if (next.rcvbuf != cfg_.rcvbuf)
+    {
+        int got = 0;
+        socklen_t len = sizeof(got);
+        if (sock_ >= 0)
+        {
+            if (setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &next.rcvbuf, sizeof(next.rcvbuf)) < 0)
+                perror("setsockopt(SO_RCVBUF)");
+            getsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &got, &len);
+        }
+        // The kernel doubles the request and caps it at net.core.rmem_max
+        HV_LOGI(hv::debug::Module::RX, "[CONF] rcvbuf %d => %d (kernel %d)",
+                cfg_.rcvbuf, next.rcvbuf, got);
+        cfg_.rcvbuf = next.rcvbuf;
+    }
+
+    bool frames = next.max_frame_size != cfg_.max_frame_size
+               || next.payload_stride != cfg_.payload_stride
+               || next.frame_buffers != cfg_.frame_buffers
+               || next.idle_timeout_ms != cfg_.idle_timeout_ms
+               || next.lifetime_ms != cfg_.lifetime_ms
+               || !sameTimeouts(next.timeouts, cfg_.timeouts);
+    if (!frames)
+        return;
+
+    cfg_.max_frame_size  = next.max_frame_size;
+    cfg_.payload_stride  = next.payload_stride;
+    cfg_.frame_buffers   = next.frame_buffers;
+    cfg_.idle_timeout_ms = next.idle_timeout_ms;
+    cfg_.lifetime_ms     = next.lifetime_ms;
+    cfg_.timeouts        = next.timeouts;
+
+    pending_ = cfg_;
+    reconf_pending_.store(true, std::memory_order_release);
+}
+
+void RxPipeline::applyPending(StreamDemux& demux)
+{
+    if (!reconf_pending_.load(std::memory_order_acquire))
+        return;
+
+    RxPipelineConfig c;
+    {
+        std::lock_guard<std::mutex> lk(cfg_mtx_);
+        c = pending_;
+        reconf_pending_.store(false, std::memory_order_relaxed);
+    }
+
+    demux.reconfigure(c.max_frame_size, c.payload_stride, c.frame_buffers,
+                      c.idle_timeout_ms, c.lifetime_ms, c.timeouts);
+
+    // AUTO picks the copy kernel from the frame size; this is the copying thread
+    bool nt = hv::copy::configure(c.copy, c.max_frame_size);
+
+    HV_LOGI(hv::debug::Module::RX,
+            "[CONF] applied frame=%zu B stride=%zu buffers=%zu idle=%u ms lifetime=%u ms adaptive=%d copy=%s",
+            c.max_frame_size, c.payload_stride, c.frame_buffers,
+            c.idle_timeout_ms, c.lifetime_ms, c.timeouts.adaptive ? 1 : 0,
+            nt ? "non-temporal" : "memcpy");
+}
+
+
+/* ================================
+ *  UDP RX Thread (recvmsg ONLY)
+ * ================================ */
+void RxPipeline::rxLoop(int sock)
+{
+    uint8_t buf[protocol::MAX_DATAGRAM] = {0,};
+
+    // recvmsg + receive timestamps / socket drop counter (rx_socket_meta.hpp)
+    alignas(cmsghdr) uint8_t ctrl[RX_CMSG_SPACE];
+    iovec iov{buf, sizeof(buf)};
+    msghdr msg{};
+    sockaddr_in src{};
+
+    RxCapture* capture = (cfg_.capture && cfg_.capture->isOpen()) ? cfg_.capture : nullptr;
+
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+
+    pthread_setname_np(pthread_self(), "hv_rx");
+
+    // CPU set / SCHED_FIFO (root required) from hv::placement, verified + logged
+    hv::placement::apply(hv::placement::Role::RX);
+
+    const hv::wait::Config wait = cfg_.wait;
+    hv::wait::prepareSocket(sock, wait);
+
+    const uint64_t spin_ns = (wait.mode == hv::wait::Mode::SPIN_PARK)
+                           ? static_cast<uint64_t>(wait.spin_us) * 1000ull : 0;
+    uint64_t last_rx_ns  = 0;
+    uint64_t next_cpu_ns = 0;
+
+    FrameAdmission admission(cfg_.admission);
+
+    HV_LOGI(hv::debug::Module::RX, "##udp_rx_thread created (wait=%s, shed=%s)",
+            hv::wait::modeName(wait.mode), shedPolicyName(cfg_.admission.policy));
+
+    while (!shutdown_.load(std::memory_order_relaxed))
+    {
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = ctrl;
+        msg.msg_controllen = sizeof(ctrl);
+        msg.msg_name       = &src;
+        msg.msg_namelen    = sizeof(src);
+
+        // Non-blocking first: under load the socket is rarely empty, so no poll() per packet
+        ssize_t len = recvmsg(sock, &msg, MSG_DONTWAIT);
+
+        uint64_t now_ns = hv::stats::monotonicNs();
+        if (now_ns >= next_cpu_ns)
+        {
+            uint64_t cpu = hv::wait::threadCpuNs();
+            rx_cpu_ns_.store(cpu, std::memory_order_relaxed);
+            hv::stats::set(hv::stats::RX_CPU_US, static_cast<int64_t>(cpu / 1000));
+            next_cpu_ns = now_ns + 100000000ull;
+        }
+
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                perror("recvmsg");
+                break;
+            }
+
+            // Socket empty: busy-poll / spin for a while, or sleep in poll()
+            if (wait.mode == hv::wait::Mode::BUSY_POLL
+                || (spin_ns && now_ns - last_rx_ns < spin_ns))
+            {
+                hv::wait::cpuRelax();
+                continue;
+            }
+
+            int ret = poll(&pfd, 1, 100); // 100ms timeout => shutdown check
+            if (ret < 0 && errno != EINTR)
+            {
+                perror("poll");
+                break;
+            }
+            continue;
+        }
+        if (len == 0)
+            continue;
+
+        last_rx_ns = now_ns;
+
+        RxSocketMeta meta;
+        parse_rx_cmsg(msg, meta);
+        recordRxTimestamps(meta);
+
+        uint64_t k_ns = meta.sw_ns ? meta.sw_ns : hv::stats::realtimeNs();
+
+        // Capture sees every datagram, including ones rejected below
+        if (capture)
+            capture->record(buf, static_cast<size_t>(len), k_ns,
+                            src.sin_addr.s_addr, src.sin_port);
+
+        if (msg.msg_flags & MSG_TRUNC)
+            continue;
+
+        // v1 / v2 header, payload size sanity check
+        UdpPacketHeader hdr;
+        size_t hdr_len = decode_packet_header(buf, static_cast<size_t>(len), hdr);
+        if (hdr_len == 0)
+            continue;
+
+        if (hdr.send_ns && k_ns >= hdr.send_ns)
+            hv::stats::record(hv::stats::LAT_SENDER_TO_KERNEL, k_ns - hdr.send_ns);
+
+        uint32_t kernel_drops = kdrops_.onDatagram(meta, hdr);
+
+        debug_log::rx_packet(len);
+        hv::stats::add(hv::stats::RX_PACKETS);
+        hv::stats::add(hv::stats::RX_BYTES, static_cast<uint64_t>(len));
+
+        hv::trace::record(hv::trace::EV_RX_PACKET,
+                          hdr.frame_id,
+                          hdr.packet_id,
+                          hdr.packet_count,
+                          0,
+                          static_cast<uint32_t>(len));
+
+        // Whole frames go under pressure, not a packet of every frame.
+        // Decided on the header alone: a shed packet is never allocated or copied.
+        if (!admission.admit(hdr, src.sin_addr.s_addr, src.sin_port, queue_.depth(), queue_.capacity()))
+            continue;
+
+        std::unique_ptr<RxPacket> pkt(new RxPacket);
+        pkt->hdr          = hdr;
+        pkt->kernel_drops = kernel_drops;
+        pkt->gap_before   = false;
+
+        // payload Copy
+        std::memcpy(pkt->reservePayload(hdr.payload_size),
+                    buf + hdr_len,
+                    hdr.payload_size);
+
+        pkt->rx_ns    = hv::stats::monotonicNs();
+        pkt->src_ip   = src.sin_addr.s_addr;
+        pkt->src_port = src.sin_port;
+
+        //  Move ownership to the queue.
+        if (!queue_.push(std::move(pkt)))
+        {
+            hv::stats::add(hv::stats::QUEUE_DROPS);
+            hv::trace::record(hv::trace::EV_QUEUE_DROP,
+                              hdr.frame_id, hdr.packet_id, hdr.packet_count);
+            admission.onQueueFull(hdr, src.sin_addr.s_addr, src.sin_port);
+        }
+    }
+
+    rx_cpu_ns_.store(hv::wait::threadCpuNs(), std::memory_order_relaxed);
+
+    HV_LOGI(hv::debug::Module::RX, "udp_rx_thread exiting!!!");
+}
+
+
+/* ================================
+ * Frame Worker Thread
+ *  - FrameReassemblerManager
+ * ================================ */
+void RxPipeline::workerLoop()
+{
+    pthread_setname_np(pthread_self(), "hv_frame");
+    hv::placement::apply(hv::placement::Role::WORKER);
+
+    StreamDemux& demux = *demux_;
+
+    const hv::wait::Config wait = cfg_.wait;
+    const auto timer_period = std::chrono::milliseconds(5);
+
+    auto last_timer = std::chrono::steady_clock::now();
+    auto drain_start = std::chrono::steady_clock::time_point{};
+
+    while (true)
+    {
+        std::unique_ptr<RxPacket> pkt;
+
+        // Wait for a packet, but no longer than the next timer tick
+        auto now = std::chrono::steady_clock::now();
+        bool idle = false;
+        bool got = queue_.pop_wait(
+            pkt,
+            wait,
+            last_timer + timer_period - now,
+            shutdown_,
+            &idle
+        );
+
+        if (got)
+        {
+            uint64_t dwell = hv::stats::monotonicNs() - pkt->rx_ns;
+            hv::stats::record(hv::stats::LAT_QUEUE_DWELL, dwell);
+            if (idle)
+                hv::stats::record(hv::stats::LAT_WORKER_WAKEUP, dwell);
+
+            size_t queue_now = queue_.dropped();
+            demux.pushPacket(pkt->hdr, pkt->payload(), pkt->src_ip, pkt->src_port,
+                             pkt->gap_before, queue_now, pkt->kernel_drops);
+        }
+
+        //Timer processing
+        now = std::chrono::steady_clock::now();
+        if (now - last_timer >= timer_period)
+        {
+            applyPending(demux);
+            demux.pollTimers(queue_.dropped());
+            hv::stats::set(hv::stats::QUEUE_DEPTH, static_cast<int64_t>(queue_.size()));
+
+            uint64_t cpu = hv::wait::threadCpuNs();
+            worker_cpu_ns_.store(cpu, std::memory_order_relaxed);
+            hv::stats::set(hv::stats::WORKER_CPU_US, static_cast<int64_t>(cpu / 1000));
+
+            last_timer = now;
+        }
+
+        //Termination condition
+        if (shutdown_.load()
+                && queue_.empty())
+        {
+            if (drain_start.time_since_epoch().count() == 0)
+                drain_start = std::chrono::steady_clock::now();
+
+            if (std::chrono::steady_clock::now() - drain_start
+                > std::chrono::milliseconds(100))
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Forced flush at termination
+    HV_LOGI(hv::debug::Module::FRAME, "frame_worker_thread exiting");
+
+    demux.flushAll();
+
+    worker_cpu_ns_.store(hv::wait::threadCpuNs(), std::memory_order_relaxed);
+}
+
+
+/* ================================
+ * NIC => kernel => user latency of one datagram
+ * ================================ */
+void RxPipeline::recordRxTimestamps(const RxSocketMeta& meta)
+{
+    if (!meta.sw_ns)
+        return;
+
+    uint64_t uts = hv::stats::realtimeNs();
+    if (uts >= meta.sw_ns)
+        hv::stats::record(hv::stats::LAT_KERNEL_TO_USER, uts - meta.sw_ns);
+
+    // Meaningful only with the PHC disciplined to CLOCK_REALTIME (phc2sys)
+    if (meta.hw_ns && meta.sw_ns >= meta.hw_ns)
+        hv::stats::record(hv::stats::LAT_NIC_TO_KERNEL, meta.sw_ns - meta.hw_ns);
+}
+
+
+/* ================================
+ * Zero-copy ingress => stream demux => manager
+ *  - data points into a ring / provided buffer, valid for this call only
+ * ================================ */
+void RxPipeline::ingest(StreamDemux& demux, RxCapture* capture,
+                        const uint8_t* data, uint32_t len, const RxSocketMeta& meta,
+                        uint32_t src_ip, uint16_t src_port)
+{
+    recordRxTimestamps(meta);
+    uint64_t ts_ns = meta.sw_ns;
+
+    if (capture)
+        capture->record(data, len, ts_ns ? ts_ns : hv::stats::realtimeNs(), src_ip, src_port);
+
+    // v1 / v2 header, payload size sanity check
+    UdpPacketHeader hdr;
+    size_t hdr_len = decode_packet_header(data, len, hdr);
+    if (hdr_len == 0)
+        return;
+
+    if (hdr.send_ns && ts_ns >= hdr.send_ns)
+        hv::stats::record(hv::stats::LAT_SENDER_TO_KERNEL, ts_ns - hdr.send_ns);
+
+    debug_log::rx_packet(len);
+    hv::stats::add(hv::stats::RX_PACKETS);
+    hv::stats::add(hv::stats::RX_BYTES, len);
+
+    hv::trace::record(hv::trace::EV_RX_PACKET,
+                      hdr.frame_id, hdr.packet_id, hdr.packet_count,
+                      0, len);
+
+    uint32_t kernel_drops = kdrops_.onDatagram(meta, hdr);
+
+    // Straight from the kernel buffer into the frame buffer: the only copy
+    demux.pushPacket(hdr, data + hdr_len, src_ip, src_port, false, 0, kernel_drops);
+}
+
+
+/* ================================
+ * AF_PACKET Ring Thread
+ *  - TPACKET_V3 block => FrameReassemblerManager, in place
+ * ================================ */
+void RxPipeline::ringLoop()
+{
+    pthread_setname_np(pthread_self(), "hv_rx");
+    hv::placement::apply(hv::placement::Role::RX);
+
+    StreamDemux& demux = *demux_;
+
+    RxCapture* capture = (cfg_.capture && cfg_.capture->isOpen()) ? cfg_.capture : nullptr;
+
+    const hv::wait::Config wait = cfg_.wait;
+    const uint64_t spin_ns = (wait.mode == hv::wait::Mode::SPIN_PARK)
+                           ? static_cast<uint64_t>(wait.spin_us) * 1000ull : 0;
+    uint64_t last_rx_ns = 0;
+
+    const auto timer_period = std::chrono::milliseconds(5);
+    auto last_timer = std::chrono::steady_clock::now();
+    uint64_t ring_drops = 0;
+
+    HV_LOGI(hv::debug::Module::RX, "##ring_rx_thread created (wait=%s)", hv::wait::modeName(wait.mode));
+
+    auto onDatagram = [&](const PacketRing::Datagram& d)
+    {
+        RxSocketMeta meta;
+        meta.sw_ns = d.ts_ns;
+        ingest(demux, capture, d.data, d.len, meta, d.src_ip, d.src_port);
+    };
+
+    while (!shutdown_.load(std::memory_order_relaxed))
+    {
+        uint64_t now_ns = hv::stats::monotonicNs();
+
+        int timeout_ms = 5;
+        if (wait.mode == hv::wait::Mode::BUSY_POLL
+            || (spin_ns && now_ns - last_rx_ns < spin_ns))
+            timeout_ms = 0;
+
+        size_t n = ring_.poll(timeout_ms, onDatagram);
+        if (n)
+            last_rx_ns = now_ns;
+        else if (timeout_ms == 0)
+            hv::wait::cpuRelax();
+
+        //Timer processing
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_timer >= timer_period)
+        {
+            applyPending(demux);
+            demux.pollTimers(0);
+
+            uint64_t drops = ring_.updateStats().drops;
+            if (drops != ring_drops)
+            {
+                hv::stats::add(hv::stats::RING_DROPS, drops - ring_drops);
+                ring_drops = drops;
+            }
+
+            uint64_t cpu = hv::wait::threadCpuNs();
+            rx_cpu_ns_.store(cpu, std::memory_order_relaxed);
+            hv::stats::set(hv::stats::RX_CPU_US, static_cast<int64_t>(cpu / 1000));
+
+            last_timer = now;
+        }
+    }
+
+    // Blocks already retired to user space
+    while (ring_.poll(0, onDatagram))
+        ;
+
+    HV_LOGI(hv::debug::Module::RX, "ring_rx_thread exiting (packets=%llu blocks=%llu drops=%llu)",
+            static_cast<unsigned long long>(ring_.stats().packets),
+            static_cast<unsigned long long>(ring_.stats().blocks),
+            static_cast<unsigned long long>(ring_.updateStats().drops));
+
+    demux.flushAll();
+
+    rx_cpu_ns_.store(hv::wait::threadCpuNs(), std::memory_order_relaxed);
+}
+
+
+/* ================================
+ * io_uring Thread
+ *  - multishot recvmsg CQE batch => FrameReassemblerManager
+ *  - provided buffers recycled after each batch
+ * ================================ */
+void RxPipeline::uringLoop(int sock, std::promise<bool>* ready)
+{
+    pthread_setname_np(pthread_self(), "hv_rx");
+    hv::placement::apply(hv::placement::Role::RX);
+
+    // SINGLE_ISSUER / DEFER_TASKRUN: the ring belongs to the thread that creates it
+    bool ok = uring_.open(sock, cfg_.uring);
+    ready->set_value(ok);
+    if (!ok)
+        return;
+
+    StreamDemux& demux = *demux_;
+
+    RxCapture* capture = (cfg_.capture && cfg_.capture->isOpen()) ? cfg_.capture : nullptr;
+
+    const hv::wait::Config wait = cfg_.wait;
+    const uint64_t spin_ns = (wait.mode == hv::wait::Mode::SPIN_PARK)
+                           ? static_cast<uint64_t>(wait.spin_us) * 1000ull : 0;
+    uint64_t last_rx_ns = 0;
+
+    const auto timer_period = std::chrono::milliseconds(5);
+    auto last_timer = std::chrono::steady_clock::now();
+    uint64_t no_buffers = 0;
+
+    constexpr size_t BATCH = 256;
+    UringRx::Datagram batch[BATCH];
+
+    HV_LOGI(hv::debug::Module::RX, "##uring_rx_thread created (wait=%s)", hv::wait::modeName(wait.mode));
+
+    while (!shutdown_.load(std::memory_order_relaxed))
+    {
+        uint64_t now_ns = hv::stats::monotonicNs();
+
+        int timeout_ms = 5;
+        if (wait.mode == hv::wait::Mode::BUSY_POLL
+            || (spin_ns && now_ns - last_rx_ns < spin_ns))
+            timeout_ms = 0;
+
+        size_t n = uring_.wait(batch, BATCH, timeout_ms);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const UringRx::Datagram& d = batch[i];
+            if (!d.truncated)
+                ingest(demux, capture, d.data, d.len, d.meta, d.src_ip, d.src_port);
+        }
+
+        // Payload copied into frame buffers => buffers back to the kernel
+        uring_.recycle();
+
+        if (n)
+            last_rx_ns = now_ns;
+        else if (timeout_ms == 0)
+            hv::wait::cpuRelax();
+
+        //Timer processing
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_timer >= timer_period)
+        {
+            applyPending(demux);
+            demux.pollTimers(0);
+
+            // Buffer ring ran dry: datagrams wait in the socket until the rearm
+            if (uring_.stats().no_buffers != no_buffers)
+            {
+                HV_LOGW_RL(hv::debug::Module::RX, 1, 1, "[URNG] provided buffers exhausted (%llu times)",
+                           static_cast<unsigned long long>(uring_.stats().no_buffers));
+                no_buffers = uring_.stats().no_buffers;
+            }
+
+            uint64_t cpu = hv::wait::threadCpuNs();
+            rx_cpu_ns_.store(cpu, std::memory_order_relaxed);
+            hv::stats::set(hv::stats::RX_CPU_US, static_cast<int64_t>(cpu / 1000));
+
+            last_timer = now;
+        }
+    }
+
+    const UringRx::Stats& st = uring_.stats();
+    HV_LOGI(hv::debug::Module::RX, "uring_rx_thread exiting (cqes=%llu enters=%llu rearms=%llu nobufs=%llu)",
+            static_cast<unsigned long long>(st.completions),
+            static_cast<unsigned long long>(st.enters),
+            static_cast<unsigned long long>(st.rearms),
+            static_cast<unsigned long long>(st.no_buffers));
+
+    uring_.close();
+    demux.flushAll();
+
+    rx_cpu_ns_.store(hv::wait::threadCpuNs(), std::memory_order_relaxed);
+}
+
+
+
+/* ================================
+ * Run-to-completion Thread
+ *  - epoll: socket + timerfd (5 ms) + eventfd (stop)
+ *  - recvmmsg batch => FrameReassemblerManager, no queue
+ * ================================ */
+void RxPipeline::rtcLoop(int sock)
+{
+    pthread_setname_np(pthread_self(), "hv_rx");
+    hv::placement::apply(hv::placement::Role::RX);
+
+    StreamDemux& demux = *demux_;
+
+    RxCapture* capture = (cfg_.capture && cfg_.capture->isOpen()) ? cfg_.capture : nullptr;
+
+    const hv::wait::Config wait = cfg_.wait;
+    hv::wait::prepareSocket(sock, wait);
+
+    const uint64_t spin_ns = (wait.mode == hv::wait::Mode::SPIN_PARK)
+                           ? static_cast<uint64_t>(wait.spin_us) * 1000ull : 0;
+    uint64_t last_rx_ns = 0;
+
+    // Timer tick as an fd: expirations run on this thread, between batches
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    int efd = epoll_create1(EPOLL_CLOEXEC);
+    if (tfd < 0 || efd < 0)
+    {
+        perror("timerfd/epoll");
+        if (tfd >= 0) close(tfd);
+        if (efd >= 0) close(efd);
+        return;
+    }
+
+    itimerspec its{};
+    its.it_interval.tv_nsec = 5 * 1000000;
+    its.it_value.tv_nsec    = 5 * 1000000;
+    timerfd_settime(tfd, 0, &its, nullptr);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = sock;
+    epoll_ctl(efd, EPOLL_CTL_ADD, sock, &ev);
+    ev.data.fd = tfd;
+    epoll_ctl(efd, EPOLL_CTL_ADD, tfd, &ev);
+    ev.data.fd = wake_fd_;
+    epoll_ctl(efd, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+    // recvmmsg batch, buffers reused for every call
+    constexpr unsigned BATCH = 64;
+    constexpr size_t   BUF_SIZE = protocol::MAX_DATAGRAM;
+
+    std::unique_ptr<uint8_t[]> bufs(new uint8_t[BATCH * BUF_SIZE]);
+    alignas(cmsghdr) uint8_t ctrl[BATCH][RX_CMSG_SPACE];
+    sockaddr_in src[BATCH];
+    iovec iov[BATCH];
+    mmsghdr msgs[BATCH];
+
+    HV_LOGI(hv::debug::Module::RX, "##rtc_rx_thread created (wait=%s batch=%u)",
+            hv::wait::modeName(wait.mode), BATCH);
+
+    uint64_t batches = 0;
+    uint64_t wakeups = 0;
+
+    auto drain = [&]() -> int
+    {
+        for (unsigned i = 0; i < BATCH; ++i)
+        {
+            iov[i].iov_base = bufs.get() + i * BUF_SIZE;
+            iov[i].iov_len  = BUF_SIZE;
+
+            msghdr& m = msgs[i].msg_hdr;
+            m.msg_iov        = &iov[i];
+            m.msg_iovlen     = 1;
+            m.msg_control    = ctrl[i];
+            m.msg_controllen = sizeof(ctrl[i]);
+            m.msg_name       = &src[i];
+            m.msg_namelen    = sizeof(src[i]);
+            m.msg_flags      = 0;
+        }
+
+        int n = recvmmsg(sock, msgs, BATCH, MSG_DONTWAIT, nullptr);
+        if (n <= 0)
+            return n;
+
+        batches++;
+        for (int i = 0; i < n; ++i)
+        {
+            msghdr& m = msgs[i].msg_hdr;
+            RxSocketMeta meta;
+            parse_rx_cmsg(m, meta);
+
+            if (m.msg_flags & MSG_TRUNC)
+                continue;
+
+            ingest(demux, capture, static_cast<const uint8_t*>(iov[i].iov_base),
+                   msgs[i].msg_len, meta, src[i].sin_addr.s_addr, src[i].sin_port);
+        }
+        return n;
+    };
+
+    while (!shutdown_.load(std::memory_order_relaxed))
+    {
+        // Socket first: under load it is rarely empty, epoll only when idle
+        int n = drain();
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            perror("recvmmsg");
+            break;
+        }
+
+        uint64_t now_ns = hv::stats::monotonicNs();
+        if (n > 0)
+            last_rx_ns = now_ns;
+
+        int timeout_ms = -1;
+        if (n == static_cast<int>(BATCH))
+            timeout_ms = 0;         // likely more queued, only check timers
+        else if (wait.mode == hv::wait::Mode::BUSY_POLL
+                 || (spin_ns && now_ns - last_rx_ns < spin_ns))
+            timeout_ms = 0;
+
+        epoll_event events[3];
+        int ne = epoll_wait(efd, events, 3, timeout_ms);
+        if (ne < 0 && errno != EINTR)
+        {
+            perror("epoll_wait");
+            break;
+        }
+        if (timeout_ms != 0)
+            wakeups++;
+        else if (ne == 0 && n <= 0)
+            hv::wait::cpuRelax();
+
+        for (int i = 0; i < ne; ++i)
+        {
+            if (events[i].data.fd != tfd)
+                continue;               // socket: next drain(), eventfd: loop condition
+
+            //Timer processing
+            uint64_t expirations;
+            if (read(tfd, &expirations, sizeof(expirations)) < 0)
+                continue;
+
+            applyPending(demux);
+            demux.pollTimers(0);
+
+            uint64_t cpu = hv::wait::threadCpuNs();
+            rx_cpu_ns_.store(cpu, std::memory_order_relaxed);
+            hv::stats::set(hv::stats::RX_CPU_US, static_cast<int64_t>(cpu / 1000));
+        }
+    }
+
+    // Whatever the socket still holds
+    while (drain() > 0)
+        ;
+
+    HV_LOGI(hv::debug::Module::RX, "rtc_rx_thread exiting (batches=%llu wakeups=%llu)",
+            static_cast<unsigned long long>(batches),
+            static_cast<unsigned long long>(wakeups));
+
+    close(efd);
+    close(tfd);
+
+    demux.flushAll();
+
+    rx_cpu_ns_.store(hv::wait::threadCpuNs(), std::memory_order_relaxed);
+}
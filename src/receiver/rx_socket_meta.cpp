@@ -0,0 +1,102 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Receive Socket Instrumentation                  */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <linux/net_tstamp.h>
+#include <cstdio>
+#include <cstring>
+
+#include "receiver/rx_socket_meta.hpp"
+
+#include "debug/debug_stats.hpp"
+#include "debug/flight_recorder.hpp"
+#include "debug/hv_debug.hpp"
+
+#ifndef SO_RXQ_OVFL
+#define SO_RXQ_OVFL 40
+#endif
+
+
+void enable_rx_instrumentation(int sock)
+{
+    int on = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) < 0)
+        perror("setsockopt(SO_RXQ_OVFL)");
+
+    // Raw hardware stamps only arrive once the NIC is configured (SIOCSHWTSTAMP, ptp4l)
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE
+              | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0)
+        return;
+    perror("setsockopt(SO_TIMESTAMPING)");
+
+    if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0)
+        perror("setsockopt(SO_TIMESTAMPNS)");
+}
+
+void parse_rx_cmsg(const msghdr& m, RxSocketMeta& out)
+{
+    out = RxSocketMeta{};
+
+    for (cmsghdr* c = CMSG_FIRSTHDR(&m); c; c = CMSG_NXTHDR(const_cast<msghdr*>(&m), c))
+    {
+        if (c->cmsg_level != SOL_SOCKET)
+            continue;
+
+        if (c->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            timespec ts;
+            std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            out.sw_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+        }
+        else if (c->cmsg_type == SCM_TIMESTAMPING)
+        {
+            timespec ts[3];
+            std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+            if (ts[0].tv_sec || ts[0].tv_nsec)
+                out.sw_ns = static_cast<uint64_t>(ts[0].tv_sec) * 1000000000ull + ts[0].tv_nsec;
+            if (ts[2].tv_sec || ts[2].tv_nsec)
+                out.hw_ns = static_cast<uint64_t>(ts[2].tv_sec) * 1000000000ull + ts[2].tv_nsec;
+        }
+        else if (c->cmsg_type == SO_RXQ_OVFL)
+        {
+            std::memcpy(&out.ovfl, CMSG_DATA(c), sizeof(out.ovfl));
+            out.has_ovfl = true;
+        }
+    }
+}
+
+
+/*-------------------------------------------*/
+/* Kernel drop attribution                   */
+/*-------------------------------------------*/
+uint32_t KernelDropTracker::onDatagram(const RxSocketMeta& meta, const UdpPacketHeader& hdr)
+{
+    uint32_t drops = 0;
+    if (meta.has_ovfl && meta.ovfl != last_ovfl_)
+    {
+        drops = meta.ovfl - last_ovfl_;         // wraps correctly
+        last_ovfl_ = meta.ovfl;
+    }
+
+    // Loss right before the first packet of a new frame was the previous frame's tail
+    bool new_frame = has_prev_ && (hdr.frame_id != prev_frame_ || hdr.stream_id != prev_stream_)
+                  && hdr.packet_id == 0;
+    uint32_t frame_id  = new_frame ? prev_frame_ : hdr.frame_id;
+
+    prev_frame_  = hdr.frame_id;
+    prev_stream_ = hdr.stream_id;
+    has_prev_    = true;
+
+    if (drops == 0)
+        return 0;
+
+    total_ += drops;
+    hv::stats::add(hv::stats::KERNEL_DROPS, drops);
+    hv::trace::record(hv::trace::EV_KERNEL_DROP, frame_id, 0, 0, 0, drops);
+    HV_LOGW_RL(hv::debug::Module::RX, 1, 10, "[KDRP] %u datagrams dropped by the socket (frame=%u, total=%llu)",
+               drops, frame_id, static_cast<unsigned long long>(total_));
+
+    return new_frame ? 0 : drops;
+}
@@ -0,0 +1,402 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX io_uring Receive                                */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "receiver/rx_uring.hpp"
+
+#include "debug/hv_debug.hpp"
+
+#ifdef HV_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint16_t BUF_GROUP     = 0;
+constexpr uint64_t TAG_RECVMSG   = 1;
+
+int sysSetup(uint32_t entries, io_uring_params* p)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sysRegister(int fd, unsigned op, void* arg, unsigned nr)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, op, arg, nr));
+}
+
+/*
+ * io_uring_buf_ring::bufs comes from __DECLARE_FLEX_ARRAY, whose empty
+ * placeholder struct is 1 byte in C++ (0 in C): the member lands at
+ * offset 8 instead of 0.  Index the descriptors from the ring base.
+ */
+io_uring_buf* ringBuf(void* br, uint32_t idx)
+{
+    return static_cast<io_uring_buf*>(br) + idx;
+}
+
+template <typename T>
+T* at(void* base, uint32_t off)
+{
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + off);
+}
+
+} // namespace
+
+
+bool UringRx::available() { return true; }
+
+UringRx::~UringRx()
+{
+    close();
+}
+
+bool UringRx::open(int sock, const UringRxConfig& cfg)
+{
+    if (ring_fd_ >= 0)
+        return false;
+
+    if (cfg.buffers == 0 || (cfg.buffers & (cfg.buffers - 1)) || cfg.buffers > 32768)
+    {
+        std::fprintf(stderr, "io_uring: buffer count must be a power of two <= 32768\n");
+        return false;
+    }
+
+    /* 1. Ring: single issuer + deferred task work (completions run in our enter) */
+    io_uring_params p{};
+    p.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    p.cq_entries = cfg.cq_entries;
+
+    ring_fd_ = sysSetup(cfg.sq_entries, &p);
+    if (ring_fd_ < 0 && errno == EINVAL)
+    {
+        // Kernel < 6.1
+        std::memset(&p, 0, sizeof(p));
+        p.flags      = IORING_SETUP_CQSIZE;
+        p.cq_entries = cfg.cq_entries;
+        ring_fd_ = sysSetup(cfg.sq_entries, &p);
+    }
+    if (ring_fd_ < 0)
+    {
+        perror("io_uring_setup");
+        return false;
+    }
+
+    if (!(p.features & IORING_FEAT_EXT_ARG))
+    {
+        std::fprintf(stderr, "io_uring: kernel lacks IORING_FEAT_EXT_ARG (need >= 5.11)\n");
+        close();
+        return false;
+    }
+
+    /* 2. Map SQ / CQ rings and the SQE array */
+    sq_len_ = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single)
+        sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+
+    sq_ptr_ = mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED)
+    {
+        perror("mmap(SQ ring)");
+        sq_ptr_ = nullptr;
+        close();
+        return false;
+    }
+
+    if (single)
+        cq_ptr_ = sq_ptr_;
+    else
+    {
+        cq_ptr_ = mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED)
+        {
+            perror("mmap(CQ ring)");
+            cq_ptr_ = nullptr;
+            close();
+            return false;
+        }
+    }
+
+    sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED)
+    {
+        perror("mmap(SQEs)");
+        sqes_ = nullptr;
+        close();
+        return false;
+    }
+
+    sq_head_  = at<uint32_t>(sq_ptr_, p.sq_off.head);
+    sq_tail_  = at<uint32_t>(sq_ptr_, p.sq_off.tail);
+    sq_mask_  = *at<uint32_t>(sq_ptr_, p.sq_off.ring_mask);
+    sq_array_ = at<uint32_t>(sq_ptr_, p.sq_off.array);
+
+    cq_head_  = at<uint32_t>(cq_ptr_, p.cq_off.head);
+    cq_tail_  = at<uint32_t>(cq_ptr_, p.cq_off.tail);
+    cq_mask_  = *at<uint32_t>(cq_ptr_, p.cq_off.ring_mask);
+    cqes_     = at<void>(cq_ptr_, p.cq_off.cqes);
+
+    /* 3. Provided buffer ring: descriptors (page aligned) + buffer memory */
+    buf_count_ = cfg.buffers;
+    buf_size_  = cfg.buf_size;
+
+    long page = sysconf(_SC_PAGESIZE);
+    br_len_ = (buf_count_ * sizeof(io_uring_buf) + page - 1) / page * page;
+    br_ = mmap(nullptr, br_len_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br_ == MAP_FAILED)
+    {
+        perror("mmap(buffer ring)");
+        br_ = nullptr;
+        close();
+        return false;
+    }
+
+    bufs_ = static_cast<uint8_t*>(std::aligned_alloc(64, static_cast<size_t>(buf_count_) * buf_size_));
+    pending_ = new uint16_t[buf_count_];
+    if (!bufs_)
+    {
+        close();
+        return false;
+    }
+
+    auto* br = static_cast<io_uring_buf_ring*>(br_);
+    for (uint32_t i = 0; i < buf_count_; ++i)
+    {
+        io_uring_buf* b = ringBuf(br_, i);
+        b->addr = reinterpret_cast<uint64_t>(bufs_ + static_cast<size_t>(i) * buf_size_);
+        b->len  = buf_size_;
+        b->bid  = static_cast<uint16_t>(i);
+    }
+    br_tail_ = static_cast<uint16_t>(buf_count_);
+    __atomic_store_n(&br->tail, br_tail_, __ATOMIC_RELEASE);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr    = reinterpret_cast<uint64_t>(br_);
+    reg.ring_entries = buf_count_;
+    reg.bgid         = BUF_GROUP;
+    if (sysRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        perror("io_uring_register(PBUF_RING)");
+        close();
+        return false;
+    }
+
+    /* 4. Multishot recvmsg: the kernel lays out name + control + data in each buffer */
+    sock_ = sock;
+    std::memset(&msg_, 0, sizeof(msg_));
+    msg_.msg_namelen    = sizeof(sockaddr_in);
+    msg_.msg_controllen = RX_CMSG_SPACE;
+
+    stats_ = Stats{};
+    if (!arm())
+    {
+        close();
+        return false;
+    }
+
+    HV_LOGI(hv::debug::Module::RX, "[URNG] multishot recvmsg, %u x %u B provided buffers, cq=%u%s",
+            buf_count_, buf_size_, p.cq_entries,
+            (p.flags & IORING_SETUP_DEFER_TASKRUN) ? " defer-taskrun" : "");
+    return true;
+}
+
+void UringRx::close()
+{
+    if (ring_fd_ >= 0)
+    {
+        ::close(ring_fd_);          // cancels the multishot request, unregisters buffers
+        ring_fd_ = -1;
+    }
+    if (sqes_)   { munmap(sqes_, sqes_len_); sqes_ = nullptr; }
+    if (cq_ptr_ && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_len_);
+    cq_ptr_ = nullptr;
+    if (sq_ptr_) { munmap(sq_ptr_, sq_len_); sq_ptr_ = nullptr; }
+    if (br_)     { munmap(br_, br_len_); br_ = nullptr; }
+
+    std::free(bufs_);
+    bufs_ = nullptr;
+    delete[] pending_;
+    pending_ = nullptr;
+    pending_n_ = 0;
+    armed_ = false;
+}
+
+int UringRx::enter(uint32_t to_submit, uint32_t min_complete, int timeout_ms)
+{
+    __kernel_timespec ts{};
+    ts.tv_sec  = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+
+    io_uring_getevents_arg arg{};
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+    // GETEVENTS always: with DEFER_TASKRUN completions are only posted here
+    unsigned flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+
+    stats_.enters++;
+    int rc = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                                      flags, &arg, sizeof(arg)));
+    if (rc < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        perror("io_uring_enter");
+    return rc;
+}
+
+bool UringRx::arm()
+{
+    uint32_t tail = *sq_tail_;
+    uint32_t idx  = tail & sq_mask_;
+
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + idx;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = IORING_OP_RECVMSG;
+    sqe->fd        = sock_;
+    sqe->addr      = reinterpret_cast<uint64_t>(&msg_);
+    sqe->len       = 0;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUF_GROUP;
+    sqe->user_data = TAG_RECVMSG;
+
+    sq_array_[idx] = idx;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+    if (enter(1, 0, 0) < 0 && errno != ETIME)
+        return false;
+
+    armed_ = true;
+    stats_.rearms++;
+    return true;
+}
+
+size_t UringRx::wait(Datagram* out, size_t max, int timeout_ms)
+{
+    if (pending_n_)
+        recycle();
+
+    if (!armed_ && !arm())
+        return 0;
+
+    uint32_t head = *cq_head_;
+    uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    if (head == tail)
+    {
+        enter(0, timeout_ms > 0 ? 1 : 0, timeout_ms);
+        tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    }
+
+    size_t n = 0;
+    for (; head != tail && n < max; ++head)
+    {
+        const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & cq_mask_);
+        stats_.completions++;
+
+        if (!(cqe->flags & IORING_CQE_F_MORE))
+            armed_ = false;         // multishot ended (error, ENOBUFS, overflow) => rearm
+
+        if (!(cqe->flags & IORING_CQE_F_BUFFER))
+        {
+            if (cqe->res == -ENOBUFS)
+                stats_.no_buffers++;
+            continue;
+        }
+
+        uint16_t bid = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        pending_[pending_n_++] = bid;
+
+        if (cqe->res < 0)
+            continue;
+
+        uint8_t* buf = bufs_ + static_cast<size_t>(bid) * buf_size_;
+        const auto* o = reinterpret_cast<const io_uring_recvmsg_out*>(buf);
+
+        uint8_t* name    = buf + sizeof(io_uring_recvmsg_out);
+        uint8_t* control = name + msg_.msg_namelen;
+        uint8_t* payload = control + msg_.msg_controllen;
+
+        uint32_t avail = static_cast<uint32_t>(cqe->res) - static_cast<uint32_t>(payload - buf);
+
+        Datagram& d = out[n];
+        d.data      = payload;
+        d.len       = std::min(o->payloadlen, avail);
+        d.truncated = (o->flags & MSG_TRUNC) != 0;
+        d.src_ip    = 0;
+        d.src_port  = 0;
+
+        if (o->namelen >= sizeof(sockaddr_in))
+        {
+            const auto* sin = reinterpret_cast<const sockaddr_in*>(name);
+            d.src_ip   = sin->sin_addr.s_addr;
+            d.src_port = sin->sin_port;
+        }
+
+        msghdr cm{};
+        cm.msg_control    = control;
+        cm.msg_controllen = o->controllen;
+        parse_rx_cmsg(cm, d.meta);
+
+        if (d.truncated)
+            stats_.truncated++;
+        n++;
+    }
+
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return n;
+}
+
+void UringRx::recycle()
+{
+    auto* br = static_cast<io_uring_buf_ring*>(br_);
+    const uint32_t mask = buf_count_ - 1;
+
+    for (uint32_t i = 0; i < pending_n_; ++i)
+    {
+        uint16_t bid = pending_[i];
+        io_uring_buf* b = ringBuf(br_, br_tail_ & mask);
+        b->addr = reinterpret_cast<uint64_t>(bufs_ + static_cast<size_t>(bid) * buf_size_);
+        b->len  = buf_size_;
+        b->bid  = bid;
+        br_tail_++;
+    }
+
+    // One release store publishes the whole batch
+    __atomic_store_n(&br->tail, br_tail_, __ATOMIC_RELEASE);
+    pending_n_ = 0;
+}
+
+#else  // !HV_HAVE_IO_URING
+
+bool UringRx::available() { return false; }
+
+UringRx::~UringRx() = default;
+
+bool UringRx::open(int, const UringRxConfig&)
+{
+    std::fprintf(stderr, "io_uring ingress not compiled in (HV_WITH_IO_URING=OFF)\n");
+    return false;
+}
+
+void   UringRx::close() {}
+size_t UringRx::wait(Datagram*, size_t, int) { return 0; }
+void   UringRx::recycle() {}
+bool   UringRx::arm() { return false; }
+int    UringRx::enter(uint32_t, uint32_t, int) { return -1; }
+
+#endif // HV_HAVE_IO_URING
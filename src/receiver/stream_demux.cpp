@@ -0,0 +1,284 @@
+/*=====================================================================================*/
+/*                     HyperVision AGX Stream Demultiplexer                            */
+/*-------------------------------------------------------------------------------------*/
+
+
+#include <arpa/inet.h>
+#include <cstdio>
+
+#include "receiver/stream_demux.hpp"
+
+#include "common/frame_reassembler_manager.hpp"
+
+#include "debug/debug_stats.hpp"
+#include "debug/hv_debug.hpp"
+
+
+StreamDemux::StreamDemux(StreamKeyMode mode,
+                         size_t max_streams,
+                         size_t max_frame_size,
+                         size_t payload_stride,
+                         size_t frame_buffers)
+    : mode_(mode),
+      max_streams_(mode == StreamKeyMode::SINGLE ? 1 : max_streams),
+      max_frame_size_(max_frame_size),
+      payload_stride_(payload_stride),
+      frame_buffers_(frame_buffers)
+{
+}
+
+StreamDemux::~StreamDemux() = default;
+
+void StreamDemux::configure(uint64_t key, const StreamConfig& cfg)
+{
+    configured_[key] = cfg;
+}
+
+
+/*-------------------------------------------*/
+/* Stream lookup / creation                  */
+/*-------------------------------------------*/
+StreamDemux::Stream* StreamDemux::lookup(uint64_t key)
+{
+    if (last_ && key == last_key_)
+        return last_;
+
+    auto it = streams_.find(key);
+    Stream* s = (it != streams_.end()) ? it->second.get() : nullptr;
+
+    if (!s)
+    {
+        if (streams_.size() >= max_streams_)
+        {
+            hv::stats::add(hv::stats::STREAM_REJECTS);
+            HV_LOGW_RL(hv::debug::Module::RX, 1, 1, "[DMUX] stream limit %zu reached, key=%llx dropped",
+                       max_streams_, static_cast<unsigned long long>(key));
+            return nullptr;
+        }
+
+        uint32_t id = (mode_ == StreamKeyMode::SOURCE) ? next_index_++
+                                                       : static_cast<uint32_t>(key);
+        s = create(key, id);
+    }
+
+    last_key_ = key;
+    last_     = s;
+    return s;
+}
+
+StreamDemux::Stream* StreamDemux::create(uint64_t key, uint32_t id)
+{
+    auto s = std::make_unique<Stream>();
+    s->id = id;
+
+    auto c = configured_.find(key);
+    if (c != configured_.end())
+        s->cfg = c->second;
+
+    if (s->cfg.name.empty())
+    {
+        if (mode_ == StreamKeyMode::SOURCE)
+        {
+            char ip[INET_ADDRSTRLEN] = {0,};
+            uint32_t addr = static_cast<uint32_t>(key >> 16);
+            inet_ntop(AF_INET, &addr, ip, sizeof(ip));
+            s->cfg.name = std::string(ip) + ":" + std::to_string(ntohs(static_cast<uint16_t>(key)));
+        }
+        else
+        {
+            s->cfg.name = "s" + std::to_string(id);
+        }
+    }
+
+    size_t frame_size = s->cfg.max_frame_size ? s->cfg.max_frame_size : max_frame_size_;
+    size_t stride     = s->cfg.payload_stride ? s->cfg.payload_stride : payload_stride_;
+
+    size_t buffers    = s->cfg.frame_buffers ? s->cfg.frame_buffers : frame_buffers_;
+
+    s->manager = std::make_unique<FrameReassemblerManager>(frame_size, stride, buffers);
+    s->manager->setStreamId(id);
+    applySettings(*s);
+
+    uint32_t band_rows = s->cfg.band_rows ? s->cfg.band_rows : band_rows_;
+    if (band_rows && onFrameBand)
+    {
+        s->manager->setBandRows(band_rows);
+        s->manager->onFrameBand = [this](const FrameBand& b) { onFrameBand(b); };
+    }
+
+    Stream* raw = s.get();
+    s->manager->onFrameDone = [this, raw](const FrameResult& r)
+    {
+        if (r.state == FrameState::PARTIAL)
+            raw->partial.fetch_add(1, std::memory_order_relaxed);
+        else
+            raw->complete.fetch_add(1, std::memory_order_relaxed);
+
+        if (raw->cfg.sink)
+            raw->cfg.sink(r);
+        else if (onFrameDone)
+            onFrameDone(r);
+    };
+
+    if (mode_ != StreamKeyMode::SINGLE)
+        HV_LOGI(hv::debug::Module::RX, "[DMUX] new stream id=%u %s frame<=%zu B",
+                id, s->cfg.name.c_str(), frame_size);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    streams_.emplace(key, std::move(s));
+    return raw;
+}
+
+void StreamDemux::applySettings(Stream& s)
+{
+    s.manager->setTimeoutConfig(timeouts_);
+    s.manager->setTimeouts(
+        std::chrono::milliseconds(s.cfg.idle_timeout_ms ? s.cfg.idle_timeout_ms : idle_ms_),
+        std::chrono::milliseconds(s.cfg.lifetime_ms ? s.cfg.lifetime_ms : lifetime_ms_));
+    updateDeadlines(s);
+}
+
+void StreamDemux::reconfigure(size_t max_frame_size,
+                              size_t payload_stride,
+                              size_t frame_buffers,
+                              uint32_t idle_ms,
+                              uint32_t lifetime_ms,
+                              const TimeoutConfig& timeouts)
+{
+    max_frame_size_ = max_frame_size;
+    payload_stride_ = payload_stride;
+    frame_buffers_  = frame_buffers;
+    idle_ms_        = idle_ms;
+    lifetime_ms_    = lifetime_ms;
+    timeouts_       = timeouts;
+
+    for (auto& kv : streams_)
+    {
+        Stream& s = *kv.second;
+        s.manager->reconfigure(s.cfg.max_frame_size ? s.cfg.max_frame_size : max_frame_size_,
+                               s.cfg.payload_stride ? s.cfg.payload_stride : payload_stride_,
+                               s.cfg.frame_buffers ? s.cfg.frame_buffers : frame_buffers_);
+        applySettings(s);
+    }
+}
+
+void StreamDemux::updateInFlight(Stream& s)
+{
+    size_t now  = s.manager->inFlight();
+    size_t prev = static_cast<size_t>(s.in_flight.load(std::memory_order_relaxed));
+    if (now == prev)
+        return;
+
+    s.in_flight.store(now, std::memory_order_relaxed);
+    in_flight_total_ = in_flight_total_ + now - prev;
+
+    // Managers publish their own count; the gauge is the sum over streams
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(in_flight_total_));
+}
+
+void StreamDemux::updateDeadlines(Stream& s)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    s.idle_us.store(static_cast<uint64_t>(
+        duration_cast<microseconds>(s.manager->idleDeadline()).count()), std::memory_order_relaxed);
+    s.lifetime_us.store(static_cast<uint64_t>(
+        duration_cast<microseconds>(s.manager->lifetimeDeadline()).count()), std::memory_order_relaxed);
+}
+
+
+/*-------------------------------------------*/
+/* Packet / timer dispatch                   */
+/*-------------------------------------------*/
+void StreamDemux::pushPacket(const UdpPacketHeader& hdr,
+                             const uint8_t* payload,
+                             uint32_t src_ip,
+                             uint16_t src_port,
+                             bool gap_before,
+                             size_t queue_drop_count,
+                             uint32_t kernel_drops)
+{
+    uint64_t key = 0;
+    if (mode_ == StreamKeyMode::STREAM_ID)
+        key = hdr.stream_id;
+    else if (mode_ == StreamKeyMode::SOURCE)
+        key = sourceKey(src_ip, src_port);
+
+    Stream* s = lookup(key);
+    if (!s)
+        return;
+
+    s->packets.store(s->packets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    s->bytes.store(s->bytes.load(std::memory_order_relaxed) + hdr.payload_size,
+                   std::memory_order_relaxed);
+
+    s->manager->pushPacket(hdr, payload, gap_before, queue_drop_count, kernel_drops);
+    updateInFlight(*s);
+}
+
+void StreamDemux::pollTimers(size_t queue_drop_now)
+{
+    for (auto& kv : streams_)
+    {
+        kv.second->manager->pollTimers(queue_drop_now);
+        updateInFlight(*kv.second);
+        updateDeadlines(*kv.second);
+    }
+
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(in_flight_total_));
+}
+
+void StreamDemux::flushAll()
+{
+    for (auto& kv : streams_)
+    {
+        kv.second->manager->flushAll();
+        updateInFlight(*kv.second);
+    }
+
+    hv::stats::set(hv::stats::FRAMES_IN_FLIGHT, static_cast<int64_t>(in_flight_total_));
+
+    if (mode_ == StreamKeyMode::SINGLE)
+        return;
+
+    for (const StreamStatsSnapshot& s : snapshot())
+        HV_LOGI(hv::debug::Module::RX, "[DMUX] stream %u %s pkts=%llu complete=%llu partial=%llu idle=%.1fms",
+                s.id, s.name.c_str(),
+                static_cast<unsigned long long>(s.packets),
+                static_cast<unsigned long long>(s.frames_complete),
+                static_cast<unsigned long long>(s.frames_partial),
+                s.idle_timeout_us / 1e3);
+}
+
+
+/*-------------------------------------------*/
+/* Stats (any thread)                        */
+/*-------------------------------------------*/
+size_t StreamDemux::streamCount() const
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return streams_.size();
+}
+
+std::vector<StreamStatsSnapshot> StreamDemux::snapshot() const
+{
+    std::vector<StreamStatsSnapshot> out;
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    out.reserve(streams_.size());
+    for (const auto& kv : streams_)
+    {
+        const Stream& s = *kv.second;
+        out.push_back(StreamStatsSnapshot{
+            s.id, s.cfg.name,
+            s.packets.load(std::memory_order_relaxed),
+            s.bytes.load(std::memory_order_relaxed),
+            s.complete.load(std::memory_order_relaxed),
+            s.partial.load(std::memory_order_relaxed),
+            s.in_flight.load(std::memory_order_relaxed),
+            s.idle_us.load(std::memory_order_relaxed),
+            s.lifetime_us.load(std::memory_order_relaxed)});
+    }
+    return out;
+}
@@ -0,0 +1,142 @@
+/*=====================================================================================*/
+/*                     tm_unpack : compressed frame recording => frames                */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Usage: tm_unpack <file.hvr> [--raw out.bin] [--frames prefix] [--quiet]            */
+/*                                                                                     */
+/*  Lists every recorded frame (id, state, packets, ratio, damaged chunks) and         */
+/*  optionally decodes them:                                                           */
+/*   --raw      payloads of all frames appended to one file (FrameHeader and           */
+/*              FrameTrailer stripped, as <prefix>_*_raw.bin)                          */
+/*   --frames   per-frame files via write_frame_to_file(<prefix>_<frame_id>)           */
+/*  Partial frames decode with their missing packets zero-filled.                      */
+/*=====================================================================================*/
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/frame_recorder.hpp"
+#include "common/frame_writer.hpp"
+#include "protocol/protocol_constants.hpp"
+
+namespace {
+
+// Payload span of a decoded frame, as write_frame_to_file() cuts it
+size_t payloadSize(const std::vector<uint8_t>& f)
+{
+    if (f.size() < sizeof(FrameHeader))
+        return 0;
+
+    size_t n = f.size() - sizeof(FrameHeader);
+    FrameHeader hdr;
+    std::memcpy(&hdr, f.data(), sizeof(hdr));
+    if (hdr.magic == protocol::FRAME_MAGIC && hdr.frame_size < n)
+        n = hdr.frame_size;
+    return n;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: tm_unpack <file.hvr> [--raw out.bin] [--frames prefix] [--quiet]\n";
+        return -1;
+    }
+
+    std::string path = argv[1];
+    std::string raw_path;
+    std::string frames_prefix;
+    bool        quiet = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--raw" && i + 1 < argc)
+            raw_path = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc)
+            frames_prefix = argv[++i];
+        else if (arg == "--quiet")
+            quiet = true;
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return -1;
+        }
+    }
+
+    FrameRecordReader reader;
+    if (!reader.open(path))
+        return -1;
+
+    FILE* raw_fp = nullptr;
+    if (!raw_path.empty())
+    {
+        raw_fp = std::fopen(raw_path.c_str(), "wb");
+        if (!raw_fp)
+        {
+            perror("fopen(--raw)");
+            return -1;
+        }
+    }
+
+    HvrFrameRecord       rec{};
+    std::vector<uint8_t> frame;
+    uint32_t             bad = 0;
+
+    uint64_t frames = 0, partial = 0, damaged = 0;
+    uint64_t raw_bytes = 0, stored_bytes = 0;
+
+    while (reader.next(rec, frame, &bad))
+    {
+        frames++;
+        raw_bytes    += rec.raw_size;
+        stored_bytes += sizeof(rec) + rec.chunk_count * sizeof(HvrChunk) + rec.data_size;
+        if (rec.flags & HVR_FLAG_PARTIAL)
+            partial++;
+        if (bad)
+            damaged++;
+
+        if (!quiet)
+        {
+            std::printf("frame=%-6u stream=%u %s%s%s pkts=%u/%u size=%llu ratio=%.2f codec=%s chunks=%u",
+                        rec.frame_id, rec.stream_id,
+                        (rec.flags & HVR_FLAG_PARTIAL) ? "PARTIAL" : "COMPLETE",
+                        (rec.flags & HVR_FLAG_CORRUPTED) ? " corrupted" : "",
+                        (rec.flags & HVR_FLAG_VERIFIED) ? " verified" : "",
+                        rec.received_packets, rec.expected_packets,
+                        static_cast<unsigned long long>(rec.raw_size),
+                        rec.data_size ? static_cast<double>(rec.raw_size) / rec.data_size : 0.0,
+                        frameCodecName(static_cast<FrameCodec>(rec.codec)), rec.chunk_count);
+            if (bad)
+                std::printf(" bad_chunks=%u", bad);
+            std::printf("\n");
+        }
+
+        if (raw_fp && frame.size() >= sizeof(FrameHeader))
+            std::fwrite(frame.data() + sizeof(FrameHeader), 1, payloadSize(frame), raw_fp);
+
+        if (!frames_prefix.empty() && frame.size() >= sizeof(FrameHeader))
+        {
+            std::string prefix = frames_prefix + "_" + std::to_string(rec.frame_id);
+            write_frame_to_file(frame.data(), frame.size(),
+                                (rec.flags & HVR_FLAG_PARTIAL) != 0, prefix.c_str());
+        }
+    }
+
+    if (raw_fp)
+        std::fclose(raw_fp);
+
+    std::fprintf(stderr, "%llu frames (%llu partial, %llu with damaged chunks), raw=%.1f MB file=%.1f MB ratio=%.2f\n",
+                 static_cast<unsigned long long>(frames),
+                 static_cast<unsigned long long>(partial),
+                 static_cast<unsigned long long>(damaged),
+                 raw_bytes / 1e6, stored_bytes / 1e6,
+                 stored_bytes ? static_cast<double>(raw_bytes) / stored_bytes : 0.0);
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*=====================================================================================*/
+/*                     tm_replay : pcap capture replayer                               */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Usage: tm_replay <capture.pcap> <ip> <port>                                        */
+/*                   [--speed X | --max-rate] [--loop N] [--batch N]                   */
+/*                                                                                     */
+/*  Replays the UDP payloads of a capture (tm_receiver --capture, or any pcap with     */
+/*  LINKTYPE_RAW / Ethernet IPv4 UDP) with the original inter-packet timing, scaled    */
+/*  by --speed, or as fast as possible.  Datagrams that are due together go out in     */
+/*  one sendmmsg() batch.                                                              */
+/*=====================================================================================*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/pcap_format.hpp"
+
+namespace {
+
+struct ReplayPacket
+{
+    uint64_t       ts_ns;
+    const uint8_t* data;
+    uint32_t       len;
+};
+
+uint64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+/* UDP payload of one captured IPv4 datagram; false if not IPv4/UDP */
+bool udpPayload(const uint8_t* p, uint32_t len, const uint8_t*& out, uint32_t& out_len)
+{
+    if (len < pcap::IPV4_HDR_LEN || (p[0] >> 4) != 4 || p[9] != 17)
+        return false;
+
+    uint32_t ihl = (p[0] & 0x0F) * 4u;
+    if (len < ihl + pcap::UDP_HDR_LEN)
+        return false;
+
+    const uint8_t* udp = p + ihl;
+    uint32_t udp_len = (static_cast<uint32_t>(udp[4]) << 8) | udp[5];
+    if (udp_len < pcap::UDP_HDR_LEN || ihl + udp_len > len)
+        udp_len = len - ihl;            // snapped record: use what we have
+
+    out     = udp + pcap::UDP_HDR_LEN;
+    out_len = udp_len - pcap::UDP_HDR_LEN;
+    return true;
+}
+
+bool loadCapture(const std::string& path,
+                 std::vector<uint8_t>& file,
+                 std::vector<ReplayPacket>& pkts)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "cannot open " << path << "\n";
+        return false;
+    }
+    file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    if (file.size() < sizeof(pcap::FileHeader))
+    {
+        std::cerr << "not a pcap file: " << path << "\n";
+        return false;
+    }
+
+    pcap::FileHeader fh;
+    std::memcpy(&fh, file.data(), sizeof(fh));
+
+    uint64_t frac_ns;
+    if (fh.magic == pcap::MAGIC_NSEC)
+        frac_ns = 1;
+    else if (fh.magic == pcap::MAGIC_USEC)
+        frac_ns = 1000;
+    else
+    {
+        std::cerr << "unsupported pcap magic 0x" << std::hex << fh.magic
+                  << std::dec << " (byte-swapped or pcapng?)\n";
+        return false;
+    }
+
+    uint32_t link_skip;
+    if (fh.linktype == pcap::LINKTYPE_RAW)
+        link_skip = 0;
+    else if (fh.linktype == pcap::LINKTYPE_ETHERNET)
+        link_skip = pcap::ETH_HDR_LEN;
+    else
+    {
+        std::cerr << "unsupported linktype " << fh.linktype << "\n";
+        return false;
+    }
+
+    size_t off = sizeof(fh);
+    size_t skipped = 0;
+
+    while (off + sizeof(pcap::RecordHeader) <= file.size())
+    {
+        pcap::RecordHeader rh;
+        std::memcpy(&rh, file.data() + off, sizeof(rh));
+        off += sizeof(rh);
+
+        if (off + rh.incl_len > file.size())
+            break;      // truncated tail (capture still being written)
+
+        const uint8_t* rec = file.data() + off;
+        off += rh.incl_len;
+
+        // Ethernet: IPv4 only, no VLAN
+        if (link_skip && (rh.incl_len < link_skip || rec[12] != 0x08 || rec[13] != 0x00))
+        {
+            skipped++;
+            continue;
+        }
+
+        ReplayPacket p;
+        if (!udpPayload(rec + link_skip, rh.incl_len - link_skip, p.data, p.len))
+        {
+            skipped++;
+            continue;
+        }
+        p.ts_ns = static_cast<uint64_t>(rh.ts_sec) * 1000000000ull + rh.ts_frac * frac_ns;
+        pkts.push_back(p);
+    }
+
+    if (skipped)
+        std::cerr << "[REPLAY] skipped " << skipped << " non-UDP/IPv4 records\n";
+
+    return !pkts.empty();
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: tm_replay <capture.pcap> <ip> <port>"
+                     " [--speed X | --max-rate] [--loop N] [--batch N]\n";
+        return -1;
+    }
+
+    std::string path = argv[1];
+    std::string ip   = argv[2];
+    int port         = std::stoi(argv[3]);
+
+    double   speed    = 1.0;
+    bool     max_rate = false;
+    uint32_t loops    = 1;
+    uint32_t batch    = 32;
+
+    for (int i = 4; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--speed" && i + 1 < argc)
+            speed = std::stod(argv[++i]);
+        else if (arg == "--max-rate")
+            max_rate = true;
+        else if (arg == "--loop" && i + 1 < argc)
+            loops = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--batch" && i + 1 < argc)
+            batch = std::max(1u, std::min(1024u, static_cast<uint32_t>(std::stoul(argv[++i]))));
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return -1;
+        }
+    }
+
+    if (speed <= 0.0)
+    {
+        std::cerr << "--speed must be > 0\n";
+        return -1;
+    }
+
+    std::vector<uint8_t>      file;
+    std::vector<ReplayPacket> pkts;
+    if (!loadCapture(path, file, pkts))
+        return -1;
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+
+    int sndbuf = 4 * 1024 * 1024;
+    if (setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) < 0)
+        perror("setsockopt(SO_SNDBUF)");
+
+    sockaddr_in dst{};
+    dst.sin_family = AF_INET;
+    dst.sin_port   = htons(port);
+    if (inet_pton(AF_INET, ip.c_str(), &dst.sin_addr) != 1)
+    {
+        std::cerr << "invalid address: " << ip << "\n";
+        close(sock);
+        return -1;
+    }
+
+    if (connect(sock, (sockaddr*)&dst, sizeof(dst)) < 0)
+    {
+        perror("connect");
+        close(sock);
+        return -1;
+    }
+
+    const uint64_t cap_span = pkts.back().ts_ns - pkts.front().ts_ns;
+    std::printf("[REPLAY] %zu packets, capture span %.3fs, mode=%s\n",
+                pkts.size(), cap_span / 1e9,
+                max_rate ? "max-rate" : (speed == 1.0 ? "original" : "scaled"));
+
+    std::vector<mmsghdr> msgs(batch);
+    std::vector<iovec>   iovs(batch);
+
+    uint64_t sent = 0, bytes = 0, errors = 0, batches = 0;
+    uint64_t late_max = 0, late_n = 0;
+    double   late_sum = 0.0;
+
+    const uint64_t t_start = nowNs();
+
+    for (uint32_t loop = 0; loop < loops; ++loop)
+    {
+        const uint64_t base_cap  = pkts.front().ts_ns;
+        const uint64_t base_wall = nowNs();
+
+        auto due = [&](size_t idx) {
+            return base_wall + static_cast<uint64_t>((pkts[idx].ts_ns - base_cap) / speed);
+        };
+
+        size_t i = 0;
+        while (i < pkts.size())
+        {
+            uint64_t now = nowNs();
+
+            if (!max_rate)
+            {
+                uint64_t d = due(i);
+                if (now < d)
+                {
+                    if (d - now > 200000)
+                        std::this_thread::sleep_for(std::chrono::nanoseconds(d - now - 100000));
+                    continue;       // short waits: spin on the clock
+                }
+
+                uint64_t late = now - d;
+                late_max  = std::max(late_max, late);
+                late_sum += static_cast<double>(late);
+                late_n++;
+            }
+
+            // Everything already due (or up to batch in max-rate mode)
+            uint32_t k = 0;
+            while (k < batch && i + k < pkts.size()
+                   && (max_rate || due(i + k) <= now))
+            {
+                const ReplayPacket& p = pkts[i + k];
+                iovs[k].iov_base = const_cast<uint8_t*>(p.data);
+                iovs[k].iov_len  = p.len;
+
+                msgs[k] = mmsghdr{};
+                msgs[k].msg_hdr.msg_iov    = &iovs[k];
+                msgs[k].msg_hdr.msg_iovlen = 1;
+                ++k;
+            }
+
+            int ret = sendmmsg(sock, msgs.data(), k, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno == ENOBUFS || errno == EAGAIN)
+                {
+                    errors++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                perror("sendmmsg");
+                close(sock);
+                return -1;
+            }
+
+            for (int m = 0; m < ret; ++m)
+                bytes += pkts[i + m].len;
+
+            sent += static_cast<uint64_t>(ret);
+            i    += static_cast<size_t>(ret);
+            batches++;
+        }
+    }
+
+    double elapsed = (nowNs() - t_start) / 1e9;
+
+    std::printf("[REPLAY] sent=%" PRIu64 " bytes=%" PRIu64 " batches=%" PRIu64
+                " (avg %.1f/batch) retries=%" PRIu64 "\n",
+                sent, bytes, batches, batches ? static_cast<double>(sent) / batches : 0.0, errors);
+    std::printf("[REPLAY] elapsed=%.3fs rate=%.0f pps %.1f Mbit/s\n",
+                elapsed, sent / elapsed, bytes * 8 / elapsed / 1e6);
+    if (late_n)
+        std::printf("[REPLAY] batch lateness avg=%.1fus max=%.1fus\n",
+                    late_sum / late_n / 1e3, late_max / 1e3);
+
+    close(sock);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "sender/ccsds_stub_encoder.hpp"
 #include "protocol/frame_header.hpp"
 #include "protocol/protocol_constants.hpp"
+#include "common/frame_digest.hpp"
 #include <cstring>
 
 std::vector<uint8_t>
@@ -15,13 +16,23 @@ CcsdsStubEncoder::encode(const std::vector<uint8_t>& raw,
     hdr.width = width;
     hdr.height = height;
     hdr.bitdepth = bitdepth;
+    hdr.flags = protocol::FRAME_FLAG_DIGEST;
     hdr.frame_size = raw.size();
 
-    std::vector<uint8_t> out(sizeof(FrameHeader) + raw.size());
+    const size_t covered = sizeof(FrameHeader) + raw.size();
+
+    std::vector<uint8_t> out(covered + sizeof(FrameTrailer));
     std::memcpy(out.data(), &hdr, sizeof(FrameHeader));
     std::memcpy(out.data() + sizeof(FrameHeader),
                 raw.data(),
                 raw.size());
 
+    // End-to-end digest over header + payload
+    FrameTrailer tr{};
+    tr.magic = protocol::TRAILER_MAGIC;
+    tr.chunk_size = protocol::DIGEST_CHUNK_SIZE;
+    tr.digest = frame_digest_compute(out.data(), covered);
+    std::memcpy(out.data() + covered, &tr, sizeof(FrameTrailer));
+
     return out;
 }
@@ -2,17 +2,54 @@
 #include "sender/ccsds_stub_encoder.hpp"
 #include "sender/udp_sender.hpp"
 #include "protocol/frame_header.hpp"
+#include "protocol/udp_packet.hpp"
 #include <iostream>
 #include <fstream>
+#include <string>
 
 int main(int argc, char* argv[])
 {
     if (argc < 3) {
-        std::cout << "Usage: sender <ip> <port> [raw_file_path]\n";
+        std::cout << "Usage: sender <ip> <port> [raw_file_path]\n"
+                     "              [--stride N] [--stream N] [--v1]\n";
         return -1;
     }
 
-    const char* raw_path = (argc >= 4) ? argv[3] : "test_data/raw/gradient_1920x1080.raw";
+    const char* raw_path = "test_data/raw/gradient_1920x1080.raw";
+    uint32_t stride    = protocol::MAX_UDP_PAYLOAD;
+    uint16_t stream_id = 0;
+    uint8_t  version   = protocol::PACKET_VERSION_V2;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--stride" && i + 1 < argc)
+        {
+            stride = static_cast<uint32_t>(std::stoul(argv[++i]));
+            if (stride == 0 || stride > protocol::MAX_PAYLOAD_STRIDE)
+            {
+                std::cerr << "--stride must be 1.." << protocol::MAX_PAYLOAD_STRIDE << "\n";
+                return -1;
+            }
+        }
+        else if (arg == "--stream" && i + 1 < argc)
+        {
+            stream_id = static_cast<uint16_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--v1")
+        {
+            version = 1;
+        }
+        else if (arg.rfind("--", 0) != 0)
+        {
+            raw_path = argv[i];
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return -1;
+        }
+    }
 
     // quick existence check with clearer error
     std::ifstream check(raw_path, std::ios::binary);
@@ -24,7 +61,7 @@ int main(int argc, char* argv[])
 
     FileSource src(raw_path);
     CcsdsStubEncoder encoder;
-    UdpSender sender(argv[1], std::stoi(argv[2]));
+    UdpSender sender(argv[1], std::stoi(argv[2]), stride, stream_id, version);
 
     std::vector<uint8_t> raw;
     if (!src.getNextFrame(raw))
@@ -8,11 +8,22 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
+#include <time.h>
 
 
-UdpSender::UdpSender(const std::string& ip, uint16_t port)
-    : frame_id_(0)
+UdpSender::UdpSender(const std::string& ip, uint16_t port,
+                     uint32_t stride, uint16_t stream_id, uint8_t version)
+    : frame_id_(0),
+      stride_(stride),
+      stream_id_(stream_id),
+      version_(version)
 {
+    // v1 receivers place packets at a fixed MAX_UDP_PAYLOAD stride
+    if (version_ != protocol::PACKET_VERSION_V2)
+        stride_ = protocol::MAX_UDP_PAYLOAD;
+    if (stride_ == 0 || stride_ > protocol::MAX_PAYLOAD_STRIDE)
+        stride_ = protocol::MAX_UDP_PAYLOAD;
+
     sock_ = socket(AF_INET, SOCK_DGRAM, 0);
 
      //Holoscan-style: non-blocking I/O
@@ -57,18 +68,28 @@ void UdpSender::sendFrame(const std::vector<uint8_t>& frame)
 {
     frame_id_++;
 
-    const size_t max_payload =
-        protocol::MAX_UDP_PAYLOAD;
+    const size_t max_payload = stride_;
 
-    uint16_t packet_count =
+    uint32_t packet_count =
         (frame.size() + max_payload - 1) / max_payload;
 
+    // v1 carries 16-bit packet ids
+    if (version_ != protocol::PACKET_VERSION_V2 && packet_count > 0xFFFF)
+    {
+        std::cout << "[TX] frame too large for v1: packets=" << packet_count << "\n";
+        return;
+    }
+
     std::cout << "[TX] start frame frame_id=" << frame_id_
-              << " packets=" << packet_count << "\n";
+              << " packets=" << packet_count
+              << " v" << static_cast<int>(version_)
+              << " stride=" << stride_ << "\n";
+
+    std::vector<uint8_t> buffer(sizeof(UdpPacketHeaderV2) + max_payload);
 
-    for (uint16_t pid = 0; pid < packet_count; pid++) 
+    for (uint32_t pid = 0; pid < packet_count; pid++) 
     {
-        size_t offset = pid * max_payload;
+        size_t offset = static_cast<size_t>(pid) * max_payload;
         size_t size =
             std::min(max_payload, frame.size() - offset);
 
@@ -77,11 +98,31 @@ void UdpSender::sendFrame(const std::vector<uint8_t>& frame)
         hdr.packet_id = pid;
         hdr.packet_count = packet_count;
         hdr.payload_size = size;
+        hdr.stream_id = stream_id_;
+        hdr.payload_stride = static_cast<uint16_t>(stride_);
+        hdr.flags = (pid == packet_count - 1) ? protocol::PKT_FLAG_LAST : 0;
 
-        
-        uint8_t buffer[sizeof(hdr) + max_payload];
-        std::memcpy(buffer, &hdr, sizeof(hdr));
-        std::memcpy(buffer + sizeof(hdr),
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        hdr.send_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+
+        size_t hdr_len;
+        if (version_ == protocol::PACKET_VERSION_V2)
+        {
+            hdr_len = encode_packet_header_v2(hdr, buffer.data());
+        }
+        else
+        {
+            UdpPacketHeaderV1 v1{};
+            v1.frame_id     = hdr.frame_id;
+            v1.packet_id    = static_cast<uint16_t>(pid);
+            v1.packet_count = static_cast<uint16_t>(packet_count);
+            v1.payload_size = hdr.payload_size;
+            std::memcpy(buffer.data(), &v1, sizeof(v1));
+            hdr_len = sizeof(v1);
+        }
+
+        std::memcpy(buffer.data() + hdr_len,
                     frame.data() + offset,
                     size);
 
@@ -102,8 +143,8 @@ void UdpSender::sendFrame(const std::vector<uint8_t>& frame)
         }
                    
         ssize_t ret = sendto(sock_,
-                            buffer,
-                            sizeof(hdr) + size,
+                            buffer.data(),
+                            hdr_len + size,
                             0,
                             (struct sockaddr*)&addr_,
                             sizeof(addr_));
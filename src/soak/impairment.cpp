@@ -0,0 +1,128 @@
+/*---------------------------------------------------------------------------*/
+/*                                                                           */
+/*                            impairment.cpp                                 */
+/*                                                                           */
+/*  In-process network impairment (netem stand-in, no root needed)           */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+
+#include "soak/impairment.hpp"
+
+Impairment::Impairment(const ImpairmentConfig& cfg)
+    : cfg_(cfg),
+      rng_(cfg.seed)
+{
+}
+
+void Impairment::submit(const uint8_t* data, size_t len, uint64_t now_ns)
+{
+    stats_.submitted++;
+
+    // Reorder: release held packets whose gap has elapsed, before this one
+    while (!held_.empty() && held_.front().release <= stats_.submitted)
+    {
+        Held h = std::move(held_.front());
+        held_.pop_front();
+        toDelay(h.data.data(), h.data.size(), now_ns);
+    }
+
+    // Burst loss state transition (one step per packet)
+    if (cfg_.burst_enter > 0.0)
+    {
+        if (burst_bad_)
+        {
+            if (chance(cfg_.burst_exit))
+                burst_bad_ = false;
+        }
+        else if (chance(cfg_.burst_enter))
+        {
+            burst_bad_ = true;
+        }
+
+        if (burst_bad_ && chance(cfg_.burst_loss))
+        {
+            stats_.lost_burst++;
+            return;
+        }
+    }
+
+    if (chance(cfg_.loss))
+    {
+        stats_.lost++;
+        return;
+    }
+
+    afterLoss(data, len, now_ns);
+
+    if (chance(cfg_.duplicate))
+    {
+        stats_.duplicated++;
+        afterLoss(data, len, now_ns);
+    }
+}
+
+void Impairment::afterLoss(const uint8_t* data, size_t len, uint64_t now_ns)
+{
+    if (chance(cfg_.reorder))
+    {
+        stats_.reordered++;
+
+        // Gap is constant, so the deque stays sorted by release count
+        Held h;
+        h.release = stats_.submitted + cfg_.reorder_gap;
+        h.seq     = seq_++;
+        h.data.assign(data, data + len);
+        held_.push_back(std::move(h));
+        return;
+    }
+
+    toDelay(data, len, now_ns);
+}
+
+void Impairment::toDelay(const uint8_t* data, size_t len, uint64_t now_ns)
+{
+    if (cfg_.delay_us == 0 && cfg_.jitter_us == 0)
+    {
+        stats_.emitted++;
+        if (emit)
+            emit(data, len);
+        return;
+    }
+
+    uint64_t d = static_cast<uint64_t>(cfg_.delay_us) * 1000;
+    if (cfg_.jitter_us)
+        d += static_cast<uint64_t>(uni_(rng_) * cfg_.jitter_us * 1000.0);
+
+    stats_.delayed++;
+
+    Held h;
+    h.release = now_ns + d;
+    h.seq     = seq_++;
+    h.data.assign(data, data + len);
+    delay_line_.push(std::move(h));
+}
+
+void Impairment::poll(uint64_t now_ns)
+{
+    while (!delay_line_.empty() && delay_line_.top().release <= now_ns)
+    {
+        // priority_queue::top() is const; the element is dropped right after
+        const Held& h = delay_line_.top();
+        stats_.emitted++;
+        if (emit)
+            emit(h.data.data(), h.data.size());
+        delay_line_.pop();
+    }
+}
+
+void Impairment::drain()
+{
+    while (!held_.empty())
+    {
+        Held h = std::move(held_.front());
+        held_.pop_front();
+        toDelay(h.data.data(), h.data.size(), 0);
+    }
+
+    poll(UINT64_MAX);
+}
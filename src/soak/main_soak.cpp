@@ -0,0 +1,783 @@
+/*=====================================================================================*/
+/*                     tm_soak : loopback load generator / soak harness                */
+/*-------------------------------------------------------------------------------------*/
+/*                                                                                     */
+/*  Drives the real receive pipeline (RxPipeline) over 127.0.0.1 at a paced packet     */
+/*  rate, with in-process impairment (loss, burst loss, reorder, duplicate, delay)     */
+/*  between the generator and the socket.  No root or tc/netem needed.                 */
+/*                                                                                     */
+/*  Usage: tm_soak [--pps N] [--duration sec] [--width W --height H] [--streams N]     */
+/*                 [--loss p] [--burst enter[:exit[:loss]]] [--dup p]                  */
+/*                 [--reorder p[:gap]] [--delay us[:jitter_us]] [--seed N]             */
+/*                 [--queue N] [--report sec] [--min-complete pct] [--write] [-v]      */
+/*                 [--wait block|spin|busy] [--spin-us N] [--busy-poll-us N]           */
+/*                 [--ingress socket|rtc|ring|uring] [--stride N] [--v1]               */
+/*                 [--demux none|id|source] [--band-rows N]                            */
+/*                 [--consumer-us N[:policy[:depth]]] [--timeouts fixed|adaptive]      */
+/*                 [--shed tail|newest|every-nth[:N]]                                  */
+/*                 [--record file.hvr] [--compress none|lz4|zstd[:threads[:chunk_kb]]] */
+/*                 [--copy memcpy|nt|auto]                                             */
+/*                                                                                     */
+/*  Streams are interleaved packet by packet; stream s uses frame ids (s << 24) | n.   */
+/*=====================================================================================*/
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/frame_recorder.hpp"
+#include "common/frame_result.hpp"
+#include "common/frame_writer.hpp"
+
+#include "debug/debug_histogram.hpp"
+#include "debug/debug_stats.hpp"
+#include "debug/hv_debug.hpp"
+
+#include "protocol/protocol_constants.hpp"
+#include "protocol/udp_packet.hpp"
+
+#include "receiver/frame_pipeline.hpp"
+#include "receiver/rx_pipeline.hpp"
+
+#include "sender/ccsds_stub_encoder.hpp"
+
+#include "soak/impairment.hpp"
+
+namespace {
+
+struct SoakOptions
+{
+    uint64_t pps          = 100000;    // 0 => unpaced
+    double   duration_s   = 10.0;
+    uint16_t width        = 1920;
+    uint16_t height       = 1080;
+    uint32_t streams      = 1;
+    size_t   queue        = 4096 * 4;
+    double   report_s     = 1.0;
+    double   min_complete = 0.0;       // percent, 0 => no check
+    bool     write        = false;
+    bool     verbose      = false;
+
+    uint32_t stride       = protocol::MAX_UDP_PAYLOAD;
+    bool     v1           = false;     // legacy 12-byte header
+
+    hv::wait::Config wait;
+    RxIngress ingress     = RxIngress::SOCKET;
+    StreamKeyMode demux   = StreamKeyMode::SINGLE;
+    uint32_t band_rows    = 0;         // streaming delivery, 0 => off
+    uint32_t consumer_us  = 0;         // simulated slow consumer stage, 0 => none
+    StageConfig consumer;
+    bool     adaptive_timeouts = true;  // learned idle / lifetime deadlines
+    AdmissionConfig admission;          // frame-aware shedding ahead of the queue
+    hv::copy::Config copy;              // payload => frame buffer copy kernel
+    std::string record_path;            // compressed recording stage, empty => off
+    RecorderConfig record;
+    ImpairmentConfig imp;
+};
+
+constexpr uint32_t STREAM_SHIFT   = 24;
+constexpr uint32_t SEND_SLOTS     = 1024;          // per stream, frame send times
+
+/* One stream: encoded frame pre-split into datagrams (header + payload) */
+struct StreamSource
+{
+    std::vector<std::vector<uint8_t>> datagrams;
+    size_t   frame_bytes = 0;
+    uint32_t seq = 0;           // current frame number
+    size_t   next = 0;          // next packet index in the current frame
+
+    size_t   hdr_len = 0;       // v1 or v2 header in front of every datagram
+
+    void build(uint32_t stream, uint16_t w, uint16_t h, uint32_t stride, bool v1)
+    {
+        std::vector<uint8_t> raw(static_cast<size_t>(w) * h * 2);
+        for (size_t i = 0; i < raw.size(); ++i)
+            raw[i] = static_cast<uint8_t>(i * (7 + stream) + (i >> 11));
+
+        CcsdsStubEncoder enc;
+        std::vector<uint8_t> frame = enc.encode(raw, w, h, 12);
+        frame_bytes = frame.size();
+
+        size_t count = (frame.size() + stride - 1) / stride;
+        hdr_len = v1 ? sizeof(UdpPacketHeaderV1) : sizeof(UdpPacketHeaderV2);
+
+        datagrams.resize(count);
+        for (size_t pid = 0; pid < count; ++pid)
+        {
+            size_t off = pid * stride;
+            size_t n   = std::min<size_t>(stride, frame.size() - off);
+
+            std::vector<uint8_t>& d = datagrams[pid];
+            d.resize(hdr_len + n);
+
+            if (v1)
+            {
+                UdpPacketHeaderV1 hdr{};
+                hdr.packet_id    = static_cast<uint16_t>(pid);
+                hdr.packet_count = static_cast<uint16_t>(count);
+                hdr.payload_size = static_cast<uint32_t>(n);
+                std::memcpy(d.data(), &hdr, sizeof(hdr));
+            }
+            else
+            {
+                UdpPacketHeader hdr{};
+                hdr.packet_id      = static_cast<uint32_t>(pid);
+                hdr.packet_count   = static_cast<uint32_t>(count);
+                hdr.payload_size   = static_cast<uint32_t>(n);
+                hdr.stream_id      = static_cast<uint16_t>(stream);
+                hdr.payload_stride = static_cast<uint16_t>(stride);
+                hdr.flags          = (pid + 1 == count) ? protocol::PKT_FLAG_LAST : 0;
+                encode_packet_header_v2(hdr, d.data());
+            }
+            std::memcpy(d.data() + hdr_len, frame.data() + off, n);
+        }
+    }
+};
+
+/* Shared between the generator, the frame worker and the reporter */
+struct SoakState
+{
+    std::atomic<bool> tx_done{false};
+
+    std::atomic<uint64_t> tx_packets{0};
+    std::atomic<uint64_t> tx_frames{0};
+    std::atomic<uint64_t> tx_errors{0};
+
+    // Last packet of a frame handed to the impairment stage (CLOCK_MONOTONIC)
+    std::vector<std::atomic<uint64_t>> frame_sent_ns;
+
+    // Written by the frame worker only
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> complete{0};
+    std::atomic<uint64_t> partial{0};
+    std::atomic<uint64_t> verified{0};
+    std::atomic<uint64_t> mismatch{0};
+    std::atomic<uint64_t> good_bytes{0};
+    std::atomic<uint64_t> band_rows{0};     // rows delivered through onFrameBand
+
+    // Last packet sent => frame delivered to onFrameDone
+    std::mutex              e2e_mtx;
+    hv::stats::HistogramSnapshot e2e{};
+
+    explicit SoakState(uint32_t streams)
+        : frame_sent_ns(static_cast<size_t>(streams) * SEND_SLOTS)
+    {}
+
+    size_t slot(uint32_t frame_id) const
+    {
+        return (frame_id >> STREAM_SHIFT) * SEND_SLOTS + (frame_id & (SEND_SLOTS - 1));
+    }
+};
+
+bool parsePair(const char* s, double& a, double* b, double* c = nullptr)
+{
+    char* end = nullptr;
+    a = std::strtod(s, &end);
+    if (end == s)
+        return false;
+    if (*end == ':' && b)
+    {
+        s = end + 1;
+        *b = std::strtod(s, &end);
+        if (*end == ':' && c)
+            *c = std::strtod(end + 1, &end);
+    }
+    return *end == '\0';
+}
+
+void usage()
+{
+    std::cerr <<
+        "Usage: tm_soak [--pps N] [--duration sec] [--width W] [--height H] [--streams N]\n"
+        "               [--loss p] [--burst enter[:exit[:loss]]] [--dup p]\n"
+        "               [--reorder p[:gap]] [--delay us[:jitter_us]] [--seed N]\n"
+        "               [--queue N] [--report sec] [--min-complete pct] [--write] [-v]\n"
+        "               [--wait block|spin|busy] [--spin-us N] [--busy-poll-us N]\n"
+        "               [--ingress socket|rtc|ring|uring] [--stride N] [--v1]\n"
+        "               [--demux none|id|source] [--band-rows N]\n"
+        "               [--consumer-us N[:block|drop-oldest|drop-newest[:depth]]]\n"
+        "               [--timeouts fixed|adaptive] [--shed tail|newest|every-nth[:N]]\n"
+        "               [--record file.hvr] [--compress none|lz4|zstd[:threads[:chunk_kb]]]\n"
+        "               [--copy memcpy|nt|auto]\n";
+}
+
+bool parseArgs(int argc, char* argv[], SoakOptions& o)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool has_val = (i + 1 < argc);
+
+        if (arg == "--write")
+            o.write = true;
+        else if (arg == "--v1")
+            o.v1 = true;
+        else if (arg == "-v" || arg == "--verbose")
+            o.verbose = true;
+        else if (!has_val)
+            return false;
+        else if (arg == "--pps")
+            o.pps = std::stoull(argv[++i]);
+        else if (arg == "--duration")
+            o.duration_s = std::stod(argv[++i]);
+        else if (arg == "--width")
+            o.width = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--height")
+            o.height = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (arg == "--streams")
+            o.streams = std::max(1ul, std::min(255ul, std::stoul(argv[++i])));
+        else if (arg == "--queue")
+            o.queue = std::stoull(argv[++i]);
+        else if (arg == "--stride")
+            o.stride = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--band-rows")
+            o.band_rows = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--consumer-us")
+        {
+            // N[:policy[:depth]]
+            char policy[16] = {0,};
+            unsigned long us = 0, depth = o.consumer.queue_depth;
+            int n = std::sscanf(argv[++i], "%lu:%15[a-z-]:%lu", &us, policy, &depth);
+            if (n < 1 || depth == 0 || depth > 65536
+                || (n >= 2 && !parseStagePolicy(policy, o.consumer.policy)))
+                return false;
+            o.consumer_us          = static_cast<uint32_t>(us);
+            o.consumer.queue_depth = depth;
+        }
+        else if (arg == "--timeouts")
+        {
+            std::string v = argv[++i];
+            if (v != "fixed" && v != "adaptive")
+                return false;
+            o.adaptive_timeouts = (v == "adaptive");
+        }
+        else if (arg == "--shed")
+        {
+            char policy[16] = {0,};
+            unsigned long n = o.admission.every_n;
+            int got = std::sscanf(argv[++i], "%15[a-z-]:%lu", policy, &n);
+            if (got < 1 || n == 0 || n > (1u << 16) || !parseShedPolicy(policy, o.admission.policy))
+                return false;
+            o.admission.every_n = static_cast<uint32_t>(n);
+        }
+        else if (arg == "--record")
+            o.record_path = argv[++i];
+        else if (arg == "--compress")
+        {
+            char codec[8] = {0,};
+            unsigned long threads = o.record.threads, chunk_kb = o.record.chunk_size / 1024;
+            int got = std::sscanf(argv[++i], "%7[a-z0-9]:%lu:%lu", codec, &threads, &chunk_kb);
+            // "-1" scans as ULONG_MAX: the bounds catch it
+            unsigned long max_threads = std::max(1u, std::thread::hardware_concurrency());
+            if (got < 1 || threads > max_threads || chunk_kb < 4 || chunk_kb > 64 * 1024
+                || !parseFrameCodec(codec, o.record.codec))
+                return false;
+            o.record.threads    = static_cast<uint32_t>(threads);
+            o.record.chunk_size = chunk_kb * 1024;
+        }
+        else if (arg == "--report")
+            o.report_s = std::stod(argv[++i]);
+        else if (arg == "--min-complete")
+            o.min_complete = std::stod(argv[++i]);
+        else if (arg == "--copy")
+        {
+            if (!hv::copy::parseMode(argv[++i], o.copy.mode))
+                return false;
+        }
+        else if (arg == "--wait")
+        {
+            if (!hv::wait::parseMode(argv[++i], o.wait.mode))
+                return false;
+        }
+        else if (arg == "--ingress")
+        {
+            std::string v = argv[++i];
+            if (v == "socket")     o.ingress = RxIngress::SOCKET;
+            else if (v == "rtc")   o.ingress = RxIngress::SOCKET_RTC;
+            else if (v == "ring")  o.ingress = RxIngress::PACKET_RING;
+            else if (v == "uring") o.ingress = RxIngress::URING;
+            else return false;
+        }
+        else if (arg == "--demux")
+        {
+            std::string v = argv[++i];
+            if (v == "none")        o.demux = StreamKeyMode::SINGLE;
+            else if (v == "id")     o.demux = StreamKeyMode::STREAM_ID;
+            else if (v == "source") o.demux = StreamKeyMode::SOURCE;
+            else return false;
+        }
+        else if (arg == "--spin-us")
+            o.wait.spin_us = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--busy-poll-us")
+            o.wait.busy_poll_us = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--seed")
+            o.imp.seed = std::stoull(argv[++i]);
+        else if (arg == "--loss")
+            o.imp.loss = std::stod(argv[++i]);
+        else if (arg == "--dup")
+            o.imp.duplicate = std::stod(argv[++i]);
+        else if (arg == "--burst")
+        {
+            if (!parsePair(argv[++i], o.imp.burst_enter, &o.imp.burst_exit, &o.imp.burst_loss))
+                return false;
+        }
+        else if (arg == "--reorder")
+        {
+            double gap = o.imp.reorder_gap;
+            if (!parsePair(argv[++i], o.imp.reorder, &gap))
+                return false;
+            o.imp.reorder_gap = static_cast<uint32_t>(gap);
+        }
+        else if (arg == "--delay")
+        {
+            double d = 0, j = 0;
+            if (!parsePair(argv[++i], d, &j))
+                return false;
+            o.imp.delay_us  = static_cast<uint32_t>(d);
+            o.imp.jitter_us = static_cast<uint32_t>(j);
+        }
+        else
+            return false;
+    }
+    if (o.v1)
+        o.stride = protocol::MAX_UDP_PAYLOAD;
+    return o.width > 0 && o.height > 0
+        && o.stride > 0 && o.stride <= protocol::MAX_PAYLOAD_STRIDE;
+}
+
+/*---------------------------------------------------------------*/
+/* Generator: paced, streams interleaved packet by packet        */
+/*---------------------------------------------------------------*/
+void txThread(const SoakOptions& o, uint16_t port, SoakState& st)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        perror("socket(tx)");
+        st.tx_done.store(true);
+        return;
+    }
+
+    int sndbuf = 4 * 1024 * 1024;
+    if (setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) < 0)
+        perror("setsockopt(SO_SNDBUF)");
+
+    sockaddr_in dst{};
+    dst.sin_family = AF_INET;
+    dst.sin_port   = htons(port);
+    dst.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (connect(sock, (sockaddr*)&dst, sizeof(dst)) < 0)
+    {
+        perror("connect(tx)");
+        close(sock);
+        st.tx_done.store(true);
+        return;
+    }
+
+    std::vector<StreamSource> streams(o.streams);
+    for (uint32_t s = 0; s < o.streams; ++s)
+        streams[s].build(s, o.width, o.height, o.stride, o.v1);
+
+    Impairment imp(o.imp);
+    imp.emit = [&](const uint8_t* data, size_t len)
+    {
+        if (send(sock, data, len, 0) < 0)
+            st.tx_errors.fetch_add(1, std::memory_order_relaxed);
+        else
+            st.tx_packets.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    uint8_t buf[protocol::MAX_DATAGRAM];
+
+    const uint64_t start  = hv::stats::monotonicNs();
+    const uint64_t end    = start + static_cast<uint64_t>(o.duration_s * 1e9);
+    const double   gap_ns = o.pps ? 1e9 / static_cast<double>(o.pps) : 0.0;
+
+    uint64_t submitted = 0;
+    uint32_t cur = 0;
+
+    for (;;)
+    {
+        uint64_t now = hv::stats::monotonicNs();
+
+        // Past the end: finish the frames in progress (a frame cut short would
+        // count as partial), start no new one
+        if (now >= end)
+        {
+            uint32_t idle = 0;
+            while (idle < o.streams && streams[cur].next == 0)
+            {
+                cur = (cur + 1) % o.streams;
+                idle++;
+            }
+            if (idle == o.streams)
+                break;
+        }
+
+        if (o.pps)
+        {
+            uint64_t due = start + static_cast<uint64_t>(submitted * gap_ns);
+            if (now < due)
+            {
+                imp.poll(now);
+
+                // Sleep only when well ahead; short gaps are absorbed by the next burst
+                if (due - now > 200000)
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - 100000));
+                else
+                    std::this_thread::yield();
+                continue;
+            }
+        }
+
+        StreamSource& src = streams[cur];
+        const std::vector<uint8_t>& d = src.datagrams[src.next];
+
+        uint32_t frame_id = (cur << STREAM_SHIFT) | (src.seq & ((1u << STREAM_SHIFT) - 1));
+        std::memcpy(buf, d.data(), d.size());
+        if (o.v1)
+        {
+            std::memcpy(buf + offsetof(UdpPacketHeaderV1, frame_id), &frame_id, sizeof(frame_id));
+        }
+        else
+        {
+            uint64_t send_ns = hv::stats::realtimeNs();
+            std::memcpy(buf + offsetof(UdpPacketHeaderV2, frame_id), &frame_id, sizeof(frame_id));
+            std::memcpy(buf + offsetof(UdpPacketHeaderV2, send_ns), &send_ns, sizeof(send_ns));
+        }
+
+        // Before the send: the receiver emits as soon as the last packet lands
+        bool last = (src.next + 1 == src.datagrams.size());
+        if (last)
+            st.frame_sent_ns[st.slot(frame_id)].store(now, std::memory_order_relaxed);
+
+        imp.submit(buf, d.size(), now);
+        imp.poll(now);
+        submitted++;
+
+        if (++src.next == src.datagrams.size())
+        {
+            st.tx_frames.fetch_add(1, std::memory_order_relaxed);
+            src.next = 0;
+            src.seq++;
+        }
+
+        cur = (cur + 1) % o.streams;
+    }
+
+    imp.drain();
+
+    const ImpairmentStats& is = imp.stats();
+    std::printf("[SOAK] impairment submitted=%" PRIu64 " emitted=%" PRIu64
+                " lost=%" PRIu64 " burst_lost=%" PRIu64 " dup=%" PRIu64
+                " reordered=%" PRIu64 " delayed=%" PRIu64 "\n",
+                is.submitted, is.emitted, is.lost, is.lost_burst,
+                is.duplicated, is.reordered, is.delayed);
+
+    close(sock);
+    st.tx_done.store(true);
+}
+
+void printLatency(const char* name, const hv::stats::HistogramSnapshot& s)
+{
+    if (s.count == 0)
+        return;
+
+    std::printf("[SOAK]   %-16s n=%-9" PRIu64 " p50=%9.1fus p99=%9.1fus p999=%9.1fus max=%9.1fus\n",
+                name, s.count,
+                s.percentile(50.0)  / 1e3,
+                s.percentile(99.0)  / 1e3,
+                s.percentile(99.9)  / 1e3,
+                s.max / 1e3);
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+    SoakOptions o;
+    try
+    {
+        if (!parseArgs(argc, argv, o))
+        {
+            usage();
+            return -1;
+        }
+    }
+    catch (const std::exception&)
+    {
+        usage();
+        return -1;
+    }
+
+    hv::debug::init();
+    hv::debug::setBackend(hv::debug::Backend::Async);
+    hv::debug::setLevel(o.verbose ? hv::debug::Level::Info : hv::debug::Level::Error);
+    hv::debug::enable(hv::debug::Module::RX | hv::debug::Module::FRAME);
+
+    uint16_t port = 0;
+    int sock = open_rx_socket(0, "127.0.0.1", &port);
+    if (sock < 0)
+        return -1;
+
+    SoakState st(o.streams);
+
+    RxPipelineConfig cfg;
+    cfg.queue_capacity = o.queue;
+    cfg.wait           = o.wait;
+    cfg.ingress        = o.ingress;
+    cfg.demux          = o.demux;
+    cfg.band_rows      = o.band_rows;
+    cfg.timeouts.adaptive = o.adaptive_timeouts;
+    cfg.admission      = o.admission;
+    cfg.copy           = o.copy;
+    cfg.payload_stride = protocol::MAX_UDP_PAYLOAD;
+    cfg.max_frame_size = std::max<size_t>(cfg.max_frame_size,
+                                          static_cast<size_t>(o.width) * o.height * 2 + 4096);
+
+    // Slow consumer off the reassembly thread: its policy decides what it costs
+    FramePipeline consumers;
+    if (o.consumer_us)
+    {
+        StageConfig sc = o.consumer;
+        sc.name = "consumer";
+        sc.fn   = [us = o.consumer_us](const FrameResult&)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        };
+        consumers.addStage(sc);
+    }
+
+    FrameRecorder recorder(o.record);
+    if (!o.record_path.empty())
+    {
+        if (!recorder.open(o.record_path))
+            return -1;
+        StageConfig sc;
+        sc.name = "record";
+        sc.fn   = [&recorder](const FrameResult& r) { recorder.record(r); };
+        consumers.addStage(sc);
+    }
+
+    RxPipeline pipeline(cfg);
+    pipeline.onFrameDone = [&](const FrameResult& r)
+    {
+        uint64_t now = hv::stats::monotonicNs();
+
+        // FrameResult.state is not trusted here: classify by packet count
+        bool complete = (r.received_packets == r.expected_packets);
+        st.frames.fetch_add(1, std::memory_order_relaxed);
+        (complete ? st.complete : st.partial).fetch_add(1, std::memory_order_relaxed);
+
+        if (r.digest_state == FrameDigestState::VERIFIED)
+            st.verified.fetch_add(1, std::memory_order_relaxed);
+        else if (r.digest_state == FrameDigestState::MISMATCH)
+            st.mismatch.fetch_add(1, std::memory_order_relaxed);
+
+        if (complete)
+            st.good_bytes.fetch_add(r.frame_size, std::memory_order_relaxed);
+
+        uint64_t sent = st.frame_sent_ns[st.slot(r.frame_id)].load(std::memory_order_relaxed);
+        if (sent && now > sent)
+        {
+            uint64_t d = now - sent;
+            std::lock_guard<std::mutex> lk(st.e2e_mtx);
+            st.e2e.buckets[hv::stats::histBucket(d)]++;
+            st.e2e.count++;
+            st.e2e.sum += d;
+            st.e2e.max = std::max(st.e2e.max, d);
+        }
+
+        if (o.write)
+            write_frame_to_file(r.frame_data, r.frame_size, !complete);
+
+        consumers.submit(r);
+    };
+
+    if (o.band_rows)
+    {
+        pipeline.onFrameBand = [&](const FrameBand& b)
+        {
+            st.band_rows.fetch_add(b.row_end - b.row_begin, std::memory_order_relaxed);
+        };
+    }
+
+    consumers.start();
+
+    if (!pipeline.start(sock))
+    {
+        consumers.stop();
+        close(sock);
+        return -1;
+    }
+
+    std::printf("[SOAK] port=%u pps=%" PRIu64 " duration=%.1fs frame=%ux%u streams=%u"
+                " loss=%.4f burst=%.4f/%.2f dup=%.4f reorder=%.4f/%u delay=%uus+%uus\n",
+                port, o.pps, o.duration_s, o.width, o.height, o.streams,
+                o.imp.loss, o.imp.burst_enter, o.imp.burst_exit, o.imp.duplicate,
+                o.imp.reorder, o.imp.reorder_gap, o.imp.delay_us, o.imp.jitter_us);
+
+    std::thread tx(txThread, std::cref(o), port, std::ref(st));
+
+    // Periodic report (reporter = main thread)
+    const uint64_t t0 = hv::stats::monotonicNs();
+    uint64_t last_ns  = t0;
+    uint64_t last_tx  = 0, last_rx = 0, last_good = 0;
+
+    auto report = [&](bool final_line)
+    {
+        uint64_t now = hv::stats::monotonicNs();
+        double   dt  = (now - last_ns) / 1e9;
+        hv::stats::Snapshot s = hv::stats::snapshot();
+
+        uint64_t tx   = st.tx_packets.load();
+        uint64_t rx   = s.counters[hv::stats::RX_PACKETS];
+        uint64_t good = st.good_bytes.load();
+        uint64_t fr   = st.frames.load();
+
+        if (!final_line && dt > 0)
+        {
+            std::printf("[SOAK] t=%6.1fs tx=%9.0f pps rx=%9.0f pps goodput=%8.1f MB/s"
+                        " frames=%-7" PRIu64 " complete=%6.2f%% qdepth=%-5" PRId64 " qdrop=%zu\n",
+                        (now - t0) / 1e9,
+                        (tx - last_tx) / dt,
+                        (rx - last_rx) / dt,
+                        (good - last_good) / dt / 1e6,
+                        fr,
+                        fr ? 100.0 * st.complete.load() / fr : 0.0,
+                        s.gauges[hv::stats::QUEUE_DEPTH],
+                        pipeline.queue().dropped());
+            std::fflush(stdout);
+        }
+
+        last_ns = now; last_tx = tx; last_rx = rx; last_good = good;
+    };
+
+    while (!st.tx_done.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (hv::stats::monotonicNs() - last_ns >= static_cast<uint64_t>(o.report_s * 1e9))
+            report(false);
+    }
+    tx.join();
+
+    // Let the worker finish in-flight frames (idle timeout) before stopping
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    pipeline.stop();
+    consumers.stop();
+    recorder.close();
+    close(sock);
+
+    /*----------------------- summary -----------------------*/
+    hv::stats::Snapshot s = hv::stats::snapshot();
+    double elapsed = (hv::stats::monotonicNs() - t0) / 1e9;
+
+    uint64_t tx_pkts   = st.tx_packets.load();
+    uint64_t rx_pkts   = s.counters[hv::stats::RX_PACKETS];
+    uint64_t frames    = st.frames.load();
+    uint64_t complete  = st.complete.load();
+    uint64_t started   = s.counters[hv::stats::FRAMES_STARTED];
+    double   complete_pct = frames ? 100.0 * complete / frames : 0.0;
+
+    std::printf("[SOAK] ---------------- summary (%.1fs) ----------------\n", elapsed);
+    std::printf("[SOAK] tx frames=%" PRIu64 " packets=%" PRIu64 " send_errors=%" PRIu64 "\n",
+                st.tx_frames.load(), tx_pkts, st.tx_errors.load());
+    std::printf("[SOAK] rx packets=%" PRIu64 " socket_lost=%" PRId64 " kernel_dropped=%" PRIu64
+                " ring_dropped=%" PRIu64 " queue_dropped=%zu\n",
+                rx_pkts, static_cast<int64_t>(tx_pkts - rx_pkts), s.counters[hv::stats::KERNEL_DROPS],
+                s.counters[hv::stats::RING_DROPS], pipeline.queue().dropped());
+    std::printf("[SOAK] frames delivered=%" PRIu64 " complete=%" PRIu64 " (%.2f%%) partial=%" PRIu64
+                " unfinished=%" PRIu64 "\n",
+                frames, complete, complete_pct, st.partial.load(),
+                started > frames ? started - frames : 0);
+    std::printf("[SOAK] shed=%s frames=%" PRIu64 " packets=%" PRIu64 "\n",
+                shedPolicyName(o.admission.policy),
+                s.counters[hv::stats::SHED_FRAMES], s.counters[hv::stats::SHED_PACKETS]);
+    std::printf("[SOAK] digest verified=%" PRIu64 " mismatch=%" PRIu64 "\n",
+                st.verified.load(), st.mismatch.load());
+    std::printf("[SOAK] goodput=%.1f MB/s (complete frames)\n",
+                st.good_bytes.load() / elapsed / 1e6);
+    if (o.band_rows)
+        std::printf("[SOAK] bands=%" PRIu64 " rows=%" PRIu64 " (%.1f rows/frame)\n",
+                    s.counters[hv::stats::FRAME_BANDS], st.band_rows.load(),
+                    frames ? static_cast<double>(st.band_rows.load()) / frames : 0.0);
+
+    if (o.demux != StreamKeyMode::SINGLE)
+    {
+        for (const StreamStatsSnapshot& ss : pipeline.streamStats())
+            std::printf("[SOAK]   stream %-3u %-21s packets=%-9" PRIu64 " complete=%-6" PRIu64
+                        " partial=%" PRIu64 " idle=%.2fms lifetime=%.1fms\n",
+                        ss.id, ss.name.c_str(), ss.packets, ss.frames_complete, ss.frames_partial,
+                        ss.idle_timeout_us / 1e3, ss.lifetime_us / 1e3);
+    }
+    else
+    {
+        for (const StreamStatsSnapshot& ss : pipeline.streamStats())
+            std::printf("[SOAK] timeouts=%s idle=%.2fms lifetime=%.1fms\n",
+                        o.adaptive_timeouts ? "adaptive" : "fixed",
+                        ss.idle_timeout_us / 1e3, ss.lifetime_us / 1e3);
+    }
+
+    for (const StageStats& ss : consumers.stats())
+        std::printf("[SOAK] stage %s policy=%s processed=%" PRIu64 " dropped=%" PRIu64
+                    " blocked=%.1fms dwell p99=%.1fus\n",
+                    ss.name.c_str(), stagePolicyName(ss.policy), ss.processed, ss.dropped,
+                    ss.blocked_ns / 1e6, ss.dwell.percentile(99.0) / 1e3);
+
+    if (recorder.stats().frames && o.record.codec != FrameCodec::NONE)
+    {
+        RecorderStats rs = recorder.stats();
+        std::printf("[SOAK] record codec=%s threads=%u+1 frames=%" PRIu64 " ratio=%.2f"
+                    " compress=%.1f MB/s stored_chunks=%" PRIu64 "\n",
+                    frameCodecName(o.record.codec), o.record.threads, rs.frames,
+                    rs.written_bytes ? static_cast<double>(rs.raw_bytes) / rs.written_bytes : 0.0,
+                    rs.compress_ns ? rs.raw_bytes * 1e3 / rs.compress_ns : 0.0,
+                    rs.stored_chunks);
+    }
+
+    std::printf("[SOAK] wait=%s cpu rx=%.1f%% worker=%.1f%%\n",
+                hv::wait::modeName(o.wait.mode),
+                100.0 * pipeline.rxCpuNs() / (elapsed * 1e9),
+                100.0 * pipeline.workerCpuNs() / (elapsed * 1e9));
+
+    std::printf("[SOAK] latency:\n");
+    for (uint32_t h = 0; h < hv::stats::HIST_MAX; ++h)
+    {
+        auto id = static_cast<hv::stats::Histogram>(h);
+        printLatency(hv::stats::histogramName(id), hv::stats::histogramSnapshot(id));
+    }
+    {
+        std::lock_guard<std::mutex> lk(st.e2e_mtx);
+        printLatency("end_to_end", st.e2e);
+    }
+
+    hv::debug::shutdown();
+
+    int rc = 0;
+    if (st.mismatch.load() > 0)
+    {
+        std::printf("[SOAK] FAIL: digest mismatch\n");
+        rc = 1;
+    }
+    if (o.min_complete > 0.0 && complete_pct < o.min_complete)
+    {
+        std::printf("[SOAK] FAIL: complete %.2f%% < %.2f%%\n", complete_pct, o.min_complete);
+        rc = 1;
+    }
+    return rc;
+}